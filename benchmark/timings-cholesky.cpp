@@ -11,6 +11,7 @@
 #include "pinocchio/algorithm/crba.hpp"
 #include "pinocchio/algorithm/aba.hpp"
 #include "pinocchio/algorithm/cholesky.hpp"
+#include "pinocchio/algorithm/tree-sparse-matrix.hpp"
 #include "pinocchio/parsers/urdf.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
 
@@ -85,6 +86,32 @@ int main(int argc, const char ** argv)
   std::cout << "Dense Eigen Cholesky = \t" << (total/NBT)
   << " " << timer.unitName(timer.DEFAULT_UNIT) <<std::endl;
   
+  // Payload change on a wrist: incremental update against full recomputation.
+  const std::string wrist_name = model.existJointName("rarm6_joint") ? "rarm6_joint" : "RARM_WRIST_R";
+  if(model.existJointName(wrist_name))
+  {
+    const JointIndex wrist_id = model.getJointId(wrist_name);
+    const Inertia inertias[2] = { model.inertias[wrist_id], model.inertias[wrist_id] + Inertia::Random() };
+    
+    crba(model,data,qs[0]);
+    cholesky::decompose(model,data);
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      // Alternatively add and remove the payload
+      cholesky::updateBodyInertia(model,data,wrist_id,inertias[_smooth%2],inertias[(_smooth+1)%2]);
+    }
+    std::cout << "Cholesky update for a payload change = \t"; timer.toc(std::cout,NBT);
+    
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      crba(model,data,qs[0]);
+      cholesky::decompose(model,data);
+    }
+    std::cout << "CRBA + Cholesky = \t"; timer.toc(std::cout,NBT);
+  }
+  
   timer.tic();
   SMOOTH(NBT)
   {
@@ -114,6 +141,99 @@ int main(int argc, const char ** argv)
   }
   std::cout << "Cholesky solve column = \t\t"; timer.toc(std::cout,NBT);
   
+  // Multiple right-hand sides: the block kernels against the per-column path and dense Eigen LDLT.
+  const Eigen::DenseIndex nc = 12; // e.g. the transpose of the Jacobian of two 6D contacts
+  MatrixXd Jt(MatrixXd::Random(model.nv,nc)), X(model.nv,nc);
+  crba(model,data,qs[0]);
+  cholesky::decompose(model,data);
+  data.M.triangularView<Eigen::StrictlyLower>()
+  = data.M.transpose().triangularView<Eigen::StrictlyLower>();
+  Mldlt.compute(data.M);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    for(Eigen::DenseIndex k = 0; k < nc; ++k)
+      cholesky::solve(model,data,X.col(k));
+  }
+  std::cout << "Cholesky solve " << nc << " columns (per column) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    cholesky::solve(model,data,X);
+  }
+  std::cout << "Cholesky solve " << nc << " columns (block) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    Mldlt.solveInPlace(X);
+  }
+  std::cout << "Dense Eigen LDLT solve " << nc << " columns = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    for(Eigen::DenseIndex k = 0; k < nc; ++k)
+      cholesky::Uiv(model,data,X.col(k));
+  }
+  std::cout << "Uiv " << nc << " columns (per column) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    cholesky::Uiv(model,data,X);
+  }
+  std::cout << "Uiv " << nc << " columns (block) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    for(Eigen::DenseIndex k = 0; k < nc; ++k)
+      cholesky::UDUtv(model,data,X.col(k));
+  }
+  std::cout << "UDUtv " << nc << " columns (per column) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    X = Jt;
+    cholesky::UDUtv(model,data,X);
+  }
+  std::cout << "UDUtv " << nc << " columns (block) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    A = B;
+    for(Eigen::DenseIndex k = 0; k < model.nv; ++k)
+      cholesky::solve(model,data,A.col(k));
+  }
+  std::cout << "Cholesky solve nv columns (per column) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    A = B;
+    cholesky::solve(model,data,A);
+  }
+  std::cout << "Cholesky solve nv columns (block) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    A = B;
+    Mldlt.solveInPlace(A);
+  }
+  std::cout << "Dense Eigen LDLT solve nv columns = \t\t"; timer.toc(std::cout,NBT);
+  
   timer.tic();
   SMOOTH(NBT)
   {
@@ -144,5 +264,50 @@ int main(int argc, const char ** argv)
   }
   std::cout << "computeMinverse = \t\t"; timer.toc(std::cout,NBT);
   
+  // Tree sparse storage of M
+  crba(model,data,qs[0]);
+  data.M.triangularView<Eigen::StrictlyLower>()
+  = data.M.transpose().triangularView<Eigen::StrictlyLower>();
+  TreeSparseMatrix M_sparse(model);
+  std::cout << "Tree sparse M: " << M_sparse.nonZeros() << " stored entries against "
+  << model.nv*(model.nv+1)/2 << " for the upper triangular part" << std::endl;
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    M_sparse.fromDense(data.M);
+  }
+  std::cout << "Tree sparse M from dense = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    A.noalias() = data.M*B;
+  }
+  std::cout << "A = M*B (dense) = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    treeSparseProduct(M_sparse,B,A);
+  }
+  std::cout << "A = M*B (tree sparse) = \t\t"; timer.toc(std::cout,NBT);
+  
+  TreeSparseLDLT M_sparse_ldlt;
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    M_sparse_ldlt.compute(M_sparse);
+  }
+  std::cout << "Tree sparse LDLT = \t\t"; timer.toc(std::cout,NBT);
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    A = B;
+    M_sparse_ldlt.solveInPlace(A);
+  }
+  std::cout << "Tree sparse LDLT solve nv columns = \t\t"; timer.toc(std::cout,NBT);
+  
   return 0;
 }
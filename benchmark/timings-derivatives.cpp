@@ -2,15 +2,24 @@
 // Copyright (c) 2018-2020 CNRS INRIA
 //
 
+#ifdef PINOCCHIO_WITH_CPPAD
+  #include "pinocchio/autodiff/cppad.hpp"
+  #include "pinocchio/autodiff/cppad/tape.hpp"
+#endif
+
 #include "pinocchio/algorithm/joint-configuration.hpp"
 #include "pinocchio/algorithm/kinematics.hpp"
 #include "pinocchio/algorithm/kinematics-derivatives.hpp"
 #include "pinocchio/algorithm/rnea-derivatives.hpp"
+#include "pinocchio/algorithm/rnea-second-order-derivatives.hpp"
 #include "pinocchio/algorithm/aba-derivatives.hpp"
 #include "pinocchio/algorithm/aba.hpp"
 #include "pinocchio/algorithm/rnea.hpp"
 #include "pinocchio/algorithm/crba.hpp"
 #include "pinocchio/algorithm/cholesky.hpp"
+#include "pinocchio/algorithm/jacobian.hpp"
+#include "pinocchio/algorithm/contact-dynamics.hpp"
+#include "pinocchio/algorithm/contact-dynamics-derivatives.hpp"
 #include "pinocchio/parsers/urdf.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
 #include "pinocchio/container/aligned-vector.hpp"
@@ -69,6 +78,75 @@ void rnea_fd(const pinocchio::Model & model, pinocchio::Data & data_fd,
   
 }
 
+void rnea_second_order_fd(const pinocchio::Model & model, pinocchio::Data & data_fd,
+                          const Eigen::VectorXd & q,
+                          const Eigen::VectorXd & v,
+                          const Eigen::VectorXd & a,
+                          pinocchio::Data::Tensor3x & d2tau_dqdq,
+                          pinocchio::Data::Tensor3x & d2tau_dvdv,
+                          pinocchio::Data::Tensor3x & d2tau_dqdv,
+                          pinocchio::Data::Tensor3x & d2tau_dadq)
+{
+  using namespace Eigen;
+  typedef Map<MatrixXd> MapMatrixXd;
+  const Eigen::DenseIndex nv = model.nv;
+  VectorXd v_eps(VectorXd::Zero(model.nv));
+  VectorXd q_plus(model.nq);
+  VectorXd v_plus(v);
+  const double alpha = 1e-8;
+  
+  MatrixXd dtau_dq0(MatrixXd::Zero(nv,nv)), dtau_dv0(MatrixXd::Zero(nv,nv)), dtau_da0(MatrixXd::Zero(nv,nv));
+  MatrixXd dtau_dq(MatrixXd::Zero(nv,nv)), dtau_dv(MatrixXd::Zero(nv,nv)), dtau_da(MatrixXd::Zero(nv,nv));
+  computeRNEADerivatives(model,data_fd,q,v,a,dtau_dq0,dtau_dv0,dtau_da0);
+  
+  for(Eigen::DenseIndex k = 0; k < nv; ++k)
+  {
+    // d/dq
+    v_eps[k] += alpha;
+    q_plus = integrate(model,q,v_eps);
+    computeRNEADerivatives(model,data_fd,q_plus,v,a,dtau_dq,dtau_dv,dtau_da);
+    MapMatrixXd(d2tau_dqdq.data() + k*nv*nv,nv,nv) = (dtau_dq - dtau_dq0)/alpha;
+    MapMatrixXd(d2tau_dadq.data() + k*nv*nv,nv,nv) = (dtau_da - dtau_da0)/alpha;
+    v_eps[k] -= alpha;
+    
+    // d/dv
+    v_plus[k] += alpha;
+    computeRNEADerivatives(model,data_fd,q,v_plus,a,dtau_dq,dtau_dv,dtau_da);
+    MapMatrixXd(d2tau_dqdv.data() + k*nv*nv,nv,nv) = (dtau_dq - dtau_dq0)/alpha;
+    MapMatrixXd(d2tau_dvdv.data() + k*nv*nv,nv,nv) = (dtau_dv - dtau_dv0)/alpha;
+    v_plus[k] -= alpha;
+  }
+}
+
+#ifdef PINOCCHIO_WITH_CPPAD
+///
+/// \brief Records computeRNEADerivatives on a CppADTapeTpl: the input is (q,dq,v,a) and the output stacks dtau_dq, dtau_dv and dtau_da
+///        evaluated at integrate(q,dq). The Jacobian of the tape with respect to dq and v contains the second order derivatives.
+///
+struct RNEADerivativesTapeFunctor
+{
+  template<typename ADModel, typename ADData, typename ADVector>
+  void operator()(const ADModel & model, ADData & data,
+                  const ADVector & x, ADVector & y) const
+  {
+    typedef typename ADData::MatrixXs ADMatrixXs;
+    const Eigen::DenseIndex nv = model.nv;
+    
+    const typename ADModel::ConfigVectorType q_plus
+    = pinocchio::integrate(model,x.head(model.nq),x.segment(model.nq,nv));
+    
+    ADMatrixXs dtau_dq(ADMatrixXs::Zero(nv,nv)), dtau_dv(ADMatrixXs::Zero(nv,nv)), dtau_da(ADMatrixXs::Zero(nv,nv));
+    pinocchio::computeRNEADerivatives(model,data,q_plus,x.segment(model.nq+nv,nv),x.tail(nv),
+                                      dtau_dq,dtau_dv,dtau_da);
+    
+    y.resize(3*nv*nv);
+    Eigen::Map<ADMatrixXs>(y.data(),nv,nv) = dtau_dq;
+    Eigen::Map<ADMatrixXs>(y.data()+nv*nv,nv,nv) = dtau_dv;
+    Eigen::Map<ADMatrixXs>(y.data()+2*nv*nv,nv,nv) = dtau_da;
+  }
+};
+#endif
+
 void aba_fd(const pinocchio::Model & model, pinocchio::Data & data_fd,
             const Eigen::VectorXd & q,
             const Eigen::VectorXd & v,
@@ -111,6 +189,77 @@ void aba_fd(const pinocchio::Model & model, pinocchio::Data & data_fd,
   daba_dtau = computeMinverse(model,data_fd,q);
 }
 
+///
+/// \brief Stack the LOCAL Jacobians of the joints contact_ids and the drifts cancelling the contact accelerations.
+///
+void contact_jacobian(const pinocchio::Model & model, pinocchio::Data & data,
+                      const Eigen::VectorXd & q,
+                      const Eigen::VectorXd & v,
+                      const pinocchio::Model::IndexVector & contact_ids,
+                      Eigen::MatrixXd & J, Eigen::VectorXd & gamma)
+{
+  using namespace pinocchio;
+  J.setZero();
+  forwardKinematics(model,data,q,v,Eigen::VectorXd::Zero(model.nv));
+  computeJointJacobians(model,data);
+  for(size_t k = 0; k < contact_ids.size(); ++k)
+  {
+    getJointJacobian(model,data,contact_ids[k],LOCAL,J.middleRows<6>(6*(Eigen::DenseIndex)k));
+    gamma.segment<6>(6*(Eigen::DenseIndex)k) = data.a[contact_ids[k]].toVector();
+  }
+}
+
+const Eigen::VectorXd & contact_dynamics(const pinocchio::Model & model, pinocchio::Data & data,
+                                         const Eigen::VectorXd & q,
+                                         const Eigen::VectorXd & v,
+                                         const Eigen::VectorXd & tau,
+                                         const pinocchio::Model::IndexVector & contact_ids,
+                                         Eigen::MatrixXd & J, Eigen::VectorXd & gamma)
+{
+  contact_jacobian(model,data,q,v,contact_ids,J,gamma);
+  return pinocchio::forwardDynamics(model,data,q,v,tau,J,gamma);
+}
+
+void contact_dynamics_fd(const pinocchio::Model & model, pinocchio::Data & data_fd,
+                         const Eigen::VectorXd & q,
+                         const Eigen::VectorXd & v,
+                         const Eigen::VectorXd & tau,
+                         const pinocchio::Model::IndexVector & contact_ids,
+                         Eigen::MatrixXd & ddq_partial_dq,
+                         Eigen::MatrixXd & ddq_partial_dv,
+                         Eigen::MatrixXd & ddq_partial_dtau,
+                         Eigen::MatrixXd & lambda_partial_dq,
+                         Eigen::MatrixXd & lambda_partial_dv,
+                         Eigen::MatrixXd & lambda_partial_dtau)
+{
+  using namespace Eigen;
+  const Eigen::DenseIndex nc = 6*(Eigen::DenseIndex)contact_ids.size();
+  MatrixXd J(nc,model.nv);
+  VectorXd gamma(nc);
+  VectorXd v_eps(VectorXd::Zero(model.nv));
+  const double alpha = 1e-8;
+  
+  const VectorXd ddq0 = contact_dynamics(model,data_fd,q,v,tau,contact_ids,J,gamma);
+  const VectorXd lambda0 = data_fd.lambda_c;
+  
+  for(int k = 0; k < model.nv; ++k)
+  {
+    v_eps[k] += alpha;
+    contact_dynamics(model,data_fd,integrate(model,q,v_eps),v,tau,contact_ids,J,gamma);
+    ddq_partial_dq.col(k) = (data_fd.ddq - ddq0)/alpha;
+    lambda_partial_dq.col(k) = (data_fd.lambda_c - lambda0)/alpha;
+    
+    contact_dynamics(model,data_fd,q,v+v_eps,tau,contact_ids,J,gamma);
+    ddq_partial_dv.col(k) = (data_fd.ddq - ddq0)/alpha;
+    lambda_partial_dv.col(k) = (data_fd.lambda_c - lambda0)/alpha;
+    
+    contact_dynamics(model,data_fd,q,v,tau+v_eps,contact_ids,J,gamma);
+    ddq_partial_dtau.col(k) = (data_fd.ddq - ddq0)/alpha;
+    lambda_partial_dtau.col(k) = (data_fd.lambda_c - lambda0)/alpha;
+    v_eps[k] -= alpha;
+  }
+}
+
 int main(int argc, const char ** argv)
 {
   using namespace Eigen;
@@ -209,6 +358,43 @@ int main(int argc, const char ** argv)
   }
   std::cout << "RNEA finite differences= \t\t"; timer.toc(std::cout,NBT/100);
 
+  Data::Tensor3x d2tau_dqdq(model.nv,model.nv,model.nv), d2tau_dvdv(model.nv,model.nv,model.nv);
+  Data::Tensor3x d2tau_dqdv(model.nv,model.nv,model.nv), d2tau_dadq(model.nv,model.nv,model.nv);
+  
+  timer.tic();
+  SMOOTH(NBT/10)
+  {
+    computeRNEASecondOrderDerivatives(model,data,qs[_smooth],qdots[_smooth],qddots[_smooth],
+                                      d2tau_dqdq,d2tau_dvdv,d2tau_dqdv,d2tau_dadq);
+  }
+  std::cout << "RNEA second order derivatives= \t\t"; timer.toc(std::cout,NBT/10);
+  
+  timer.tic();
+  SMOOTH(NBT/100)
+  {
+    rnea_second_order_fd(model,data,qs[_smooth],qdots[_smooth],qddots[_smooth],
+                         d2tau_dqdq,d2tau_dvdv,d2tau_dqdv,d2tau_dadq);
+  }
+  std::cout << "RNEA second order finite differences= \t\t"; timer.toc(std::cout,NBT/100);
+  
+#ifdef PINOCCHIO_WITH_CPPAD
+  {
+    CppADTapeTpl<double> tape(model);
+    VectorXd x(model.nq+3*model.nv);
+    x << qs[0], VectorXd::Zero(model.nv), qdots[0], qddots[0];
+    tape.record(RNEADerivativesTapeFunctor(),x);
+    std::cout << "RNEA second order CppAD taping= \t\t" << tape.getTapingTime()*1e6 << " us" << std::endl;
+    
+    timer.tic();
+    SMOOTH(NBT/100)
+    {
+      x << qs[_smooth], VectorXd::Zero(model.nv), qdots[_smooth], qddots[_smooth];
+      tape.evalJacobian(x);
+    }
+    std::cout << "RNEA second order CppAD= \t\t"; timer.toc(std::cout,NBT/100);
+  }
+#endif
+  
   timer.tic();
   SMOOTH(NBT)
   {
@@ -249,6 +435,69 @@ int main(int argc, const char ** argv)
   }
   std::cout << "Minv from Cholesky = \t\t"; timer.toc(std::cout,NBT);
 
+  Model::IndexVector contact_ids;
+  const char * contact_names[4] = { "rleg6_joint", "lleg6_joint", "RLEG_ANKLE_R", "LLEG_ANKLE_R" };
+  for(int k = 0; k < 4; ++k)
+    if(model.existJointName(contact_names[k]))
+      contact_ids.push_back(model.getJointId(contact_names[k]));
+
+  if(!contact_ids.empty())
+  {
+    const Eigen::DenseIndex nc = 6*(Eigen::DenseIndex)contact_ids.size();
+    MatrixXd J(nc,model.nv);
+    VectorXd gamma(nc);
+    MatrixXd ddq_partial_dq(model.nv,model.nv), ddq_partial_dv(model.nv,model.nv), ddq_partial_dtau(model.nv,model.nv);
+    MatrixXd lambda_partial_dq(nc,model.nv), lambda_partial_dv(nc,model.nv), lambda_partial_dtau(nc,model.nv);
+
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      contact_dynamics(model,data,qs[_smooth],qdots[_smooth],taus[_smooth],contact_ids,J,gamma);
+    }
+    std::cout << "contact dynamics (" << contact_ids.size() << " contacts) = \t\t"; timer.toc(std::cout,NBT);
+
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      contact_dynamics(model,data,qs[_smooth],qdots[_smooth],taus[_smooth],contact_ids,J,gamma);
+      computeContactDynamicsDerivatives(model,data,qs[_smooth],qdots[_smooth],contact_ids,
+                                        ddq_partial_dq,ddq_partial_dv,ddq_partial_dtau,
+                                        lambda_partial_dq,lambda_partial_dv,lambda_partial_dtau);
+    }
+    std::cout << "contact dynamics + derivatives = \t\t"; timer.toc(std::cout,NBT);
+
+    timer.tic();
+    SMOOTH(NBT/100)
+    {
+      contact_dynamics_fd(model,data,qs[_smooth],qdots[_smooth],taus[_smooth],contact_ids,
+                          ddq_partial_dq,ddq_partial_dv,ddq_partial_dtau,
+                          lambda_partial_dq,lambda_partial_dv,lambda_partial_dtau);
+    }
+    std::cout << "contact dynamics finite differences = \t\t"; timer.toc(std::cout,NBT/100);
+
+    MatrixXd dq_after_partial_dq(model.nv,model.nv), dq_after_partial_dv(model.nv,model.nv);
+    const double r_coeff = 0.;
+
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      contact_jacobian(model,data,qs[_smooth],qdots[_smooth],contact_ids,J,gamma);
+      impulseDynamics(model,data,qs[_smooth],qdots[_smooth],J,r_coeff);
+    }
+    std::cout << "impulse dynamics = \t\t"; timer.toc(std::cout,NBT);
+
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      contact_jacobian(model,data,qs[_smooth],qdots[_smooth],contact_ids,J,gamma);
+      impulseDynamics(model,data,qs[_smooth],qdots[_smooth],J,r_coeff);
+      computeImpulseDynamicsDerivatives(model,data,qs[_smooth],qdots[_smooth],contact_ids,r_coeff,
+                                        dq_after_partial_dq,dq_after_partial_dv,
+                                        lambda_partial_dq,lambda_partial_dv);
+    }
+    std::cout << "impulse dynamics + derivatives = \t\t"; timer.toc(std::cout,NBT);
+  }
+
   std::cout << "--" << std::endl;
   return 0;
 }
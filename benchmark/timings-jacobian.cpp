@@ -7,6 +7,9 @@
 #include "pinocchio/algorithm/joint-configuration.hpp"
 #include "pinocchio/algorithm/kinematics.hpp"
 #include "pinocchio/algorithm/jacobian.hpp"
+#include "pinocchio/algorithm/crba.hpp"
+#include "pinocchio/algorithm/cholesky.hpp"
+#include "pinocchio/algorithm/branch-sparse-jacobian.hpp"
 #include "pinocchio/parsers/urdf.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
 
@@ -108,6 +111,72 @@ int main(int argc, const char ** argv)
   }
   std::cout << "getJointJacobian(WORLD) = \t"; timer.toc(std::cout,NBT);
 
+  // Stack the Jacobians of the last joint and of its parent.
+  const Model::JointIndex PARENT_ID = model.parents[JOINT_ID];
+  Data::Matrix6x J_parent(6,model.nv); J_parent.setZero();
+  MatrixXd J_stack(12,model.nv);
+  computeJointJacobians(model,data,qs[0]);
+  getJointJacobian(model,data,JOINT_ID,LOCAL,J);
+  getJointJacobian(model,data,PARENT_ID,LOCAL,J_parent);
+  J_stack << J, J_parent;
+
+  BranchSparseJacobian J_sparse(model.nv);
+  J_sparse.addBlock(model,JOINT_ID,J);
+  J_sparse.addBlock(model,PARENT_ID,J_parent);
+
+  VectorXd x(VectorXd::Random(model.nv)), Jx(12);
+  VectorXd f(VectorXd::Random(12)), Jtf(model.nv);
+  MatrixXd JMinvJt(12,12), UiJt(model.nv,12);
+
+  crba(model,data,qs[0]);
+  cholesky::decompose(model,data);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    Jx.noalias() = J_stack * x;
+  }
+  std::cout << "dense J*x = \t\t\t"; timer.toc(std::cout,NBT);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    jacobianProduct(J_sparse,x,Jx);
+  }
+  std::cout << "sparse J*x = \t\t\t"; timer.toc(std::cout,NBT);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    Jtf.noalias() = J_stack.transpose() * f;
+  }
+  std::cout << "dense J^T*f = \t\t\t"; timer.toc(std::cout,NBT);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    jacobianTransposeProduct(J_sparse,f,Jtf);
+  }
+  std::cout << "sparse J^T*f = \t\t\t"; timer.toc(std::cout,NBT);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    UiJt = J_stack.transpose();
+    cholesky::Uiv(model,data,UiJt);
+    for(Eigen::DenseIndex k=0;k<model.nv;++k)
+      UiJt.row(k) /= sqrt(data.D[k]);
+    JMinvJt.noalias() = UiJt.transpose() * UiJt;
+  }
+  std::cout << "dense J*Minv*J^T = \t\t"; timer.toc(std::cout,NBT);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    computeJMinvJt(model,data,J_sparse,JMinvJt);
+  }
+  std::cout << "sparse J*Minv*J^T = \t\t"; timer.toc(std::cout,NBT);
+
   std::cout << "--" << std::endl;
   return 0;
 }
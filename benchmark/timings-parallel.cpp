@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/algorithm/parallel/rnea.hpp"
+#include "pinocchio/algorithm/parallel/aba.hpp"
+#include "pinocchio/parsers/urdf.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include "pinocchio/utils/timer.hpp"
+
+int main(int argc, const char ** argv)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+
+  PinocchioTicToc timer(PinocchioTicToc::US);
+  #ifdef NDEBUG
+  const int NBT = 4000;
+  #else
+    const int NBT = 1;
+    std::cout << "(the time score in debug mode is not relevant) " << std::endl;
+  #endif
+    
+  Model model;
+
+  std::string filename = PINOCCHIO_MODEL_DIR + std::string("/simple_humanoid.urdf");
+  if(argc>1) filename = argv[1];
+  if( filename == "HS") 
+    pinocchio::buildModels::humanoidRandom(model,true);
+  else
+    pinocchio::urdf::buildModel(filename,JointModelFreeFlyer(),model);
+  std::cout << "nq = " << model.nq << std::endl;
+
+  const Eigen::DenseIndex batch_size = 256;
+  const size_t num_threads_max = (size_t)omp_get_max_threads();
+  std::cout << "batch size = " << batch_size << std::endl;
+  
+  VectorXd qmax = Eigen::VectorXd::Ones(model.nq);
+  MatrixXd qs(model.nq,batch_size);
+  MatrixXd vs(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd as(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd taus(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd res(MatrixXd::Zero(model.nv,batch_size));
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+    qs.col(i) = randomConfiguration(model,-qmax,qmax);
+  
+  ModelPool pool(model,num_threads_max);
+  
+  Data data(model);
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+      res.col(i) = rnea(model,data,qs.col(i),vs.col(i),as.col(i));
+  }
+  std::cout << "mean RNEA = \t\t\t\t"; timer.toc(std::cout,NBT*batch_size);
+  
+  for(size_t num_threads = 1; num_threads <= num_threads_max; ++num_threads)
+  {
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      rneaInParallel(num_threads,pool,qs,vs,as,res);
+    }
+    std::cout << "mean RNEA pool (" << num_threads << " threads) = \t\t"; timer.toc(std::cout,NBT*batch_size);
+  }
+  
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+      res.col(i) = aba(model,data,qs.col(i),vs.col(i),taus.col(i));
+  }
+  std::cout << "mean ABA = \t\t\t\t"; timer.toc(std::cout,NBT*batch_size);
+  
+  for(size_t num_threads = 1; num_threads <= num_threads_max; ++num_threads)
+  {
+    timer.tic();
+    SMOOTH(NBT)
+    {
+      abaInParallel(num_threads,pool,qs,vs,taus,res);
+    }
+    std::cout << "mean ABA pool (" << num_threads << " threads) = \t\t"; timer.toc(std::cout,NBT*batch_size);
+  }
+
+  std::cout << "--" << std::endl;
+  return 0;
+}
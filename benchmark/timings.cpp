@@ -16,6 +16,7 @@
 #include "pinocchio/algorithm/center-of-mass.hpp"
 #include "pinocchio/algorithm/compute-all-terms.hpp"
 #include "pinocchio/algorithm/kinematics.hpp"
+#include "pinocchio/algorithm/contact-dynamics.hpp"
 
 #include "pinocchio/parsers/urdf.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
@@ -409,6 +410,52 @@ int main(int argc, const char ** argv)
   }
   std::cout << "Minv = \t"; timer.toc(std::cout,NBT);
 
+  // Point contacts at the leaves of the kinematic tree.
+  std::vector<bool> is_leaf((size_t)model.njoints,true);
+  for(JointIndex i=1;i<(JointIndex)model.njoints;++i)
+    is_leaf[model.parents[i]] = false;
+
+  computeAllTerms(model,data,qs[0],qdots[0]);
+  Data::Matrix6x J_leaf(6,model.nv);
+  std::vector<JointIndex> leaves;
+  for(JointIndex i=1;i<(JointIndex)model.njoints;++i)
+    if(is_leaf[i]) leaves.push_back(i);
+
+  const Eigen::DenseIndex nc = 3*(Eigen::DenseIndex)leaves.size();
+  MatrixXd J_contact(nc,model.nv);
+  BranchSparseJacobian J_sparse(model.nv);
+  for(size_t k=0;k<leaves.size();++k)
+  {
+    J_leaf.setZero();
+    getJointJacobian(model,data,leaves[k],LOCAL,J_leaf);
+    J_contact.middleRows<3>(3*(Eigen::DenseIndex)k) = J_leaf.topRows<3>();
+    J_sparse.addBlock(model,leaves[k],J_leaf.topRows<3>());
+  }
+  const VectorXd gamma(VectorXd::Zero(nc));
+  std::cout << "nc = " << nc << std::endl;
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    forwardDynamics(model,data,qddots[_smooth],J_contact,gamma,1e-12);
+  }
+  std::cout << "Contact Dynamics (dense) = \t"; timer.toc(std::cout,NBT);
+
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    forwardDynamics(model,data,qddots[_smooth],J_sparse,gamma,1e-12);
+  }
+  std::cout << "Contact Dynamics (branch sparse) = \t"; timer.toc(std::cout,NBT);
+
+  BlockSparseLLT llt;
+  timer.tic();
+  SMOOTH(NBT)
+  {
+    forwardDynamics(model,data,qddots[_smooth],J_sparse,gamma,llt,1e-12);
+  }
+  std::cout << "Contact Dynamics (block sparse LLT) = \t"; timer.toc(std::cout,NBT);
+
   std::cout << "--" << std::endl;
   return 0;
 }
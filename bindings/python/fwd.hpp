@@ -34,6 +34,9 @@ namespace pinocchio
     // Expose geometry module
     void exposeGeometry();
     
+    // Expose pool module
+    void exposePool();
+    
     // Expose parsers
     void exposeParsers();
     
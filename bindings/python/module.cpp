@@ -10,6 +10,7 @@
 #include "pinocchio/bindings/python/utils/dependencies.hpp"
 #include "pinocchio/bindings/python/utils/conversions.hpp"
 #include "pinocchio/bindings/python/utils/registration.hpp"
+#include "pinocchio/bindings/python/utils/memory-footprint.hpp"
 
 #include "pinocchio/bindings/python/utils/std-vector.hpp"
 
@@ -81,11 +82,24 @@ BOOST_PYTHON_MODULE(pinocchio_pywrap)
   .value("ARG4",::pinocchio::ARG4)
   .export_values()
   ;
+  
+  bp::enum_< ::pinocchio::DataAllocation>("DataAllocation")
+  .value("ALLOCATE_NONE",::pinocchio::ALLOCATE_NONE)
+  .value("ALLOCATE_MINV",::pinocchio::ALLOCATE_MINV)
+  .value("ALLOCATE_CORIOLIS",::pinocchio::ALLOCATE_CORIOLIS)
+  .value("ALLOCATE_DERIVATIVES",::pinocchio::ALLOCATE_DERIVATIVES)
+  .value("ALLOCATE_KINEMATIC_HESSIANS",::pinocchio::ALLOCATE_KINEMATIC_HESSIANS)
+  .value("ALLOCATE_REGRESSORS",::pinocchio::ALLOCATE_REGRESSORS)
+  .value("ALLOCATE_ALL",::pinocchio::ALLOCATE_ALL)
+  .export_values()
+  ;
 
+  exposeMemoryFootprint();
   exposeModel();
   exposeFrame();
   exposeData();
   exposeGeometry();
+  exposePool();
   
   exposeAlgorithms();
   exposeParsers();
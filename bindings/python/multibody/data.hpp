@@ -91,6 +91,8 @@ namespace pinocchio
       DOC) 
 
 
+      static bool usesArena(const Data & data) { return data.arena() != NULL; }
+
       /* --- Exposing C++ API to python through the handler ----------------- */
       template<class PyClass>
       void visit(PyClass& cl) const 
@@ -98,6 +100,10 @@ namespace pinocchio
         cl
         .def(bp::init<>(bp::arg("self"),"Default constructor."))
         .def(bp::init<Model>(bp::arg("model"),"Constructs a data structure from a given model."))
+        .def(bp::init<Model,int>(bp::args("model","allocation"),
+                                 "Constructs a data structure from a given model, only allocating the optional buffers listed in allocation (combination of DataAllocation flags)."))
+        .def(bp::init<Model,int,bool>(bp::args("model","allocation","use_arena"),
+                                      "Constructs a data structure from a given model. If use_arena is True, the per-joint and per-frame vectors are allocated contiguously, in a single arena sized from the model."))
         
         .ADD_DATA_PROPERTY(a,"Joint spatial acceleration")
         .ADD_DATA_PROPERTY(oa,
@@ -166,6 +172,18 @@ namespace pinocchio
         .ADD_DATA_PROPERTY(staticRegressor,"Static regressor.")
         .ADD_DATA_PROPERTY(jointTorqueRegressor,"Joint torque regressor.")
         
+        .ADD_DATA_PROPERTY_READONLY(allocation,"Optional buffers currently allocated (combination of DataAllocation flags).")
+        .def("allocate",&Data::allocate,bp::args("self","model","flags"),
+             "Allocate the optional buffers listed in flags (combination of DataAllocation flags) which are not allocated yet.")
+        .def("release",&Data::release,bp::args("self","flags"),
+             "Release the optional buffers listed in flags (combination of DataAllocation flags).")
+        .def("isAllocated",&Data::isAllocated,bp::args("self","flags"),
+             "Returns true if all the optional buffers listed in flags are allocated.")
+        .def("usesArena",&DataPythonVisitor::usesArena,bp::arg("self"),
+             "Returns true if the per-joint and per-frame vectors are allocated in an arena.")
+        .def("memoryFootprint",&Data::memoryFootprint,bp::arg("self"),
+             "Returns the memory footprint of the data structure, detailed field by field.")
+        
         .def(bp::self == bp::self)
         .def(bp::self != bp::self)
         ;
@@ -86,6 +86,16 @@ namespace pinocchio
                       &GeometryData::radius,
                       "Vector of radius of bodies, i.e. the distance between the further point of the geometry object from the joint center.\n"
                       "note: This radius information might be usuful in continuous collision checking")
+        .def_readwrite("enableBroadPhase",
+                       &GeometryData::enableBroadPhase,
+                       "If true, the pairs whose bounding spheres are too far apart are skipped by computeCollisions and computeDistances.")
+        .def_readonly("boundingSphereCenters",
+                      &GeometryData::boundingSphereCenters,
+                      "Centers of the bounding spheres of the geometry objects, expressed in the world frame.\n"
+                      "note: These quantities are updated by updateGeometryPlacements when enableBroadPhase is true.")
+        .def_readonly("nculledPairs",
+                      &GeometryData::nculledPairs,
+                      "Number of active collision pairs culled by the broad phase during the last collision or distance computation.")
 #endif // PINOCCHIO_WITH_HPP_FCL
         
         .def("fillInnerOuterObjectMaps", &GeometryData::fillInnerOuterObjectMaps,
@@ -99,6 +109,8 @@ namespace pinocchio
         .def("deactivateCollisionPair",&GeometryData::deactivateCollisionPair,
              bp::args("self","pair_id"),
              "Deactivate the collsion pair pair_id in geomModel.collisionPairs if it exists.")
+        .def("memoryFootprint",&GeometryData::memoryFootprint,bp::arg("self"),
+             "Returns the memory footprint of the geometry data, detailed field by field.")
         ;
 
 #ifdef PINOCCHIO_WITH_HPP_FCL  
@@ -81,6 +81,8 @@ namespace pinocchio
         .def("findCollisionPair", &GeometryModel::findCollisionPair,
              bp::args("collision_pair"),
              "Return the index of a collision pair.")
+        .def("memoryFootprint",&GeometryModel::memoryFootprint,bp::arg("self"),
+             "Returns the memory footprint of the geometry model, detailed field by field.")
 
         .def(bp::self == bp::self)
         .def(bp::self != bp::self)
@@ -297,6 +297,8 @@ namespace pinocchio
         
         .def("check",(bool (Model::*)(const Data &) const) &Model::check,bp::args("self","data"),
              "Check consistency of data wrt model.")
+        .def("memoryFootprint",&Model::memoryFootprint,bp::arg("self"),
+             "Returns the memory footprint of the model, detailed field by field.")
         
         .def(bp::self == bp::self)
         .def(bp::self != bp::self)
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_python_multibody_pool_geometry_hpp__
+#define __pinocchio_python_multibody_pool_geometry_hpp__
+
+#include <eigenpy/memory.hpp>
+
+#include "pinocchio/multibody/pool/geometry.hpp"
+#include "pinocchio/bindings/python/utils/copyable.hpp"
+
+EIGENPY_DEFINE_STRUCT_ALLOCATOR_SPECIALIZATION(pinocchio::GeometryPool)
+
+namespace pinocchio
+{
+  namespace python
+  {
+    namespace bp = boost::python;
+    
+    template<typename GeometryPool>
+    struct GeometryPoolPythonVisitor
+    : public bp::def_visitor< GeometryPoolPythonVisitor<GeometryPool> >
+    {
+      typedef typename GeometryPool::Base Base;
+      typedef typename GeometryPool::Model Model;
+      typedef typename GeometryPool::GeometryModel GeometryModel;
+      typedef typename GeometryPool::GeometryData GeometryData;
+      
+      /* --- Exposing C++ API to python through the handler ----------------- */
+      template<class PyClass>
+      void visit(PyClass & cl) const
+      {
+        cl
+        .def(bp::init<Model,GeometryModel,bp::optional<size_t> >(bp::args("self","model","geometry_model","size"),
+                                                                   "Default constructor."))
+        .def(bp::init<GeometryPool>(bp::args("self","other"),
+                                    "Copy constructor."))
+        
+        .def("geometry_model",(const GeometryModel & (GeometryPool::*)() const)&GeometryPool::geometry_model,
+             bp::arg("self"),"Geometry model contained in the pool.",
+             bp::return_internal_reference<>())
+        .def("geometry_data",(GeometryData & (GeometryPool::*)(const size_t))&GeometryPool::geometry_data,
+             bp::args("self","index"),"Return a specific geometry_data.",
+             bp::return_internal_reference<>())
+        
+        .def("update",(void (GeometryPool::*)(const GeometryModel &))&GeometryPool::update,
+             bp::args("self","geometry_model"),
+             "Update the geometry model of the pool and re-allocate all the geometry datas from it.")
+        .def("update",(void (GeometryPool::*)(const GeometryData &))&GeometryPool::update,
+             bp::args("self","geometry_data"),
+             "Set all the geometry datas of the pool to the input geometry data value.")
+        .def("update",(void (GeometryPool::*)(const GeometryModel &, const GeometryData &))&GeometryPool::update,
+             bp::args("self","geometry_model","geometry_data"),
+             "Update the geometry model and set all the geometry datas of the pool to the input geometry data value.")
+        ;
+      }
+      
+      static void expose()
+      {
+        bp::class_<GeometryPool,bp::bases<Base> >("GeometryPool",
+                                                  "Pool containing a model + a geometry_model and several datas + geometry_datas for parallel computations",
+                                                  bp::no_init)
+        .def(GeometryPoolPythonVisitor())
+        .def(CopyableVisitor<GeometryPool>())
+        ;
+      }
+    };
+  }
+}
+
+#endif // ifndef __pinocchio_python_multibody_pool_geometry_hpp__
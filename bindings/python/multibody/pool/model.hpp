@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_python_multibody_pool_model_hpp__
+#define __pinocchio_python_multibody_pool_model_hpp__
+
+#include <eigenpy/memory.hpp>
+
+#include "pinocchio/multibody/pool/model.hpp"
+#include "pinocchio/bindings/python/utils/copyable.hpp"
+
+EIGENPY_DEFINE_STRUCT_ALLOCATOR_SPECIALIZATION(pinocchio::ModelPool)
+
+namespace pinocchio
+{
+  namespace python
+  {
+    namespace bp = boost::python;
+    
+    template<typename ModelPool>
+    struct ModelPoolPythonVisitor
+    : public bp::def_visitor< ModelPoolPythonVisitor<ModelPool> >
+    {
+      typedef typename ModelPool::Model Model;
+      typedef typename ModelPool::Data Data;
+      
+      /* --- Exposing C++ API to python through the handler ----------------- */
+      template<class PyClass>
+      void visit(PyClass & cl) const
+      {
+        cl
+        .def(bp::init<Model,bp::optional<size_t> >(bp::args("self","model","size"),
+                                                   "Default constructor."))
+        .def(bp::init<ModelPool>(bp::args("self","other"),
+                                 "Copy constructor."))
+        
+        .def("model",(const Model & (ModelPool::*)() const)&ModelPool::model,
+             bp::arg("self"),"Model contained in the pool.",
+             bp::return_internal_reference<>())
+        .def("data",(Data & (ModelPool::*)(const size_t))&ModelPool::data,
+             bp::args("self","index"),"Return a specific data.",
+             bp::return_internal_reference<>())
+        
+        .def("size",&ModelPool::size,bp::arg("self"),
+             "Returns the size of the pool.")
+        .def("resize",&ModelPool::resize,bp::args("self","new_size"),
+             "Resize the pool.")
+        
+        .def("update",(void (ModelPool::*)(const Model &))&ModelPool::update,
+             bp::args("self","model"),
+             "Update the model of the pool and re-allocate all the datas from it.")
+        .def("update",(void (ModelPool::*)(const Data &))&ModelPool::update,
+             bp::args("self","data"),
+             "Set all the datas of the pool to the input data value.")
+        .def("update",(void (ModelPool::*)(const Model &, const Data &))&ModelPool::update,
+             bp::args("self","model","data"),
+             "Update the model and set all the datas of the pool to the input data value.")
+        ;
+      }
+      
+      static void expose()
+      {
+        bp::class_<ModelPool>("ModelPool",
+                              "Pool containing a model and several datas for parallel computations",
+                              bp::no_init)
+        .def(ModelPoolPythonVisitor())
+        .def(CopyableVisitor<ModelPool>())
+        ;
+      }
+    };
+  }
+}
+
+#endif // ifndef __pinocchio_python_multibody_pool_model_hpp__
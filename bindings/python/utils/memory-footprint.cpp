@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/bindings/python/utils/memory-footprint.hpp"
+#include "pinocchio/bindings/python/utils/printable.hpp"
+#include "pinocchio/utils/memory-footprint.hpp"
+
+#include <boost/python.hpp>
+
+namespace pinocchio
+{
+  namespace python
+  {
+    
+    namespace bp = boost::python;
+    
+    static bp::dict memoryFootprint_fields(const MemoryFootprint & footprint)
+    {
+      bp::dict res;
+      for(MemoryFootprint::FieldVector::const_iterator it = footprint.fields.begin();
+          it != footprint.fields.end(); ++it)
+        res[it->first] = it->second;
+      return res;
+    }
+
+    void exposeMemoryFootprint()
+    {
+      bp::class_<MemoryFootprint>("MemoryFootprint",
+                                  "Memory footprint of a structure, detailed field by field.",
+                                  bp::no_init)
+      .def_readonly("base",&MemoryFootprint::base,
+                    "Size of the structure itself, in bytes.")
+      .add_property("fields",&memoryFootprint_fields,
+                    "Dictionary of the number of bytes dynamically allocated by each field.")
+      .def("total",&MemoryFootprint::total,bp::arg("self"),
+           "Returns the total number of bytes: the size of the structure plus the dynamic memory of all its fields.")
+      .def("__getitem__",&MemoryFootprint::field,bp::args("self","name"),
+           "Returns the number of bytes dynamically allocated by the field name, or 0 if there is no such field.")
+      .def(PrintableVisitor<MemoryFootprint>())
+      ;
+    }
+    
+  } // namespace python
+} // namespace pinocchio
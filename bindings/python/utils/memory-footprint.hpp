@@ -0,0 +1,20 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_python_utils_memory_footprint_hpp__
+#define __pinocchio_python_utils_memory_footprint_hpp__
+
+#include "pinocchio/bindings/python/fwd.hpp"
+
+namespace pinocchio
+{
+  namespace python
+  {
+    
+    void exposeMemoryFootprint();
+    
+  } // namespace python
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_python_utils_memory_footprint_hpp__
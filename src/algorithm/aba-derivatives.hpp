@@ -108,6 +108,7 @@ namespace pinocchio
                                     const Eigen::MatrixBase<TangentVectorType1> & v,
                                     const Eigen::MatrixBase<TangentVectorType2> & tau)
   {
+    data.allocate(model,ALLOCATE_MINV | ALLOCATE_DERIVATIVES);
     computeABADerivatives(model,data,q,v,tau,
                           data.ddq_dq,data.ddq_dv,data.Minv);
   }
@@ -141,6 +142,7 @@ namespace pinocchio
                                     const Eigen::MatrixBase<TangentVectorType2> & tau,
                                     const container::aligned_vector< ForceTpl<Scalar,Options> > & fext)
   {
+    data.allocate(model,ALLOCATE_MINV | ALLOCATE_DERIVATIVES);
     computeABADerivatives(model,data,q,v,tau,fext,
                           data.ddq_dq,data.ddq_dv,data.Minv);
   }
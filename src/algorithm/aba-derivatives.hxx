@@ -350,6 +350,7 @@ namespace pinocchio
     PINOCCHIO_CHECK_ARGUMENT_SIZE(aba_partial_dtau.cols(), model.nv);
     PINOCCHIO_CHECK_ARGUMENT_SIZE(aba_partial_dtau.rows(), model.nv);
     assert(model.check(data) && "data is not consistent with model.");
+    data.allocate(model,ALLOCATE_DERIVATIVES);
     
     typedef typename ModelTpl<Scalar,Options,JointCollectionTpl>::JointIndex JointIndex;
     
@@ -420,6 +421,7 @@ namespace pinocchio
     PINOCCHIO_CHECK_ARGUMENT_SIZE(aba_partial_dtau.cols(), model.nv);
     PINOCCHIO_CHECK_ARGUMENT_SIZE(aba_partial_dtau.rows(), model.nv);
     assert(model.check(data) && "data is not consistent with model.");
+    data.allocate(model,ALLOCATE_DERIVATIVES);
     
     typedef typename ModelTpl<Scalar,Options,JointCollectionTpl>::JointIndex JointIndex;
     
@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_branch_sparse_jacobian_hpp__
+#define __pinocchio_algorithm_branch_sparse_jacobian_hpp__
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+
+#include <Eigen/Cholesky>
+
+namespace pinocchio
+{
+  ///
+  /// \brief Jacobian matrix stored by blocks of rows, each block being attached to a joint of the kinematic tree.
+  ///        The rows of a block only depend on the degrees of freedom supporting the joint (see ModelTpl::supports):
+  ///        only these columns are stored, in a dense matrix of dimension block rows x support size.
+  ///
+  /// \tparam _Scalar Scalar type.
+  /// \tparam _Options Alignment options of the Eigen matrices.
+  ///
+  template<typename _Scalar, int _Options>
+  struct BranchSparseJacobianTpl
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef _Scalar Scalar;
+    enum { Options = _Options };
+
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Options> MatrixXs;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1,Options> VectorXs;
+    typedef PINOCCHIO_ALIGNED_STD_VECTOR(MatrixXs) MatrixVector;
+    typedef std::vector<int> IndexVector;
+
+    ///
+    /// \brief Default constructor: an empty Jacobian with nv columns.
+    ///
+    /// \param[in] nv Dimension of the tangent space of the model.
+    ///
+    explicit BranchSparseJacobianTpl(const int nv = 0)
+    : m_nv(nv)
+    , m_rows(0)
+    {}
+
+    ///
+    /// \brief Append a block of rows attached to the joint joint_id.
+    ///
+    /// \param[in] model The model structure of the rigid body system.
+    /// \param[in] joint_id Index of the joint the block is attached to.
+    /// \param[in] J The dense block of rows (dim rows x model.nv). Only the columns supporting joint_id are read.
+    ///
+    /// \return The index of the new block.
+    ///
+    template<template<typename,int> class JointCollectionTpl, typename MatrixLike>
+    size_t addBlock(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                    const JointIndex joint_id,
+                    const Eigen::MatrixBase<MatrixLike> & J);
+
+    /// \brief Remove all the blocks.
+    void clear();
+
+    /// \returns the number of rows of the Jacobian.
+    int rows() const { return m_rows; }
+
+    /// \returns the number of columns of the Jacobian.
+    int cols() const { return m_nv; }
+
+    /// \returns the number of blocks.
+    size_t size() const { return m_blocks.size(); }
+
+    /// \returns the index of the joint the block block_id is attached to.
+    JointIndex joint(const size_t block_id) const { return m_joints[block_id]; }
+
+    /// \returns the index of the first row of the block block_id.
+    int rowOffset(const size_t block_id) const { return m_row_offsets[block_id]; }
+
+    /// \returns the column indexes of the block block_id, in increasing order.
+    const IndexVector & support(const size_t block_id) const { return m_supports[block_id]; }
+
+    /// \returns the compact storage of the block block_id (dim block rows x support size).
+    const MatrixXs & block(const size_t block_id) const { return m_blocks[block_id]; }
+    MatrixXs & block(const size_t block_id) { return m_blocks[block_id]; }
+
+    ///
+    /// \brief Write the dense version of the Jacobian into J.
+    ///
+    /// \param[out] J The dense Jacobian (dim rows() x cols()).
+    ///
+    template<typename MatrixLike>
+    void toDense(const Eigen::MatrixBase<MatrixLike> & J) const;
+
+    ///
+    /// \brief Workspace used by \ref computeJMinvJt: for each block, \f$ \sqrt{D^{-1}} U^{-1} J^{\top} \f$ restricted to the support rows.
+    ///
+    MatrixVector sDUiJt;
+
+  protected:
+
+    int m_nv;
+    int m_rows;
+    std::vector<JointIndex> m_joints;
+    std::vector<int> m_row_offsets;
+    std::vector<IndexVector> m_supports;
+    MatrixVector m_blocks;
+
+  }; // struct BranchSparseJacobianTpl
+
+  typedef BranchSparseJacobianTpl<double,0> BranchSparseJacobian;
+
+  ///
+  /// \brief Block-sparse Cholesky factorization of a matrix \f$ J M^{-1} J^{\top} \f$ (possibly damped) built from a branch sparse Jacobian.
+  ///        Two blocks of J attached to different root subtrees of the kinematic tree do not share any degree of freedom:
+  ///        the matrix is block diagonal once the blocks are grouped by root subtree, and each group is factorized independently.
+  ///
+  /// \note For a model with a single root joint (e.g. a floating base), there is a single group and the factorization is dense.
+  ///
+  template<typename _Scalar, int _Options>
+  struct BlockSparseLLTTpl
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef _Scalar Scalar;
+    enum { Options = _Options };
+
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Options> MatrixXs;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1,Options> VectorXs;
+    typedef Eigen::LLT<MatrixXs> LLT;
+    typedef PINOCCHIO_ALIGNED_STD_VECTOR(LLT) LLTVector;
+    typedef PINOCCHIO_ALIGNED_STD_VECTOR(VectorXs) VectorVector;
+    typedef std::vector<int> IndexVector;
+
+    BlockSparseLLTTpl() {}
+
+    ///
+    /// \brief Compute the factorization of mat, whose sparsity pattern is given by the blocks of J.
+    ///
+    /// \param[in] J The branch sparse Jacobian.
+    /// \param[in] mat The matrix to factorize (dim J.rows() x J.rows()), typically computed by \ref computeJMinvJt.
+    ///
+    template<typename MatrixLike>
+    void compute(const BranchSparseJacobianTpl<Scalar,Options> & J,
+                 const Eigen::MatrixBase<MatrixLike> & mat);
+
+    ///
+    /// \brief Solve in place mat * x = b, where mat is the factorized matrix.
+    ///
+    /// \param[in,out] x The right hand side b as input, the solution x as output (dim J.rows()).
+    ///
+    template<typename VectorLike>
+    void solveInPlace(const Eigen::MatrixBase<VectorLike> & x) const;
+
+    /// \returns the number of independent groups.
+    size_t size() const { return m_llts.size(); }
+
+    /// \returns the rows of the factorized matrix belonging to the group group_id.
+    const IndexVector & rows(const size_t group_id) const { return m_rows[group_id]; }
+
+    /// \returns the Cholesky factorization of the group group_id.
+    const LLT & llt(const size_t group_id) const { return m_llts[group_id]; }
+
+  protected:
+
+    std::vector<IndexVector> m_rows;
+    LLTVector m_llts;
+    mutable VectorVector m_tmp;
+
+  }; // struct BlockSparseLLTTpl
+
+  typedef BlockSparseLLTTpl<double,0> BlockSparseLLT;
+
+  ///
+  /// \brief Compute the product of the Jacobian with a vector, only visiting the structurally nonzero columns.
+  ///
+  /// \param[in] J The branch sparse Jacobian.
+  /// \param[in] x The input vector (dim J.cols()).
+  /// \param[out] res The result J*x (dim J.rows()).
+  ///
+  template<typename Scalar, int Options, typename VectorLike, typename ResultVectorType>
+  inline void jacobianProduct(const BranchSparseJacobianTpl<Scalar,Options> & J,
+                              const Eigen::MatrixBase<VectorLike> & x,
+                              const Eigen::MatrixBase<ResultVectorType> & res);
+
+  ///
+  /// \brief Compute the product of the transpose of the Jacobian with a vector, only visiting the structurally nonzero columns.
+  ///
+  /// \param[in] J The branch sparse Jacobian.
+  /// \param[in] f The input vector (dim J.rows()).
+  /// \param[out] res The result J^T*f (dim J.cols()).
+  ///
+  template<typename Scalar, int Options, typename VectorLike, typename ResultVectorType>
+  inline void jacobianTransposeProduct(const BranchSparseJacobianTpl<Scalar,Options> & J,
+                                       const Eigen::MatrixBase<VectorLike> & f,
+                                       const Eigen::MatrixBase<ResultVectorType> & res);
+
+  ///
+  /// \brief Compute \f$ J M^{-1} J^{\top} \f$ from the sparse Cholesky decomposition \f$ M = U D U^{\top} \f$ stored in data.
+  ///        \f$ U^{-1} J^{\top} \f$ keeps the branch sparsity of J, and two blocks only interact through the degrees of freedom
+  ///        supporting both of them.
+  ///        This function assumes that \ref cholesky::decompose has been called first.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system, containing the Cholesky decomposition of the joint space inertia matrix.
+  /// \param[in,out] J The branch sparse Jacobian. Its workspace J.sDUiJt is updated.
+  /// \param[out] res The result \f$ J M^{-1} J^{\top} \f$ (dim J.rows() x J.rows()).
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ResultMatrixType>
+  inline void computeJMinvJt(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                             const DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                             BranchSparseJacobianTpl<Scalar,Options> & J,
+                             const Eigen::MatrixBase<ResultMatrixType> & res);
+
+} // namespace pinocchio
+
+/* --- Details -------------------------------------------------------------------- */
+#include "pinocchio/algorithm/branch-sparse-jacobian.hxx"
+
+#endif // ifndef __pinocchio_algorithm_branch_sparse_jacobian_hpp__
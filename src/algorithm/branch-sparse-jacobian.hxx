@@ -0,0 +1,267 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_branch_sparse_jacobian_hxx__
+#define __pinocchio_algorithm_branch_sparse_jacobian_hxx__
+
+#include "pinocchio/algorithm/check.hpp"
+
+/// @cond DEV
+
+namespace pinocchio
+{
+  template<typename Scalar, int Options>
+  template<template<typename,int> class JointCollectionTpl, typename MatrixLike>
+  size_t BranchSparseJacobianTpl<Scalar,Options>::addBlock(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                                           const JointIndex joint_id,
+                                                           const Eigen::MatrixBase<MatrixLike> & J)
+  {
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(joint_id < (JointIndex)model.njoints, "joint_id is larger than the number of joints.");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(model.nv, m_nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(J.cols(), model.nv);
+
+    // Gather the degrees of freedom of the joints supporting joint_id, from the root to joint_id.
+    IndexVector support;
+    const typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector & joint_support = model.supports[joint_id];
+    for(size_t k = 1; k < joint_support.size(); ++k)
+    {
+      const JointIndex support_id = joint_support[k];
+      const int idx_v = model.joints[support_id].idx_v();
+      for(int j = 0; j < model.joints[support_id].nv(); ++j)
+        support.push_back(idx_v+j);
+    }
+
+    MatrixXs block((Eigen::DenseIndex)J.rows(),(Eigen::DenseIndex)support.size());
+    for(size_t k = 0; k < support.size(); ++k)
+      block.col((Eigen::DenseIndex)k) = J.col(support[k]);
+
+    m_joints.push_back(joint_id);
+    m_row_offsets.push_back(m_rows);
+    m_supports.push_back(support);
+    m_blocks.push_back(block);
+    m_rows += (int)J.rows();
+
+    return m_blocks.size()-1;
+  }
+
+  template<typename Scalar, int Options>
+  void BranchSparseJacobianTpl<Scalar,Options>::clear()
+  {
+    m_rows = 0;
+    m_joints.clear();
+    m_row_offsets.clear();
+    m_supports.clear();
+    m_blocks.clear();
+    sDUiJt.clear();
+  }
+
+  template<typename Scalar, int Options>
+  template<typename MatrixLike>
+  void BranchSparseJacobianTpl<Scalar,Options>::toDense(const Eigen::MatrixBase<MatrixLike> & J) const
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(J.rows(), m_rows);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(J.cols(), m_nv);
+
+    MatrixLike & J_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixLike,J);
+    J_.setZero();
+    for(size_t block_id = 0; block_id < m_blocks.size(); ++block_id)
+    {
+      const MatrixXs & block = m_blocks[block_id];
+      const IndexVector & support = m_supports[block_id];
+      for(size_t k = 0; k < support.size(); ++k)
+        J_.col(support[k]).segment(m_row_offsets[block_id],block.rows()) = block.col((Eigen::DenseIndex)k);
+    }
+  }
+
+  template<typename Scalar, int Options, typename VectorLike, typename ResultVectorType>
+  inline void jacobianProduct(const BranchSparseJacobianTpl<Scalar,Options> & J,
+                              const Eigen::MatrixBase<VectorLike> & x,
+                              const Eigen::MatrixBase<ResultVectorType> & res)
+  {
+    typedef BranchSparseJacobianTpl<Scalar,Options> Jacobian;
+    typedef typename Jacobian::MatrixXs MatrixXs;
+    typedef typename Jacobian::IndexVector IndexVector;
+
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(x.size(), J.cols());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.size(), J.rows());
+
+    ResultVectorType & res_ = PINOCCHIO_EIGEN_CONST_CAST(ResultVectorType,res);
+    res_.setZero();
+    for(size_t block_id = 0; block_id < J.size(); ++block_id)
+    {
+      const MatrixXs & block = J.block(block_id);
+      const IndexVector & support = J.support(block_id);
+      typename ResultVectorType::SegmentReturnType res_block = res_.segment(J.rowOffset(block_id),block.rows());
+      for(size_t k = 0; k < support.size(); ++k)
+        res_block += block.col((Eigen::DenseIndex)k) * x[support[k]];
+    }
+  }
+
+  template<typename Scalar, int Options, typename VectorLike, typename ResultVectorType>
+  inline void jacobianTransposeProduct(const BranchSparseJacobianTpl<Scalar,Options> & J,
+                                       const Eigen::MatrixBase<VectorLike> & f,
+                                       const Eigen::MatrixBase<ResultVectorType> & res)
+  {
+    typedef BranchSparseJacobianTpl<Scalar,Options> Jacobian;
+    typedef typename Jacobian::MatrixXs MatrixXs;
+    typedef typename Jacobian::IndexVector IndexVector;
+
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(f.size(), J.rows());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.size(), J.cols());
+
+    ResultVectorType & res_ = PINOCCHIO_EIGEN_CONST_CAST(ResultVectorType,res);
+    res_.setZero();
+    for(size_t block_id = 0; block_id < J.size(); ++block_id)
+    {
+      const MatrixXs & block = J.block(block_id);
+      const IndexVector & support = J.support(block_id);
+      typename VectorLike::ConstSegmentReturnType f_block = f.segment(J.rowOffset(block_id),block.rows());
+      for(size_t k = 0; k < support.size(); ++k)
+        res_[support[k]] += block.col((Eigen::DenseIndex)k).dot(f_block);
+    }
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ResultMatrixType>
+  inline void computeJMinvJt(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                             const DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                             BranchSparseJacobianTpl<Scalar,Options> & J,
+                             const Eigen::MatrixBase<ResultMatrixType> & res)
+  {
+    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+    typedef BranchSparseJacobianTpl<Scalar,Options> Jacobian;
+    typedef typename Jacobian::MatrixXs MatrixXs;
+    typedef typename Jacobian::IndexVector IndexVector;
+
+    assert(model.check(data) && "data is not consistent with model.");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(J.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.rows(), J.rows());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.cols(), J.rows());
+
+    const typename Data::MatrixXs & U = data.U;
+    ResultMatrixType & res_ = PINOCCHIO_EIGEN_CONST_CAST(ResultMatrixType,res);
+
+    // Compute sqrt(D^-1) * U^-1 * J^T block by block: U^-1 keeps the support of each block.
+    J.sDUiJt.resize(J.size());
+    for(size_t block_id = 0; block_id < J.size(); ++block_id)
+    {
+      const IndexVector & support = J.support(block_id);
+      const int support_size = (int)support.size();
+      MatrixXs & sDUiJt = J.sDUiJt[block_id];
+      sDUiJt = J.block(block_id).transpose();
+
+      for(int k = support_size-1; k >= 0; --k)
+      {
+        for(int l = k+1; l < support_size; ++l)
+          sDUiJt.row(k) -= U(support[(size_t)k],support[(size_t)l]) * sDUiJt.row(l);
+      }
+      for(int k = 0; k < support_size; ++k)
+        sDUiJt.row(k) /= math::sqrt(data.D[support[(size_t)k]]);
+    }
+
+    // Two blocks only share the degrees of freedom of their common supporting joints,
+    // which correspond to the common prefix of their supports.
+    for(size_t block_id1 = 0; block_id1 < J.size(); ++block_id1)
+    {
+      const IndexVector & support1 = J.support(block_id1);
+      const MatrixXs & sDUiJt1 = J.sDUiJt[block_id1];
+      const int row1 = J.rowOffset(block_id1);
+
+      for(size_t block_id2 = block_id1; block_id2 < J.size(); ++block_id2)
+      {
+        const IndexVector & support2 = J.support(block_id2);
+        const MatrixXs & sDUiJt2 = J.sDUiJt[block_id2];
+        const int row2 = J.rowOffset(block_id2);
+
+        Eigen::DenseIndex common_size = 0;
+        while((size_t)common_size < support1.size() && (size_t)common_size < support2.size()
+              && support1[(size_t)common_size] == support2[(size_t)common_size])
+          ++common_size;
+
+        typename ResultMatrixType::BlockXpr res_block = res_.block(row1,row2,sDUiJt1.cols(),sDUiJt2.cols());
+        res_block.noalias() = sDUiJt1.topRows(common_size).transpose() * sDUiJt2.topRows(common_size);
+        if(block_id2 != block_id1)
+          res_.block(row2,row1,sDUiJt2.cols(),sDUiJt1.cols()) = res_block.transpose();
+      }
+    }
+  }
+
+  template<typename Scalar, int Options>
+  template<typename MatrixLike>
+  void BlockSparseLLTTpl<Scalar,Options>::compute(const BranchSparseJacobianTpl<Scalar,Options> & J,
+                                                  const Eigen::MatrixBase<MatrixLike> & mat)
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(mat.rows(), J.rows());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(mat.cols(), J.rows());
+
+    // Group the rows of the blocks by the first degree of freedom of their support, i.e. by root subtree.
+    // Blocks attached to the universe have an empty support and form their own group.
+    std::vector<int> group_roots;
+    m_rows.clear();
+    for(size_t block_id = 0; block_id < J.size(); ++block_id)
+    {
+      const IndexVector & support = J.support(block_id);
+      size_t group_id = m_rows.size();
+      if(!support.empty())
+      {
+        for(size_t k = 0; k < group_roots.size(); ++k)
+        {
+          if(group_roots[k] == support[0])
+          {
+            group_id = k;
+            break;
+          }
+        }
+      }
+
+      if(group_id == m_rows.size())
+      {
+        group_roots.push_back(support.empty() ? -1 : support[0]);
+        m_rows.push_back(IndexVector());
+      }
+
+      for(int k = 0; k < J.block(block_id).rows(); ++k)
+        m_rows[group_id].push_back(J.rowOffset(block_id)+k);
+    }
+
+    m_llts.resize(m_rows.size());
+    m_tmp.resize(m_rows.size());
+    MatrixXs group_mat;
+    for(size_t group_id = 0; group_id < m_rows.size(); ++group_id)
+    {
+      const IndexVector & rows = m_rows[group_id];
+      const Eigen::DenseIndex group_size = (Eigen::DenseIndex)rows.size();
+      group_mat.resize(group_size,group_size);
+      for(Eigen::DenseIndex j = 0; j < group_size; ++j)
+        for(Eigen::DenseIndex i = 0; i < group_size; ++i)
+          group_mat(i,j) = mat(rows[(size_t)i],rows[(size_t)j]);
+
+      m_llts[group_id].compute(group_mat);
+      m_tmp[group_id].resize(group_size);
+    }
+  }
+
+  template<typename Scalar, int Options>
+  template<typename VectorLike>
+  void BlockSparseLLTTpl<Scalar,Options>::solveInPlace(const Eigen::MatrixBase<VectorLike> & x) const
+  {
+    VectorLike & x_ = PINOCCHIO_EIGEN_CONST_CAST(VectorLike,x);
+    for(size_t group_id = 0; group_id < m_rows.size(); ++group_id)
+    {
+      const IndexVector & rows = m_rows[group_id];
+      VectorXs & tmp = m_tmp[group_id];
+      for(size_t k = 0; k < rows.size(); ++k)
+        tmp[(Eigen::DenseIndex)k] = x_[rows[k]];
+
+      m_llts[group_id].solveInPlace(tmp);
+
+      for(size_t k = 0; k < rows.size(); ++k)
+        x_[rows[k]] = tmp[(Eigen::DenseIndex)k];
+    }
+  }
+
+} // namespace pinocchio
+
+/// @endcond
+
+#endif // ifndef __pinocchio_algorithm_branch_sparse_jacobian_hxx__
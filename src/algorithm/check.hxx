@@ -120,14 +120,35 @@ namespace pinocchio
     CHECK_DATA( data.dq_after.size() == model.nv );
     //CHECK_DATA( data.impulse_c.size()== model.nv );
     
-    CHECK_DATA( data.kinematic_hessians.dimension(0) == 6);
+    // The optional buffers are only checked when allocated
+    if(data.isAllocated(ALLOCATE_MINV))
+    {
+      CHECK_DATA( data.Minv.rows()   == model.nv );
+      CHECK_DATA( data.Minv.cols()   == model.nv );
+    }
+    if(data.isAllocated(ALLOCATE_CORIOLIS))
+    {
+      CHECK_DATA( data.C.rows()      == model.nv );
+      CHECK_DATA( data.C.cols()      == model.nv );
+    }
+    if(data.isAllocated(ALLOCATE_DERIVATIVES))
+    {
+      CHECK_DATA( data.dtau_dq.cols()  == model.nv );
+      CHECK_DATA( data.dtau_dv.cols()  == model.nv );
+      CHECK_DATA( data.ddq_dq.cols()   == model.nv );
+      CHECK_DATA( data.ddq_dv.cols()   == model.nv );
+    }
+    if(data.isAllocated(ALLOCATE_KINEMATIC_HESSIANS))
+    {
+      CHECK_DATA( data.kinematic_hessians.dimension(0) == 6);
 #if EIGEN_VERSION_AT_LEAST(3,2,90) && !EIGEN_VERSION_AT_LEAST(3,2,93)
-    CHECK_DATA( data.kinematic_hessians.dimension(1) == std::max(1,model.nv));
-    CHECK_DATA( data.kinematic_hessians.dimension(2) == std::max(1,model.nv));
+      CHECK_DATA( data.kinematic_hessians.dimension(1) == std::max(1,model.nv));
+      CHECK_DATA( data.kinematic_hessians.dimension(2) == std::max(1,model.nv));
 #else
-    CHECK_DATA( data.kinematic_hessians.dimension(1) == model.nv);
-    CHECK_DATA( data.kinematic_hessians.dimension(2) == model.nv);
+      CHECK_DATA( data.kinematic_hessians.dimension(1) == model.nv);
+      CHECK_DATA( data.kinematic_hessians.dimension(2) == model.nv);
 #endif
+    }
     
     CHECK_DATA( (int)data.oMf.size()      == model.nframes );
 
@@ -36,6 +36,36 @@ namespace pinocchio
     decompose(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
               DataTpl<Scalar,Options,JointCollectionTpl> & data);
 
+    ///
+    /// \brief Update the joint space inertia matrix data.M and its Cholesky decomposition (data.U, data.D and data.Dinv)
+    ///        after a change of the spatial inertia of the body supported by the joint joint_id,
+    ///        e.g. when a payload is identified or an object is grasped.
+    ///
+    /// \note The variation of M is \f$ J^{\top} (I_{after} - I_{before}) J \f$, with \f$ J \f$ the Jacobian of the body.
+    ///       It only affects the rows and columns of the support of the joint (data.supports_fromRow)
+    ///       and each inertia is applied to the factors as six sparse rank-one updates (or downdates),
+    ///       so that the cost is proportional to the size of the support and not to the size of the model.
+    ///
+    /// \tparam JointCollection Collection of Joint types.
+    ///
+    /// \param[in] model The model structure of the rigid body system.
+    /// \param[in] data The data structure of the rigid body system.
+    /// \param[in] joint_id Index of the joint supporting the body whose inertia has changed.
+    /// \param[in] inertia_before The previous spatial inertia of the body, expressed in the local frame of the joint.
+    /// \param[in] inertia_after The new spatial inertia of the body, expressed in the local frame of the joint.
+    ///
+    /// \remarks pinocchio::crba and cholesky::decompose must have been called first. Only the upper triangular part of data.M is updated
+    ///          and the other quantities computed by pinocchio::crba (e.g. data.Ycrb) are left unchanged.
+    ///          The model is not modified: model.inertias[joint_id] should be set to inertia_after by the user if needed.
+    ///          The columns of the support of data.J are used as a workspace and are overwritten.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    void updateBodyInertia(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                           DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                           const JointIndex joint_id,
+                           const InertiaTpl<Scalar,Options> & inertia_before,
+                           const InertiaTpl<Scalar,Options> & inertia_after);
+
     ///
     /// \brief Return the solution \f$x\f$ of \f$ M x = y \f$ using the Cholesky decomposition stored in data given the entry \f$ y \f$. Act like solveInPlace of Eigen::LLT.
     ///
@@ -50,6 +80,8 @@ namespace pinocchio
     /// \param[in] data The data structure of the rigid body system.
     /// \param[inout] y The input matrix to inverse which also contains the result \f$x\f$ of the inversion.
     ///
+    /// \remark When y has several columns, they are all processed at once, walking the sparsity pattern of U a single time.
+    ///
     template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename Mat>
     Mat & solve(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
                 const DataTpl<Scalar,Options,JointCollectionTpl> & data,
@@ -223,6 +255,7 @@ namespace pinocchio
     computeMinv(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
                 DataTpl<Scalar,Options,JointCollectionTpl> & data)
     {
+      data.allocate(model,ALLOCATE_MINV);
       return computeMinv(model,data,data.Minv);
     }
     
@@ -7,6 +7,8 @@
 
 #include "pinocchio/algorithm/check.hpp"
 
+#include <Eigen/Eigenvalues>
+
 /// @cond DEV
 
 namespace pinocchio 
@@ -59,6 +61,126 @@ namespace pinocchio
       return data.U;
     }
 
+    namespace internal
+    {
+      ///
+      /// \brief Rank-one update of the factors, \f$ U D U^{\top} \leftarrow U D U^{\top} + \alpha z z^{\top} \f$,
+      ///        where the non-zero entries of z are contained in rows, a list of rows closed by ancestor sorted by increasing order.
+      ///        The vector z is modified.
+      ///
+      template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename VectorLike>
+      void rankOneUpdate(DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                         const std::vector<int> & rows,
+                         Scalar alpha,
+                         const Eigen::MatrixBase<VectorLike> & z)
+      {
+        typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+        
+        VectorLike & z_ = PINOCCHIO_EIGEN_CONST_CAST(VectorLike,z);
+        typename Data::MatrixXs & U = data.U;
+        typename Data::VectorXs & D = data.D;
+        
+        // Same recursion as decompose: the leaves are processed first.
+        for(std::vector<int>::const_reverse_iterator it = rows.rbegin(); it != rows.rend(); ++it)
+        {
+          const int j = *it;
+          const Scalar p = z_[j];
+          const Scalar D_new = D[j] + alpha * p * p;
+          const Scalar beta = p * alpha / D_new;
+          alpha = D[j] * alpha / D_new;
+          D[j] = D_new;
+          data.Dinv[j] = Scalar(1)/D_new;
+          for(int _i = data.parents_fromRow[(size_t)j]; _i >= 0;_i = data.parents_fromRow[(size_t)_i])
+          {
+            z_[_i] -= p * U(_i,j);
+            U(_i,j) += beta * z_[_i];
+          }
+        }
+      }
+      
+      ///
+      /// \brief Adds (sign = 1) or removes (sign = -1) the contribution \f$ J^{\top} I J \f$ of a body inertia to the factors,
+      ///        with J the Jacobian of the body expressed in the local frame of the joint.
+      ///        The mass and the rotational inertia around the center of mass give six rank-one terms.
+      ///
+      template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename Matrix6xLike>
+      void inertiaUpdate(DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                         const std::vector<int> & rows,
+                         const Scalar sign,
+                         const InertiaTpl<Scalar,Options> & inertia,
+                         const Eigen::MatrixBase<Matrix6xLike> & J)
+      {
+        typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+        typedef typename Data::Force Force;
+        typedef typename InertiaTpl<Scalar,Options>::Matrix3 Matrix3;
+        
+        typename Data::VectorXs & z = data.tmp;
+        const typename InertiaTpl<Scalar,Options>::Vector3 & c = inertia.lever();
+        
+        // Mass: the velocity of the center of mass is v + w x c
+        for(int k = 0; k < 3; ++k)
+        {
+          for(size_t a = 0; a < rows.size(); ++a)
+            z[rows[a]] = J(Force::LINEAR+k,rows[a])
+                       + J.col(rows[a]).template segment<3>(Force::ANGULAR).cross(c)[k];
+          rankOneUpdate(data,rows,sign*inertia.mass(),z);
+        }
+        
+        // Rotational inertia around the center of mass
+        Eigen::SelfAdjointEigenSolver<Matrix3> eig;
+        eig.computeDirect(inertia.inertia().matrix());
+        for(int k = 0; k < 3; ++k)
+        {
+          for(size_t a = 0; a < rows.size(); ++a)
+            z[rows[a]] = eig.eigenvectors().col(k).dot(J.col(rows[a]).template segment<3>(Force::ANGULAR));
+          rankOneUpdate(data,rows,sign*eig.eigenvalues()[k],z);
+        }
+      }
+    } // namespace internal
+    
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    void updateBodyInertia(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                           DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                           const JointIndex joint_id,
+                           const InertiaTpl<Scalar,Options> & inertia_before,
+                           const InertiaTpl<Scalar,Options> & inertia_after)
+    {
+      typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+      typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+      typedef typename Data::SE3 SE3;
+      typedef typename Data::Matrix6 Matrix6;
+      typedef typename Data::Matrix6x Matrix6x;
+      
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(joint_id > 0 && joint_id < (JointIndex)model.njoints, "joint_id is not a valid joint index");
+      assert(model.check(data) && "data is not consistent with model.");
+      
+      const typename Model::JointModel & jmodel = model.joints[joint_id];
+      const std::vector<int> & rows = data.supports_fromRow[(size_t)(jmodel.idx_v()+jmodel.nv()-1)];
+      
+      // Jacobian of the body expressed in the local frame of the joint, only the columns of the support are filled.
+      Matrix6x & J = data.J;
+      SE3 iMk(SE3::Identity());
+      for(JointIndex k = joint_id; k > 0; k = model.parents[k])
+      {
+        J.middleCols(model.joints[k].idx_v(),model.joints[k].nv()).noalias()
+        = iMk.toActionMatrix() * data.joints[k].S().matrix();
+        iMk = iMk * data.liMi[k].inverse();
+      }
+      
+      // Update of the upper triangular part of M
+      const Matrix6 dI = inertia_after.matrix() - inertia_before.matrix();
+      for(size_t b = 0; b < rows.size(); ++b)
+      {
+        const typename Data::Force::Vector6 dIJ_b = dI * J.col(rows[b]);
+        for(size_t a = 0; a <= b; ++a)
+          data.M(rows[a],rows[b]) += J.col(rows[a]).dot(dIJ_b);
+      }
+      
+      // Update of the factors: the updates are performed before the downdates.
+      internal::inertiaUpdate(data,rows,Scalar(1),inertia_after,J);
+      internal::inertiaUpdate(data,rows,Scalar(-1),inertia_before,J);
+    }
+    
     namespace internal
     {
       template<typename Mat, int ColsAtCompileTime = Mat::ColsAtCompileTime>
@@ -69,6 +191,8 @@ namespace pinocchio
                         const DataTpl<Scalar,Options,JointCollectionTpl> & data,
                         const Eigen::MatrixBase<Mat> & m)
         {
+          // The rows of U v do not depend on each other: the per-column dot products
+          // are faster than a block product, contrary to the triangular solves.
           Mat & m_ = PINOCCHIO_EIGEN_CONST_CAST(Mat,m);
           for(int k = 0; k < m_.cols(); ++k)
             cholesky::Uv(model,data,m_.col(k));
@@ -124,9 +248,18 @@ namespace pinocchio
                         const DataTpl<Scalar,Options,JointCollectionTpl> & data,
                         const Eigen::MatrixBase<Mat> & m)
         {
+          typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+          
+          assert(model.check(data) && "data is not consistent with model.");
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(m.rows(), model.nv);
+          
           Mat & m_ = PINOCCHIO_EIGEN_CONST_CAST(Mat,m);
-          for(int k = 0; k < m_.cols(); ++k)
-            cholesky::Utv(model,data,m_.col(k));
+          
+          const typename Data::MatrixXs & U = data.U;
+          const std::vector<int> & nvt = data.nvSubtree_fromRow;
+          
+          for( int k=model.nv-2;k>=0;--k ) // You can start from nv-2 (no child in nv-1)
+            m_.middleRows(k+1,nvt[(size_t)k]-1).noalias() += U.row(k).segment(k+1,nvt[(size_t)k]-1).transpose()*m_.row(k);
         }
       };
       
@@ -178,9 +311,20 @@ namespace pinocchio
                         const DataTpl<Scalar,Options,JointCollectionTpl> & data,
                         const Eigen::MatrixBase<Mat> & m)
         {
+          typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+          
+          assert(model.check(data) && "data is not consistent with model.");
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(m.rows(), model.nv);
+          
           Mat & m_ = PINOCCHIO_EIGEN_CONST_CAST(Mat,m);
-          for(int k = 0; k < m_.cols(); ++k)
-            cholesky::Uiv(model,data,m_.col(k));
+          
+          const typename Data::MatrixXs & U = data.U;
+          const std::vector<int> & nvt = data.nvSubtree_fromRow;
+          
+          // The tree structure is walked once for all the columns:
+          // each row of U is applied to the whole block of right-hand sides.
+          for(int k=model.nv-2;k>=0;--k) // You can start from nv-2 (no child in nv-1)
+            m_.row(k).noalias() -= U.row(k).segment(k+1,nvt[(size_t)k]-1) * m_.middleRows(k+1,nvt[(size_t)k]-1);
         }
       };
       
@@ -232,9 +376,18 @@ namespace pinocchio
                         const DataTpl<Scalar,Options,JointCollectionTpl> & data,
                         const Eigen::MatrixBase<Mat> & m)
         {
+          typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+          
+          assert(model.check(data) && "data is not consistent with model.");
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(m.rows(), model.nv);
+          
           Mat & m_ = PINOCCHIO_EIGEN_CONST_CAST(Mat,m);
-          for(int k = 0; k < m_.cols(); ++k)
-            cholesky::Utiv(model,data,m_.col(k));
+          
+          const typename Data::MatrixXs & U = data.U;
+          const std::vector<int> & nvt = data.nvSubtree_fromRow;
+          
+          for(int k=0; k<model.nv-1; ++k) // You can stop one step before nv.
+            m_.middleRows(k+1,nvt[(size_t)k]-1).noalias() -= U.row(k).segment(k+1,nvt[(size_t)k]-1).transpose() * m_.row(k);
         }
       };
       
@@ -357,8 +510,10 @@ namespace pinocchio
                         const Eigen::MatrixBase<Mat> & m)
         {
           Mat & m_ = PINOCCHIO_EIGEN_CONST_CAST(Mat,m);
-          for(int k = 0; k < m_.cols(); ++k)
-            cholesky::UDUtv(model,data,m_.col(k));
+          
+          cholesky::Utv(model,data,m_);
+          m_ = data.D.asDiagonal() * m_;
+          cholesky::Uv(model,data,m_);
         }
       };
       
@@ -407,8 +562,10 @@ namespace pinocchio
                         const Eigen::MatrixBase<Mat> & m)
         {
           Mat & m_ = PINOCCHIO_EIGEN_CONST_CAST(Mat,m);
-          for(int k = 0; k < m_.cols(); ++k)
-            cholesky::solve(model,data,m_.col(k));
+          
+          cholesky::Uiv(model,data,m_);
+          m_ = data.Dinv.asDiagonal() * m_;
+          cholesky::Utiv(model,data,m_);
         }
       };
       
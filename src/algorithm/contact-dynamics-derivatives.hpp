@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_contact_dynamics_derivatives_hpp__
+#define __pinocchio_contact_dynamics_derivatives_hpp__
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+#include "pinocchio/algorithm/contact-dynamics.hpp"
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Computes the partial derivatives of the contact dynamics (see pinocchio::forwardDynamics)
+  ///        with respect to the joint configuration, the joint velocity and the joint torque vector.
+  ///        The contacts are 6D contacts attached to the joint frames listed in contact_ids: the constraint Jacobian J
+  ///        is the stack of the joint Jacobians expressed in the LOCAL frame (see pinocchio::getJointJacobian)
+  ///        and the drift gamma is the corresponding stack of the joint spatial accelerations for a zero joint acceleration,
+  ///        so that the contact spatial accelerations vanish.
+  ///
+  /// \note The derivatives are obtained by differentiating the KKT conditions of the contact dynamics:
+  ///       the partial derivatives of the generalized torques given by pinocchio::computeRNEADerivatives (with the contact forces as external forces)
+  ///       and of the contact accelerations are propagated through the inverse of the KKT matrix, built from the factorizations
+  ///       of M (data.U, data.D) and of \f$ J M^{-1} J^{T} \f$ (data.llt_JMinvJt) already computed by pinocchio::forwardDynamics.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorType Type of the joint configuration vector.
+  /// \tparam TangentVectorType Type of the joint velocity vector.
+  /// \tparam MatrixType1 Type of the matrix containing the partial derivative of the joint acceleration with respect to the joint configuration.
+  /// \tparam MatrixType2 Type of the matrix containing the partial derivative of the joint acceleration with respect to the joint velocity.
+  /// \tparam MatrixType3 Type of the matrix containing the partial derivative of the joint acceleration with respect to the joint torque.
+  /// \tparam MatrixType4 Type of the matrix containing the partial derivative of the contact forces with respect to the joint configuration.
+  /// \tparam MatrixType5 Type of the matrix containing the partial derivative of the contact forces with respect to the joint velocity.
+  /// \tparam MatrixType6 Type of the matrix containing the partial derivative of the contact forces with respect to the joint torque.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] q The joint configuration vector (dim model.nq).
+  /// \param[in] v The joint velocity vector (dim model.nv).
+  /// \param[in] contact_ids Indexes of the joints in contact (nc = 6*contact_ids.size() constraints).
+  /// \param[out] ddq_partial_dq Partial derivative of the joint acceleration with respect to the joint configuration (dim model.nv x model.nv).
+  /// \param[out] ddq_partial_dv Partial derivative of the joint acceleration with respect to the joint velocity (dim model.nv x model.nv).
+  /// \param[out] ddq_partial_dtau Partial derivative of the joint acceleration with respect to the joint torque (dim model.nv x model.nv).
+  /// \param[out] lambda_partial_dq Partial derivative of the contact forces with respect to the joint configuration (dim nc x model.nv).
+  /// \param[out] lambda_partial_dv Partial derivative of the contact forces with respect to the joint velocity (dim nc x model.nv).
+  /// \param[out] lambda_partial_dtau Partial derivative of the contact forces with respect to the joint torque (dim nc x model.nv).
+  ///
+  /// \remarks pinocchio::forwardDynamics must have been called first with the same q, v and contacts.
+  ///          A factorization computed for another configuration or other contacts raises an std::invalid_argument.
+  ///          The quantities computed by pinocchio::computeRNEADerivatives are also available in data (data.dtau_dq, data.dtau_dv).
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType,
+  typename MatrixType1, typename MatrixType2, typename MatrixType3, typename MatrixType4, typename MatrixType5, typename MatrixType6>
+  inline void
+  computeContactDynamicsDerivatives(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const Eigen::MatrixBase<ConfigVectorType> & q,
+                                    const Eigen::MatrixBase<TangentVectorType> & v,
+                                    const typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector & contact_ids,
+                                    const Eigen::MatrixBase<MatrixType1> & ddq_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType2> & ddq_partial_dv,
+                                    const Eigen::MatrixBase<MatrixType3> & ddq_partial_dtau,
+                                    const Eigen::MatrixBase<MatrixType4> & lambda_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType5> & lambda_partial_dv,
+                                    const Eigen::MatrixBase<MatrixType6> & lambda_partial_dtau);
+
+  ///
+  /// \brief Computes the partial derivatives of the impulse dynamics (see pinocchio::impulseDynamics)
+  ///        with respect to the joint configuration and the joint velocity before the impact.
+  ///        The contacts are 6D contacts attached to the joint frames listed in contact_ids: the constraint Jacobian J
+  ///        is the stack of the joint Jacobians expressed in the LOCAL frame (see pinocchio::getJointJacobian).
+  ///
+  /// \note The derivatives are obtained by differentiating the impact conditions \f$ M (\dot{q}^{+} - \dot{q}^{-}) = J^{T} \Lambda \f$
+  ///       and \f$ J \dot{q}^{+} = -e J \dot{q}^{-} \f$, reusing pinocchio::computeRNEADerivatives, the kinematics derivatives
+  ///       and the factorizations already computed by pinocchio::impulseDynamics.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorType Type of the joint configuration vector.
+  /// \tparam TangentVectorType Type of the joint velocity vector.
+  /// \tparam MatrixType1 Type of the matrix containing the partial derivative of the velocity after impact with respect to the joint configuration.
+  /// \tparam MatrixType2 Type of the matrix containing the partial derivative of the velocity after impact with respect to the velocity before impact.
+  /// \tparam MatrixType3 Type of the matrix containing the partial derivative of the contact impulses with respect to the joint configuration.
+  /// \tparam MatrixType4 Type of the matrix containing the partial derivative of the contact impulses with respect to the velocity before impact.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] q The joint configuration vector (dim model.nq).
+  /// \param[in] v_before The joint velocity before impact (dim model.nv).
+  /// \param[in] contact_ids Indexes of the joints in contact (nc = 6*contact_ids.size() constraints).
+  /// \param[in] r_coeff The coefficient of restitution. Must be in [0;1].
+  /// \param[out] dq_after_partial_dq Partial derivative of the velocity after impact with respect to the joint configuration (dim model.nv x model.nv).
+  /// \param[out] dq_after_partial_dv Partial derivative of the velocity after impact with respect to the velocity before impact (dim model.nv x model.nv).
+  /// \param[out] impulse_partial_dq Partial derivative of the contact impulses with respect to the joint configuration (dim nc x model.nv).
+  /// \param[out] impulse_partial_dv Partial derivative of the contact impulses with respect to the velocity before impact (dim nc x model.nv).
+  ///
+  /// \remarks pinocchio::impulseDynamics must have been called first with the same q, v_before, contacts and r_coeff.
+  ///          A factorization computed for another configuration or other contacts raises an std::invalid_argument.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType,
+  typename MatrixType1, typename MatrixType2, typename MatrixType3, typename MatrixType4>
+  inline void
+  computeImpulseDynamicsDerivatives(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const Eigen::MatrixBase<ConfigVectorType> & q,
+                                    const Eigen::MatrixBase<TangentVectorType> & v_before,
+                                    const typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector & contact_ids,
+                                    const Scalar r_coeff,
+                                    const Eigen::MatrixBase<MatrixType1> & dq_after_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType2> & dq_after_partial_dv,
+                                    const Eigen::MatrixBase<MatrixType3> & impulse_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType4> & impulse_partial_dv);
+
+} // namespace pinocchio
+
+#include "pinocchio/algorithm/contact-dynamics-derivatives.hxx"
+
+#endif // ifndef __pinocchio_contact_dynamics_derivatives_hpp__
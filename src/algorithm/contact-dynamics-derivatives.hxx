@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_contact_dynamics_derivatives_hxx__
+#define __pinocchio_contact_dynamics_derivatives_hxx__
+
+#include "pinocchio/algorithm/cholesky.hpp"
+#include "pinocchio/algorithm/rnea-derivatives.hpp"
+#include "pinocchio/algorithm/kinematics-derivatives.hpp"
+#include "pinocchio/algorithm/check.hpp"
+
+namespace pinocchio
+{
+
+  namespace details
+  {
+    ///
+    /// \brief Computes \f$ M^{-1} J^{\top} = U^{-\top} \sqrt{D^{-1}} \f$ data.sDUiJt from the factorizations of the last
+    ///        forwardDynamics/impulseDynamics, after checking that they have been computed for the constraint Jacobian J.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConstraintMatrixType, typename MatrixType>
+    void computeMinvJtFromFactorization(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                        const DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                        const Eigen::MatrixBase<ConstraintMatrixType> & J,
+                                        const Eigen::MatrixBase<MatrixType> & MinvJt)
+    {
+      const Eigen::DenseIndex nc = J.rows();
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(data.llt_JMinvJt.cols() == nc && data.sDUiJt.cols() == nc && data.sDUiJt.rows() == model.nv,
+                                     "The factorizations do not match the contacts: forwardDynamics/impulseDynamics must be called first.");
+      
+      MatrixType & MinvJt_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType,MinvJt);
+      
+      // The factorizations must come from the current configuration and contacts: check that U sqrt(D) data.sDUiJt = J^T.
+      MinvJt_ = data.D.cwiseSqrt().asDiagonal() * data.sDUiJt;
+      cholesky::Uv(model,data,MinvJt_);
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(MinvJt_.isApprox(J.transpose(),math::sqrt(Eigen::NumTraits<Scalar>::epsilon())),
+                                     "The factorizations are stale: forwardDynamics/impulseDynamics must be called with the current configuration and contacts.");
+      
+      MinvJt_ = data.D.cwiseSqrt().cwiseInverse().asDiagonal() * data.sDUiJt;
+      cholesky::Utiv(model,data,MinvJt_);
+    }
+  } // namespace details
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType,
+  typename MatrixType1, typename MatrixType2, typename MatrixType3, typename MatrixType4, typename MatrixType5, typename MatrixType6>
+  inline void
+  computeContactDynamicsDerivatives(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const Eigen::MatrixBase<ConfigVectorType> & q,
+                                    const Eigen::MatrixBase<TangentVectorType> & v,
+                                    const typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector & contact_ids,
+                                    const Eigen::MatrixBase<MatrixType1> & ddq_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType2> & ddq_partial_dv,
+                                    const Eigen::MatrixBase<MatrixType3> & ddq_partial_dtau,
+                                    const Eigen::MatrixBase<MatrixType4> & lambda_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType5> & lambda_partial_dv,
+                                    const Eigen::MatrixBase<MatrixType6> & lambda_partial_dtau)
+  {
+    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+    typedef typename Data::Force Force;
+
+    const Eigen::DenseIndex nc = 6*(Eigen::DenseIndex)contact_ids.size();
+
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(), model.nq, "The joint configuration vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(v.size(), model.nv, "The joint velocity vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(data.lambda_c.size(), nc, "The contact forces do not match the contacts, forwardDynamics must be called first");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(ddq_partial_dq.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(ddq_partial_dq.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(ddq_partial_dv.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(ddq_partial_dv.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(ddq_partial_dtau.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(ddq_partial_dtau.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(lambda_partial_dq.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(lambda_partial_dq.rows(), nc);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(lambda_partial_dv.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(lambda_partial_dv.rows(), nc);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(lambda_partial_dtau.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(lambda_partial_dtau.rows(), nc);
+    assert(model.check(data) && "data is not consistent with model.");
+
+    MatrixType1 & ddq_partial_dq_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType1,ddq_partial_dq);
+    MatrixType2 & ddq_partial_dv_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType2,ddq_partial_dv);
+    MatrixType3 & Minv = PINOCCHIO_EIGEN_CONST_CAST(MatrixType3,ddq_partial_dtau);
+    MatrixType4 & lambda_partial_dq_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType4,lambda_partial_dq);
+    MatrixType5 & lambda_partial_dv_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType5,lambda_partial_dv);
+    MatrixType6 & JMinv = PINOCCHIO_EIGEN_CONST_CAST(MatrixType6,lambda_partial_dtau);
+
+    // Partial derivatives of the generalized torques, the contact forces acting as external forces.
+    container::aligned_vector<Force> fext((size_t)model.njoints,Force::Zero());
+    for(size_t k = 0; k < contact_ids.size(); ++k)
+      fext[contact_ids[k]] += Force(data.lambda_c.template segment<6>(6*(Eigen::DenseIndex)k));
+    computeRNEADerivatives(model,data,q.derived(),v.derived(),data.ddq,fext);
+
+    // Partial derivatives of the contact accelerations, stored in the rows of the output matrices.
+    // The partial derivatives with respect to the joint acceleration are the contact Jacobian.
+    typename Data::Matrix6x v_partial_dq(6,model.nv);
+    for(size_t k = 0; k < contact_ids.size(); ++k)
+    {
+      const Eigen::DenseIndex row_id = 6*(Eigen::DenseIndex)k;
+      v_partial_dq.setZero();
+      lambda_partial_dq_.template middleRows<6>(row_id).setZero();
+      lambda_partial_dv_.template middleRows<6>(row_id).setZero();
+      JMinv.template middleRows<6>(row_id).setZero();
+      getJointAccelerationDerivatives(model,data,contact_ids[k],LOCAL,v_partial_dq,
+                                      lambda_partial_dq_.template middleRows<6>(row_id),
+                                      lambda_partial_dv_.template middleRows<6>(row_id),
+                                      JMinv.template middleRows<6>(row_id));
+    }
+
+    // Minv J^T, from the factorizations of forwardDynamics.
+    typename Data::MatrixXs MinvJt(model.nv,nc);
+    details::computeMinvJtFromFactorization(model,data,JMinv,MinvJt);
+
+    // dlambda = (J Minv J^T)^-1 (J Minv dtau - da)
+    lambda_partial_dq_ *= Scalar(-1);
+    lambda_partial_dq_.noalias() += MinvJt.transpose() * data.dtau_dq;
+    data.llt_JMinvJt.solveInPlace(lambda_partial_dq_);
+
+    lambda_partial_dv_ *= Scalar(-1);
+    lambda_partial_dv_.noalias() += MinvJt.transpose() * data.dtau_dv;
+    data.llt_JMinvJt.solveInPlace(lambda_partial_dv_);
+
+    // dddq = Minv (J^T dlambda - dtau)
+    ddq_partial_dq_.noalias() = JMinv.transpose() * lambda_partial_dq_;
+    ddq_partial_dq_ -= data.dtau_dq;
+    cholesky::solve(model,data,ddq_partial_dq_);
+
+    ddq_partial_dv_.noalias() = JMinv.transpose() * lambda_partial_dv_;
+    ddq_partial_dv_ -= data.dtau_dv;
+    cholesky::solve(model,data,ddq_partial_dv_);
+
+    cholesky::computeMinv(model,data,Minv);
+    JMinv = MinvJt.transpose();
+
+    // dddq_dtau = Minv - Minv J^T (J Minv J^T)^-1 J Minv and dlambda_dtau = -(J Minv J^T)^-1 J Minv
+    data.llt_JMinvJt.matrixL().solveInPlace(JMinv);
+    Minv.noalias() -= JMinv.transpose() * JMinv;
+    data.llt_JMinvJt.matrixU().solveInPlace(JMinv);
+    JMinv *= Scalar(-1);
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType,
+  typename MatrixType1, typename MatrixType2, typename MatrixType3, typename MatrixType4>
+  inline void
+  computeImpulseDynamicsDerivatives(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const Eigen::MatrixBase<ConfigVectorType> & q,
+                                    const Eigen::MatrixBase<TangentVectorType> & v_before,
+                                    const typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector & contact_ids,
+                                    const Scalar r_coeff,
+                                    const Eigen::MatrixBase<MatrixType1> & dq_after_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType2> & dq_after_partial_dv,
+                                    const Eigen::MatrixBase<MatrixType3> & impulse_partial_dq,
+                                    const Eigen::MatrixBase<MatrixType4> & impulse_partial_dv)
+  {
+    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+    typedef typename Data::Force Force;
+    typedef typename Data::TangentVectorType TangentVector;
+
+    const Eigen::DenseIndex nc = 6*(Eigen::DenseIndex)contact_ids.size();
+
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(), model.nq, "The joint configuration vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(v_before.size(), model.nv, "The joint velocity vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(data.impulse_c.size(), nc, "The contact impulses do not match the contacts, impulseDynamics must be called first");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(dq_after_partial_dq.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(dq_after_partial_dq.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(dq_after_partial_dv.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(dq_after_partial_dv.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(impulse_partial_dq.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(impulse_partial_dq.rows(), nc);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(impulse_partial_dv.cols(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(impulse_partial_dv.rows(), nc);
+    assert(model.check(data) && "data is not consistent with model.");
+
+    MatrixType1 & dq_after_partial_dq_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType1,dq_after_partial_dq);
+    MatrixType2 & dq_after_partial_dv_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType2,dq_after_partial_dv);
+    MatrixType3 & impulse_partial_dq_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixType3,impulse_partial_dq);
+    MatrixType4 & J = PINOCCHIO_EIGEN_CONST_CAST(MatrixType4,impulse_partial_dv);
+
+    // Partial derivatives of the contact velocity constraint J (dq_after + r_coeff * v_before) = 0,
+    // stored in the rows of the output matrices. The partial derivatives with respect to the velocity are the contact Jacobian.
+    const TangentVector v_constraint = data.dq_after + r_coeff * v_before;
+    computeForwardKinematicsDerivatives(model,data,q.derived(),v_constraint,TangentVector::Zero(model.nv));
+    for(size_t k = 0; k < contact_ids.size(); ++k)
+    {
+      const Eigen::DenseIndex row_id = 6*(Eigen::DenseIndex)k;
+      impulse_partial_dq_.template middleRows<6>(row_id).setZero();
+      J.template middleRows<6>(row_id).setZero();
+      getJointVelocityDerivatives(model,data,contact_ids[k],LOCAL,
+                                  impulse_partial_dq_.template middleRows<6>(row_id),
+                                  J.template middleRows<6>(row_id));
+    }
+
+    // Partial derivatives of the impulse balance M (dq_after - v_before) - J^T impulse = 0,
+    // i.e. of the RNEA with zero velocity minus the generalized gravity.
+    container::aligned_vector<Force> fext((size_t)model.njoints,Force::Zero());
+    for(size_t k = 0; k < contact_ids.size(); ++k)
+      fext[contact_ids[k]] += Force(data.impulse_c.template segment<6>(6*(Eigen::DenseIndex)k));
+
+    dq_after_partial_dv_.setZero();
+    computeGeneralizedGravityDerivatives(model,data,q.derived(),dq_after_partial_dv_);
+    computeRNEADerivatives(model,data,q.derived(),TangentVector::Zero(model.nv),
+                           TangentVector(data.dq_after - v_before),fext);
+    dq_after_partial_dq_ = data.dtau_dq - dq_after_partial_dv_;
+
+    // Minv J^T, from the factorizations of impulseDynamics.
+    typename Data::MatrixXs MinvJt(model.nv,nc);
+    details::computeMinvJtFromFactorization(model,data,J,MinvJt);
+
+    // dimpulse = (J Minv J^T)^-1 (J Minv dtau - dv_constraint) and ddq_after = Minv (J^T dimpulse - dtau)
+    impulse_partial_dq_ *= Scalar(-1);
+    impulse_partial_dq_.noalias() += MinvJt.transpose() * dq_after_partial_dq_;
+    data.llt_JMinvJt.solveInPlace(impulse_partial_dq_);
+
+    dq_after_partial_dq_ *= Scalar(-1);
+    dq_after_partial_dq_.noalias() += J.transpose() * impulse_partial_dq_;
+    cholesky::solve(model,data,dq_after_partial_dq_);
+
+    // dimpulse_dv = -(1 + r_coeff) (J Minv J^T)^-1 J and ddq_after_dv = Id + Minv J^T dimpulse_dv
+    J *= -(Scalar(1) + r_coeff);
+    data.llt_JMinvJt.solveInPlace(J);
+    dq_after_partial_dv_.setIdentity();
+    dq_after_partial_dv_.noalias() += MinvJt * J;
+  }
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_contact_dynamics_derivatives_hxx__
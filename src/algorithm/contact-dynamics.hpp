@@ -7,6 +7,7 @@
 
 #include "pinocchio/multibody/model.hpp"
 #include "pinocchio/multibody/data.hpp"
+#include "pinocchio/algorithm/branch-sparse-jacobian.hpp"
 
 namespace pinocchio
 {
@@ -90,6 +91,60 @@ namespace pinocchio
                   const Eigen::MatrixBase<DriftVectorType> & gamma,
                   const Scalar inv_damping = 0.);
 
+  ///
+  /// \brief Compute the forward dynamics with contact constraints given by a branch sparse Jacobian,
+  ///        assuming pinocchio::computeAllTerms has been called.
+  ///        The Delassus matrix \f$ J M^{-1} J^{\top} \f$ is built with \ref computeJMinvJt, which exploits the kinematic tree sparsity
+  ///        (e.g. contacts on different limbs only share the degrees of freedom of the base), and is stored in data.JMinvJt.
+  ///        It is then factorized in data.llt_JMinvJt. As for the dense version, data.sDUiJt is filled.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam TangentVectorType Type of the joint torque vector.
+  /// \tparam DriftVectorType Type of the drift vector.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] tau The joint torque vector (dim model.nv).
+  /// \param[in] J The branch sparse Jacobian of the constraints (dim nb_constraints*model.nv). Its workspace is updated.
+  /// \param[in] gamma The drift of the constraints (dim nb_constraints).
+  /// \param[in] inv_damping Damping factor for Cholesky decomposition of JMinvJt. Set to zero if constraints are full rank.
+  ///
+  /// \return A reference to the joint acceleration stored in data.ddq. The Lagrange Multipliers linked to the contact forces are available throw data.lambda_c vector.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename TangentVectorType, typename DriftVectorType>
+  inline const typename DataTpl<Scalar,Options,JointCollectionTpl>::TangentVectorType &
+  forwardDynamics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                  DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                  const Eigen::MatrixBase<TangentVectorType> & tau,
+                  BranchSparseJacobianTpl<Scalar,Options> & J,
+                  const Eigen::MatrixBase<DriftVectorType> & gamma,
+                  const Scalar inv_damping = 0.);
+
+  ///
+  /// \brief Same as forwardDynamics(model,data,tau,J,gamma,inv_damping) with a branch sparse Jacobian,
+  ///        but the Delassus matrix is factorized with the block-sparse factorization llt instead of data.llt_JMinvJt.
+  ///        data.llt_JMinvJt is reset: the functions relying on it (e.g. getKKTContactDynamicMatrixInverse) then throw.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] tau The joint torque vector (dim model.nv).
+  /// \param[in] J The branch sparse Jacobian of the constraints (dim nb_constraints*model.nv). Its workspace is updated.
+  /// \param[in] gamma The drift of the constraints (dim nb_constraints).
+  /// \param[out] llt The block-sparse factorization of the Delassus matrix.
+  /// \param[in] inv_damping Damping factor for Cholesky decomposition of JMinvJt. Set to zero if constraints are full rank.
+  ///
+  /// \return A reference to the joint acceleration stored in data.ddq. The Lagrange Multipliers linked to the contact forces are available throw data.lambda_c vector.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename TangentVectorType, typename DriftVectorType>
+  inline const typename DataTpl<Scalar,Options,JointCollectionTpl>::TangentVectorType &
+  forwardDynamics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                  DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                  const Eigen::MatrixBase<TangentVectorType> & tau,
+                  BranchSparseJacobianTpl<Scalar,Options> & J,
+                  const Eigen::MatrixBase<DriftVectorType> & gamma,
+                  BlockSparseLLTTpl<Scalar,Options> & llt,
+                  const Scalar inv_damping = 0.);
+
   ///
   /// \brief Compute the forward dynamics with contact constraints.
   ///
@@ -86,6 +86,117 @@ namespace pinocchio
     return forwardDynamics(model,data,tau,J,gamma,inv_damping);
   }
 
+  namespace details
+  {
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename TangentVectorType,
+             typename DriftVectorType, typename LLTType>
+    inline const typename DataTpl<Scalar,Options,JointCollectionTpl>::TangentVectorType &
+    forwardDynamics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                    const Eigen::MatrixBase<TangentVectorType> & tau,
+                    BranchSparseJacobianTpl<Scalar,Options> & J,
+                    const Eigen::MatrixBase<DriftVectorType> & gamma,
+                    LLTType & llt,
+                    const Scalar inv_damping)
+    {
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(tau.size(), model.nv);
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(J.cols(), model.nv);
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(J.rows(), gamma.size());
+      assert(model.check(data) && "data is not consistent with model.");
+      
+      typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+      
+      typename Data::TangentVectorType & a = data.ddq;
+      typename Data::VectorXs & lambda_c = data.lambda_c;
+      
+      // Compute the UDUt decomposition of data.M
+      cholesky::decompose(model, data);
+      
+      // Compute the dynamic drift (control - nle)
+      data.torque_residual = tau - data.nle;
+      cholesky::solve(model, data, data.torque_residual);
+      
+      data.JMinvJt.resize(J.rows(),J.rows());
+      computeJMinvJt(model, data, J, data.JMinvJt);
+      
+      // Scatter the blocks of J.sDUiJt, which keep the support of the Jacobian blocks,
+      // so that data.sDUiJt matches the one of the dense version of the algorithm.
+      data.sDUiJt.setZero(model.nv,J.rows());
+      for(size_t block_id = 0; block_id < J.size(); ++block_id)
+      {
+        const typename Data::MatrixXs & sDUiJt = J.sDUiJt[block_id];
+        const typename BranchSparseJacobianTpl<Scalar,Options>::IndexVector & support = J.support(block_id);
+        for(size_t k = 0; k < support.size(); ++k)
+          data.sDUiJt.row((Eigen::DenseIndex)support[k]).segment(J.rowOffset(block_id),sDUiJt.cols()) = sDUiJt.row((Eigen::DenseIndex)k);
+      }
+      
+      data.JMinvJt.diagonal().array() += inv_damping;
+      llt.compute(data.JMinvJt);
+      
+      // Compute the Lagrange Multipliers
+      lambda_c.resize(J.rows());
+      jacobianProduct(J, data.torque_residual, lambda_c);
+      lambda_c = -lambda_c - gamma;
+      llt.solveInPlace(lambda_c);
+      
+      // Compute the joint acceleration
+      jacobianTransposeProduct(J, lambda_c, a);
+      cholesky::solve(model, data, a);
+      a += data.torque_residual;
+      
+      return a;
+    }
+    
+    template<typename Scalar, int Options>
+    struct BlockSparseLLTWrapper
+    {
+      BlockSparseLLTWrapper(BlockSparseLLTTpl<Scalar,Options> & llt,
+                            const BranchSparseJacobianTpl<Scalar,Options> & J)
+      : llt(llt), J(J)
+      {}
+      
+      template<typename MatrixLike>
+      void compute(const Eigen::MatrixBase<MatrixLike> & mat) { llt.compute(J,mat); }
+      
+      template<typename VectorLike>
+      void solveInPlace(const Eigen::MatrixBase<VectorLike> & x) const { llt.solveInPlace(x); }
+      
+      BlockSparseLLTTpl<Scalar,Options> & llt;
+      const BranchSparseJacobianTpl<Scalar,Options> & J;
+    };
+  } // namespace details
+  
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename TangentVectorType, typename DriftVectorType>
+  inline const typename DataTpl<Scalar,Options,JointCollectionTpl>::TangentVectorType &
+  forwardDynamics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                  DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                  const Eigen::MatrixBase<TangentVectorType> & tau,
+                  BranchSparseJacobianTpl<Scalar,Options> & J,
+                  const Eigen::MatrixBase<DriftVectorType> & gamma,
+                  const Scalar inv_damping)
+  {
+    return details::forwardDynamics(model,data,tau,J,gamma,data.llt_JMinvJt,inv_damping);
+  }
+  
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename TangentVectorType, typename DriftVectorType>
+  inline const typename DataTpl<Scalar,Options,JointCollectionTpl>::TangentVectorType &
+  forwardDynamics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                  DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                  const Eigen::MatrixBase<TangentVectorType> & tau,
+                  BranchSparseJacobianTpl<Scalar,Options> & J,
+                  const Eigen::MatrixBase<DriftVectorType> & gamma,
+                  BlockSparseLLTTpl<Scalar,Options> & llt,
+                  const Scalar inv_damping)
+  {
+    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+    
+    // data.llt_JMinvJt is not computed: reset it so that the functions relying on it reject the current data.
+    data.llt_JMinvJt = Eigen::LLT<typename Data::MatrixXs>();
+    
+    details::BlockSparseLLTWrapper<Scalar,Options> llt_wrapper(llt,J);
+    return details::forwardDynamics(model,data,tau,J,gamma,llt_wrapper,inv_damping);
+  }
+
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl,
            typename ConfigVectorType, typename ConstraintMatrixType, typename KKTMatrixType>
   void computeKKTContactDynamicMatrixInverse(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
@@ -132,6 +243,9 @@ namespace pinocchio
     
     typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
     const Eigen::DenseIndex nc = data.JMinvJt.cols();
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(J.rows(), nc);
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(data.llt_JMinvJt.cols() == nc,
+                                   "data.llt_JMinvJt does not factorize data.JMinvJt: the Delassus matrix must be factorized in data.llt_JMinvJt first.");
     
     KKTMatrixType & KKTMatrix_inv_ = PINOCCHIO_EIGEN_CONST_CAST(KKTMatrixType,KKTMatrix_inv);
     
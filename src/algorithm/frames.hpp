@@ -25,6 +25,23 @@ namespace pinocchio
   inline void updateFramePlacements(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
                                     DataTpl<Scalar,Options,JointCollectionTpl> & data);
 
+  /**
+   * @brief      Updates the position of the frames attached to the subtrees of the joints joint_ids.
+   *             The placements of the other frames are left untouched.
+   *
+   * @tparam JointCollection Collection of Joint types.
+   *
+   * @param[in]  model      The kinematic model.
+   * @param      data       Data associated to model.
+   * @param[in]  joint_ids  The indexes of the joints whose configuration has changed.
+   *
+   * @warning    updateFramePlacements and updateForwardKinematics(model,data,q,joint_ids) should have been called first.
+   */
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline void updateFramePlacements(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const std::vector<JointIndex> & joint_ids);
+
   /**
    * @brief      Updates the placement of the given frame.
    *
@@ -33,6 +33,28 @@ namespace pinocchio
     }
   }
   
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline void updateFramePlacements(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const std::vector<JointIndex> & joint_ids)
+  {
+    assert(model.check(data) && "data is not consistent with model.");
+    
+    typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+    typedef typename Model::Frame Frame;
+    typedef typename Model::FrameIndex FrameIndex;
+    
+    std::vector<bool> is_affected;
+    details::markSubtrees(model,joint_ids,is_affected);
+    
+    for(FrameIndex i=1; i < (FrameIndex) model.nframes; ++i)
+    {
+      const Frame & frame = model.frames[i];
+      if(is_affected[frame.parent])
+        data.oMf[i] = data.oMi[frame.parent]*frame.placement;
+    }
+  }
+  
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
   inline const typename DataTpl<Scalar,Options,JointCollectionTpl>::SE3 &
   updateFramePlacement(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
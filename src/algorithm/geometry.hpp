@@ -50,6 +50,27 @@ namespace pinocchio
                                        const GeometryModel & geom_model,
                                        GeometryData & geom_data);
 
+  ///
+  /// \brief Update the placement of the geometry objects attached to the subtrees of the joints joint_ids.
+  ///        The placements of the other geometry objects are left untouched.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] geom_model The geometry model containing the collision objects.
+  /// \param[out] geom_data The geometry data containing the placements of the collision objects. See oMg field in GeometryData.
+  /// \param[in] joint_ids The indexes of the joints whose configuration has changed.
+  ///
+  /// \warning updateGeometryPlacements and updateForwardKinematics(model,data,q,joint_ids) should have been called first.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline void updateGeometryPlacements(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                       const DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                       const GeometryModel & geom_model,
+                                       GeometryData & geom_data,
+                                       const std::vector<JointIndex> & joint_ids);
+
   ///
   /// \brief     Set a mesh scaling vector to each GeometryObject contained in the the GeometryModel.
   ///
@@ -84,6 +105,21 @@ namespace pinocchio
 
 #ifdef PINOCCHIO_WITH_HPP_FCL
 
+  ///
+  /// \brief Compute a lower bound of the distance between the two geometries of a *SINGLE* collision pair,
+  ///        using their bounding spheres (broad phase).
+  ///        This function assumes that \ref updateGeometryPlacements has been called first with geom_data.enableBroadPhase set to true.
+  ///
+  /// \param[in] geom_model the geometry model (const)
+  /// \param[in] geom_data the corresponding geometry data, containing the bounding sphere centers.
+  /// \param[in] pairId The collision pair index in the GeometryModel.
+  ///
+  /// \return The distance between the two bounding spheres, which is negative when they intersect.
+  ///
+  inline double computeBroadPhaseDistance(const GeometryModel & geom_model,
+                                          const GeometryData & geom_data,
+                                          const PairIndex & pairId);
+
   ///
   /// \brief Compute the collision status between a *SINGLE* collision pair.
   /// The result is store in the collisionResults vector.
@@ -109,6 +145,9 @@ namespace pinocchio
   ///
   /// \warning if stopAtFirstcollision = true, then the collisions vector will
   /// not be entirely fulfilled (of course).
+  /// \note If geom_data.enableBroadPhase is true, the pairs whose bounding spheres are separated by more than the
+  /// security margin of their collision request are not tested by FCL: their collision result is cleared and
+  /// they are counted in geom_data.nculledPairs.
   ///
   inline bool computeCollisions(const GeometryModel & geom_model,
                                 GeometryData & geom_data,
@@ -155,6 +194,22 @@ namespace pinocchio
                                         GeometryData & geom_data,
                                         const PairIndex & pairId);
   
+  ///
+  /// \brief Calls computeDistance for every active pairs of GeometryData.
+  /// This function assumes that \ref updateGeometryPlacements has been called first.
+  ///
+  /// \param[in] geom_model: geometry model (const)
+  /// \param[out] geom_data: corresponding geometry data (nonconst) where distances are computed
+  ///
+  /// \return The index of the collision pair with the minimal distance.
+  ///
+  /// \note If geom_data.enableBroadPhase is true, the pairs whose bounding spheres are farther than the current
+  /// minimal distance are not tested by FCL: their distance result is cleared and they are counted in geom_data.nculledPairs.
+  /// In this case, only the distance result of the returned pair is guaranteed to be computed.
+  ///
+  inline std::size_t computeDistances(const GeometryModel & geom_model,
+                                      GeometryData & geom_data);
+  
   ///
   /// Compute the forward kinematics, update the geometry placements and
   /// calls computeDistance for every active pairs of GeometryData.
@@ -12,6 +12,28 @@ namespace pinocchio
   /* --- GEOMETRY PLACEMENTS -------------------------------------------------------- */
   /* --- GEOMETRY PLACEMENTS -------------------------------------------------------- */
   /* --- GEOMETRY PLACEMENTS -------------------------------------------------------- */
+  namespace details
+  {
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    inline void updateGeometryPlacement(const DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                        const GeometryModel & geom_model,
+                                        GeometryData & geom_data,
+                                        const GeomIndex i)
+    {
+      const JointIndex & joint = geom_model.geometryObjects[i].parentJoint;
+      if (joint>0) geom_data.oMg[i] =  (data.oMi[joint] * geom_model.geometryObjects[i].placement);
+      else         geom_data.oMg[i] =  geom_model.geometryObjects[i].placement;
+#ifdef PINOCCHIO_WITH_HPP_FCL  
+PINOCCHIO_COMPILER_DIAGNOSTIC_PUSH
+PINOCCHIO_COMPILER_DIAGNOSTIC_IGNORED_DEPRECECATED_DECLARATIONS
+      geom_data.collisionObjects[i].setTransform( toFclTransform3f(geom_data.oMg[i]) );
+PINOCCHIO_COMPILER_DIAGNOSTIC_POP
+      if(geom_data.enableBroadPhase)
+        geom_data.boundingSphereCenters[i] = geom_data.oMg[i].act(geom_model.geometryObjects[i].geometry->aabb_center);
+#endif // PINOCCHIO_WITH_HPP_FCL
+    }
+  } // namespace details
+  
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType>
   inline void updateGeometryPlacements(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
                                        DataTpl<Scalar,Options,JointCollectionTpl> & data,
@@ -34,17 +56,26 @@ namespace pinocchio
     PINOCCHIO_UNUSED_VARIABLE(model);
     assert(model.check(data) && "data is not consistent with model.");
     
+    for (GeomIndex i=0; i < (GeomIndex) geom_model.ngeoms; ++i)
+      details::updateGeometryPlacement(data, geom_model, geom_data, i);
+  }
+  
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline void updateGeometryPlacements(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                       const DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                       const GeometryModel & geom_model,
+                                       GeometryData & geom_data,
+                                       const std::vector<JointIndex> & joint_ids)
+  {
+    assert(model.check(data) && "data is not consistent with model.");
+    
+    std::vector<bool> is_affected;
+    details::markSubtrees(model,joint_ids,is_affected);
+    
     for (GeomIndex i=0; i < (GeomIndex) geom_model.ngeoms; ++i)
     {
-      const Model::JointIndex & joint = geom_model.geometryObjects[i].parentJoint;
-      if (joint>0) geom_data.oMg[i] =  (data.oMi[joint] * geom_model.geometryObjects[i].placement);
-      else         geom_data.oMg[i] =  geom_model.geometryObjects[i].placement;
-#ifdef PINOCCHIO_WITH_HPP_FCL  
-PINOCCHIO_COMPILER_DIAGNOSTIC_PUSH
-PINOCCHIO_COMPILER_DIAGNOSTIC_IGNORED_DEPRECECATED_DECLARATIONS
-      geom_data.collisionObjects[i].setTransform( toFclTransform3f(geom_data.oMg[i]) );
-PINOCCHIO_COMPILER_DIAGNOSTIC_POP
-#endif // PINOCCHIO_WITH_HPP_FCL
+      if(is_affected[geom_model.geometryObjects[i].parentJoint])
+        details::updateGeometryPlacement(data, geom_model, geom_data, i);
     }
   }
 #ifdef PINOCCHIO_WITH_HPP_FCL  
@@ -53,6 +84,21 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_POP
   /* --- COLLISIONS ----------------------------------------------------------------- */
   /* --- COLLISIONS ----------------------------------------------------------------- */
 
+  inline double computeBroadPhaseDistance(const GeometryModel & geom_model,
+                                          const GeometryData & geom_data,
+                                          const PairIndex & pairId)
+  {
+    assert(pairId < geom_model.collisionPairs.size() && "The pair index is out of range.");
+    const CollisionPair & pair = geom_model.collisionPairs[pairId];
+    
+    const fcl::CollisionGeometry & geometry1 = *geom_model.geometryObjects[pair.first ].geometry;
+    const fcl::CollisionGeometry & geometry2 = *geom_model.geometryObjects[pair.second].geometry;
+    
+    const double center_distance = (geom_data.boundingSphereCenters[pair.first]
+                                    - geom_data.boundingSphereCenters[pair.second]).norm();
+    return center_distance - geometry1.aabb_radius - geometry2.aabb_radius;
+  }
+
   inline bool computeCollision(const GeometryModel & geom_model,
                                GeometryData & geom_data,
                                const PairIndex & pairId)
@@ -83,11 +129,20 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_POP
                                 const bool stopAtFirstCollision)
   {
     bool isColliding = false;
+    geom_data.nculledPairs = 0;
     
     for (std::size_t cpt = 0; cpt < geom_model.collisionPairs.size(); ++cpt)
     {
       if(geom_data.activeCollisionPairs[cpt])
       {
+        if(geom_data.enableBroadPhase
+           && computeBroadPhaseDistance(geom_model,geom_data,cpt) > geom_data.collisionRequests[cpt].security_margin)
+        {
+          geom_data.collisionResults[cpt].clear();
+          ++geom_data.nculledPairs;
+          continue;
+        }
+        
         computeCollision(geom_model,geom_data,cpt);
         if(!isColliding && geom_data.collisionResults[cpt].isCollision())
         {
@@ -149,10 +204,20 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_POP
   {
     std::size_t min_index = geom_model.collisionPairs.size();
     double min_dist = std::numeric_limits<double>::infinity();
+    geom_data.nculledPairs = 0;
+    
     for (std::size_t cpt = 0; cpt < geom_model.collisionPairs.size(); ++cpt)
     {
       if(geom_data.activeCollisionPairs[cpt])
       {
+        if(geom_data.enableBroadPhase
+           && computeBroadPhaseDistance(geom_model,geom_data,cpt) >= min_dist)
+        {
+          geom_data.distanceResults[cpt].clear();
+          ++geom_data.nculledPairs;
+          continue;
+        }
+        
         computeDistance(geom_model,geom_data,cpt);
         if(geom_data.distanceResults[cpt].min_distance < min_dist)
         {
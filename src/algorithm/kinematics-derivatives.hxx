@@ -452,6 +452,7 @@ namespace pinocchio
                                 DataTpl<Scalar,Options,JointCollectionTpl> & data)
   {
     assert(model.check(data) && "data is not consistent with model.");
+    data.allocate(model,ALLOCATE_KINEMATIC_HESSIANS);
     
     typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
     typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
@@ -563,6 +564,8 @@ namespace pinocchio
   {
     assert(model.check(data) && "data is not consistent with model.");
     assert(joint_id < model.joints.size() && joint_id > 0 && "joint_id is outside the valid index for a joint in model.joints");
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(data.isAllocated(ALLOCATE_KINEMATIC_HESSIANS),
+                                   "The kinematic Hessians have not been computed. Call computeJointKinematicHessians first.");
     
     typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
     typedef typename Data::SE3 SE3;
@@ -42,6 +42,65 @@ namespace pinocchio
                                 DataTpl<Scalar,Options,JointCollectionTpl> & data,
                                 const Eigen::MatrixBase<ConfigVectorType> & q);
 
+  ///
+  /// \brief Update the joint placements after a change of the configuration of the joints joint_ids only.
+  ///        Only the subtrees of these joints (see ModelTpl::subtrees) are visited: data.liMi is recomputed for the joints of joint_ids
+  ///        and data.oMi for all the joints of their subtrees. The other placements are left untouched.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorType Type of the joint configuration vector.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] q The joint configuration (vector dim model.nq).
+  /// \param[in] joint_ids The indexes of the joints whose configuration has changed.
+  ///
+  /// \warning forwardKinematics should have been called first, with a configuration which only differs from q on the joints joint_ids.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType>
+  inline void updateForwardKinematics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                      DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                      const Eigen::MatrixBase<ConfigVectorType> & q,
+                                      const std::vector<JointIndex> & joint_ids);
+
+  ///
+  /// \brief Update the joint placements from the configuration q_prev used in the previous call to forwardKinematics, to the configuration q.
+  ///        The joints whose configuration differs between q_prev and q are detected with \ref findChangedJoints,
+  ///        and only their subtrees are updated (see updateForwardKinematics(model,data,q,joint_ids)).
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorType1 Type of the previous joint configuration vector.
+  /// \tparam ConfigVectorType2 Type of the new joint configuration vector.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] q_prev The joint configuration of the previous call to forwardKinematics (vector dim model.nq).
+  /// \param[in] q The new joint configuration (vector dim model.nq).
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType1, typename ConfigVectorType2>
+  inline void updateForwardKinematics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                      DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                      const Eigen::MatrixBase<ConfigVectorType1> & q_prev,
+                                      const Eigen::MatrixBase<ConfigVectorType2> & q);
+
+  ///
+  /// \brief List the joints whose configuration differs between q1 and q2.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorType1 Type of the first joint configuration vector.
+  /// \tparam ConfigVectorType2 Type of the second joint configuration vector.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] q1 The first joint configuration (vector dim model.nq).
+  /// \param[in] q2 The second joint configuration (vector dim model.nq).
+  /// \param[out] joint_ids The indexes of the joints whose configuration differs, in increasing order.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType1, typename ConfigVectorType2>
+  inline void findChangedJoints(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                const Eigen::MatrixBase<ConfigVectorType1> & q1,
+                                const Eigen::MatrixBase<ConfigVectorType2> & q2,
+                                std::vector<JointIndex> & joint_ids);
+
   ///
   /// \brief Update the joint placements and spatial velocities according to the current joint configuration and velocity.
   ///
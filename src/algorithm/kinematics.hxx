@@ -83,6 +83,104 @@ namespace pinocchio
     }
   }
 
+  namespace details
+  {
+    ///
+    /// \brief Mark the joints belonging to the subtrees of the joints joint_ids.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    inline void markSubtrees(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                             const std::vector<JointIndex> & joint_ids,
+                             std::vector<bool> & mask)
+    {
+      typedef typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector IndexVector;
+      
+      mask.assign((size_t)model.njoints,false);
+      for(size_t k = 0; k < joint_ids.size(); ++k)
+      {
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(joint_ids[k] < (JointIndex)model.njoints, "joint_id is larger than the number of joints.");
+        // The subtree has already been marked through one of its ancestors.
+        if(mask[joint_ids[k]]) continue;
+        
+        const IndexVector & subtree = model.subtrees[joint_ids[k]];
+        for(size_t l = 0; l < subtree.size(); ++l)
+          mask[subtree[l]] = true;
+      }
+    }
+  } // namespace details
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType>
+  inline void updateForwardKinematics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                      DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                      const Eigen::MatrixBase<ConfigVectorType> & q,
+                                      const std::vector<JointIndex> & joint_ids)
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(), model.nq, "The configuration vector is not of right size");
+    assert(model.check(data) && "data is not consistent with model.");
+    
+    typedef ForwardKinematicZeroStep<Scalar,Options,JointCollectionTpl,ConfigVectorType> Algo;
+    
+    std::vector<bool> is_changed((size_t)model.njoints,false);
+    JointIndex first_joint = (JointIndex)model.njoints;
+    for(size_t k = 0; k < joint_ids.size(); ++k)
+    {
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(joint_ids[k] < (JointIndex)model.njoints, "joint_id is larger than the number of joints.");
+      is_changed[joint_ids[k]] = true;
+      first_joint = std::min(first_joint,joint_ids[k]);
+    }
+    
+    std::vector<bool> is_affected;
+    details::markSubtrees(model,joint_ids,is_affected);
+    
+    // The joints are sorted such that a parent is always visited before its children.
+    for(JointIndex i = std::max(first_joint,(JointIndex)1); i < (JointIndex)model.njoints; ++i)
+    {
+      if(is_changed[i])
+      {
+        Algo::run(model.joints[i], data.joints[i],
+                  typename Algo::ArgsType(model,data,q.derived()));
+      }
+      else if(is_affected[i])
+      {
+        const JointIndex & parent = model.parents[i];
+        if(parent>0)
+          data.oMi[i] = data.oMi[parent] * data.liMi[i];
+        else
+          data.oMi[i] = data.liMi[i];
+      }
+    }
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType1, typename ConfigVectorType2>
+  inline void findChangedJoints(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                const Eigen::MatrixBase<ConfigVectorType1> & q1,
+                                const Eigen::MatrixBase<ConfigVectorType2> & q2,
+                                std::vector<JointIndex> & joint_ids)
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q1.size(), model.nq, "The configuration vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q2.size(), model.nq, "The configuration vector is not of right size");
+    
+    joint_ids.clear();
+    for(JointIndex i=1; i < (JointIndex)model.njoints; ++i)
+    {
+      const int idx_q = model.idx_qs[i];
+      const int nq = model.nqs[i];
+      if(q1.segment(idx_q,nq) != q2.segment(idx_q,nq))
+        joint_ids.push_back(i);
+    }
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType1, typename ConfigVectorType2>
+  inline void updateForwardKinematics(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                      DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                      const Eigen::MatrixBase<ConfigVectorType1> & q_prev,
+                                      const Eigen::MatrixBase<ConfigVectorType2> & q)
+  {
+    std::vector<JointIndex> joint_ids;
+    findChangedJoints(model,q_prev,q,joint_ids);
+    updateForwardKinematics(model,data,q,joint_ids);
+  }
+
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType>
   struct ForwardKinematicFirstStep
   : fusion::JointUnaryVisitorBase< ForwardKinematicFirstStep<Scalar,Options,JointCollectionTpl,ConfigVectorType,TangentVectorType> >
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_parallel_aba_hpp__
+#define __pinocchio_algorithm_parallel_aba_hpp__
+
+#include "pinocchio/multibody/pool/model.hpp"
+#include "pinocchio/algorithm/aba.hpp"
+
+namespace pinocchio
+{
+  ///
+  /// \brief The Articulated-Body algorithm evaluated in parallel over a batch of states.
+  ///        Each column of the input matrices corresponds to one sample, and the samples are distributed over num_threads threads.
+  ///        Each thread works on its own Data of the pool, such that no allocation occurs during the evaluation.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorPool Matrix type of the joint configuration vectors.
+  /// \tparam TangentVectorPool1 Matrix type of the joint velocity vectors.
+  /// \tparam TangentVectorPool2 Matrix type of the joint torque vectors.
+  /// \tparam TangentVectorPool3 Matrix type of the joint acceleration vectors.
+  ///
+  /// \param[in] num_threads Number of threads used for the computation (it should not exceed pool.size()).
+  /// \param[in] pool Pool containing the model and the Data used by each thread.
+  /// \param[in] q The joint configuration vectors (dim model.nq x batch_size).
+  /// \param[in] v The joint velocity vectors (dim model.nv x batch_size).
+  /// \param[in] tau The joint torque vectors (dim model.nv x batch_size).
+  /// \param[out] a The resulting joint accelerations (dim model.nv x batch_size).
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorPool, typename TangentVectorPool1, typename TangentVectorPool2, typename TangentVectorPool3>
+  inline void abaInParallel(const size_t num_threads,
+                            ModelPoolTpl<Scalar,Options,JointCollectionTpl> & pool,
+                            const Eigen::MatrixBase<ConfigVectorPool> & q,
+                            const Eigen::MatrixBase<TangentVectorPool1> & v,
+                            const Eigen::MatrixBase<TangentVectorPool2> & tau,
+                            const Eigen::MatrixBase<TangentVectorPool3> & a);
+
+} // namespace pinocchio
+
+/* --- Details -------------------------------------------------------------------- */
+#include "pinocchio/algorithm/parallel/aba.hxx"
+
+#endif // ifndef __pinocchio_algorithm_parallel_aba_hpp__
@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_parallel_aba_hxx__
+#define __pinocchio_algorithm_parallel_aba_hxx__
+
+#include <omp.h>
+
+/// @cond DEV
+
+namespace pinocchio
+{
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorPool, typename TangentVectorPool1, typename TangentVectorPool2, typename TangentVectorPool3>
+  inline void abaInParallel(const size_t num_threads,
+                            ModelPoolTpl<Scalar,Options,JointCollectionTpl> & pool,
+                            const Eigen::MatrixBase<ConfigVectorPool> & q,
+                            const Eigen::MatrixBase<TangentVectorPool1> & v,
+                            const Eigen::MatrixBase<TangentVectorPool2> & tau,
+                            const Eigen::MatrixBase<TangentVectorPool3> & a)
+  {
+    typedef ModelPoolTpl<Scalar,Options,JointCollectionTpl> Pool;
+    typedef typename Pool::Model Model;
+    typedef typename Pool::Data Data;
+    typedef typename Pool::DataVector DataVector;
+    
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(num_threads > 0, "The number of threads should be positive.");
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(num_threads <= pool.size(), "The pool is too small compared to the number of threads.");
+    
+    const Model & model = pool.model();
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q.rows(), model.nq);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(v.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(tau.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(a.rows(), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(v.cols(), q.cols());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(tau.cols(), q.cols());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(a.cols(), q.cols());
+    
+    DataVector & datas = pool.datas();
+    TangentVectorPool3 & res = PINOCCHIO_EIGEN_CONST_CAST(TangentVectorPool3,a);
+    
+    const Eigen::DenseIndex batch_size = q.cols();
+    Eigen::DenseIndex i;
+    OpenMPException exception;
+    
+#pragma omp parallel for schedule(static) num_threads((int)num_threads)
+    for(i = 0; i < batch_size; ++i)
+    {
+      Data & data = datas[(size_t)omp_get_thread_num()];
+      try
+      {
+        res.col(i) = aba(model,data,q.col(i),v.col(i),tau.col(i));
+      }
+      catch(...)
+      {
+        exception.capture();
+      }
+    }
+    exception.rethrow();
+  }
+
+} // namespace pinocchio
+
+/// @endcond
+
+#endif // ifndef __pinocchio_algorithm_parallel_aba_hxx__
@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_parallel_geometry_hpp__
+#define __pinocchio_algorithm_parallel_geometry_hpp__
+
+#include "pinocchio/multibody/pool/geometry.hpp"
+#include "pinocchio/algorithm/geometry.hpp"
+
+namespace pinocchio
+{
+  ///
+  /// \brief Parallel version of computeCollisions: the active collision pairs are distributed over num_threads threads.
+  ///        This function assumes that \ref updateGeometryPlacements has been called first.
+  ///
+  /// \param[in] num_threads Number of threads used for the computation.
+  /// \param[in] geom_model Geometry model (const).
+  /// \param[out] geom_data Corresponding geometry data (nonconst) where the collision results are stored (each pair writes into its own geom_data.collisionResults[pairId]).
+  /// \param[in] stopAtFirstCollision If true, the remaining pairs are skipped as soon as one thread detects a collision.
+  ///
+  /// \return True if at least one of the active collision pairs is in collision.
+  ///
+  /// \note geom_data.collisionPairIndex is set to the lowest index among the colliding pairs which have been tested.
+  ///       As for computeCollisions, the broad phase is used if geom_data.enableBroadPhase is true.
+  /// \warning If stopAtFirstCollision = true, the collisionResults vector will not be entirely filled, and the
+  ///          tested pairs depend on the thread scheduling.
+  ///
+  inline bool computeCollisionsInParallel(const size_t num_threads,
+                                          const GeometryModel & geom_model,
+                                          GeometryData & geom_data,
+                                          const bool stopAtFirstCollision = false);
+  
+  ///
+  /// \brief Compute the forward kinematics, update the geometry placements and calls computeCollisions for a batch of configurations,
+  ///        which are distributed over num_threads threads. Each thread works on its own Data and GeometryData of the pool.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorPool Matrix type of the joint configuration vectors.
+  /// \tparam CollisionVectorResult Vector type of the collision results (a vector of bool).
+  ///
+  /// \param[in] num_threads Number of threads used for the computation (it should not exceed pool.size()).
+  /// \param[in] pool Pool containing the model, the geometry model and the datas used by each thread.
+  /// \param[in] q The joint configuration vectors (dim model.nq x batch_size).
+  /// \param[out] res The collision status of each configuration (dim batch_size).
+  /// \param[in] stopAtFirstCollision If true, stop the loop over the collision pairs of a configuration when its first collision is detected.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorPool, typename CollisionVectorResult>
+  inline void computeCollisionsInParallel(const size_t num_threads,
+                                          GeometryPoolTpl<Scalar,Options,JointCollectionTpl> & pool,
+                                          const Eigen::MatrixBase<ConfigVectorPool> & q,
+                                          const Eigen::MatrixBase<CollisionVectorResult> & res,
+                                          const bool stopAtFirstCollision = false);
+
+} // namespace pinocchio
+
+/* --- Details -------------------------------------------------------------------- */
+#include "pinocchio/algorithm/parallel/geometry.hxx"
+
+#endif // ifndef __pinocchio_algorithm_parallel_geometry_hpp__
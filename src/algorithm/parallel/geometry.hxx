@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_parallel_geometry_hxx__
+#define __pinocchio_algorithm_parallel_geometry_hxx__
+
+#include <omp.h>
+
+/// @cond DEV
+
+namespace pinocchio
+{
+  inline bool computeCollisionsInParallel(const size_t num_threads,
+                                          const GeometryModel & geom_model,
+                                          GeometryData & geom_data,
+                                          const bool stopAtFirstCollision)
+  {
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(num_threads > 0, "The number of threads should be positive.");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(geom_data.activeCollisionPairs.size(), geom_model.collisionPairs.size());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(geom_data.collisionResults.size(), geom_model.collisionPairs.size());
+    
+    const std::ptrdiff_t num_pairs = (std::ptrdiff_t)geom_model.collisionPairs.size();
+    std::ptrdiff_t first_collision_index = num_pairs;
+    bool is_colliding = false;
+    std::size_t nculled_pairs = 0;
+    std::ptrdiff_t cp_index;
+    OpenMPException exception;
+    
+    // The narrow phase cost strongly depends on the pair, hence the dynamic scheduling.
+#pragma omp parallel for schedule(dynamic) num_threads((int)num_threads) reduction(+:nculled_pairs)
+    for(cp_index = 0; cp_index < num_pairs; ++cp_index)
+    {
+      if(stopAtFirstCollision)
+      {
+        bool stop;
+#pragma omp atomic read
+        stop = is_colliding;
+        if(stop) continue;
+      }
+      
+      if(!geom_data.activeCollisionPairs[(size_t)cp_index])
+        continue;
+      
+      if(geom_data.enableBroadPhase
+         && computeBroadPhaseDistance(geom_model,geom_data,(PairIndex)cp_index) > geom_data.collisionRequests[(size_t)cp_index].security_margin)
+      {
+        geom_data.collisionResults[(size_t)cp_index].clear();
+        ++nculled_pairs;
+        continue;
+      }
+      
+      // computeCollision may throw (e.g. for an invalid pair), which must not escape the parallel region.
+      bool is_pair_colliding = false;
+      try
+      {
+        is_pair_colliding = computeCollision(geom_model,geom_data,(PairIndex)cp_index);
+      }
+      catch(...)
+      {
+        exception.capture();
+      }
+      
+      if(is_pair_colliding)
+      {
+#pragma omp atomic write
+        is_colliding = true;
+        
+#pragma omp critical (pinocchio_collision_pair_index)
+        {
+          if(cp_index < first_collision_index)
+            first_collision_index = cp_index;
+        }
+      }
+    }
+    exception.rethrow();
+    
+    geom_data.nculledPairs = nculled_pairs;
+    if(is_colliding)
+      geom_data.collisionPairIndex = (PairIndex)first_collision_index;
+    
+    return is_colliding;
+  }
+  
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorPool, typename CollisionVectorResult>
+  inline void computeCollisionsInParallel(const size_t num_threads,
+                                          GeometryPoolTpl<Scalar,Options,JointCollectionTpl> & pool,
+                                          const Eigen::MatrixBase<ConfigVectorPool> & q,
+                                          const Eigen::MatrixBase<CollisionVectorResult> & res,
+                                          const bool stopAtFirstCollision)
+  {
+    typedef GeometryPoolTpl<Scalar,Options,JointCollectionTpl> Pool;
+    typedef typename Pool::Model Model;
+    typedef typename Pool::Data Data;
+    typedef typename Pool::GeometryModel GeometryModel;
+    typedef typename Pool::GeometryData GeometryData;
+    typedef typename Pool::DataVector DataVector;
+    typedef typename Pool::GeometryDataVector GeometryDataVector;
+    
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(num_threads > 0, "The number of threads should be positive.");
+    PINOCCHIO_CHECK_INPUT_ARGUMENT(num_threads <= pool.size(), "The pool is too small compared to the number of threads.");
+    
+    const Model & model = pool.model();
+    const GeometryModel & geometry_model = pool.geometry_model();
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q.rows(), model.nq);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.size(), q.cols());
+    
+    DataVector & datas = pool.datas();
+    GeometryDataVector & geometry_datas = pool.geometry_datas();
+    CollisionVectorResult & res_ = PINOCCHIO_EIGEN_CONST_CAST(CollisionVectorResult,res);
+    
+    const Eigen::DenseIndex batch_size = q.cols();
+    Eigen::DenseIndex i;
+    OpenMPException exception;
+    
+#pragma omp parallel for schedule(static) num_threads((int)num_threads)
+    for(i = 0; i < batch_size; ++i)
+    {
+      const size_t thread_id = (size_t)omp_get_thread_num();
+      Data & data = datas[thread_id];
+      GeometryData & geometry_data = geometry_datas[thread_id];
+      try
+      {
+        res_[i] = computeCollisions(model,data,geometry_model,geometry_data,q.col(i),stopAtFirstCollision);
+      }
+      catch(...)
+      {
+        exception.capture();
+      }
+    }
+    exception.rethrow();
+  }
+
+} // namespace pinocchio
+
+/// @endcond
+
+#endif // ifndef __pinocchio_algorithm_parallel_geometry_hxx__
@@ -118,6 +118,7 @@ namespace pinocchio
   {
     assert(model.check(data) && "data is not consistent with model.");
     PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(), model.nq);
+    data.allocate(model,ALLOCATE_REGRESSORS);
     
     typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
     typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
@@ -360,6 +361,7 @@ namespace pinocchio
     PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(), model.nq);
     PINOCCHIO_CHECK_ARGUMENT_SIZE(v.size(), model.nv);
     PINOCCHIO_CHECK_ARGUMENT_SIZE(a.size(), model.nv);
+    data.allocate(model,ALLOCATE_REGRESSORS);
 
     data.v[0].setZero();
     data.a_gf[0] = -model.gravity;
@@ -170,6 +170,7 @@ namespace pinocchio
                          const Eigen::MatrixBase<TangentVectorType1> & v,
                          const Eigen::MatrixBase<TangentVectorType2> & a)
   {
+    data.allocate(model,ALLOCATE_DERIVATIVES);
     computeRNEADerivatives(model,data,q.derived(),v.derived(),a.derived(),
                            data.dtau_dq, data.dtau_dv, data.M);
   }
@@ -205,6 +206,7 @@ namespace pinocchio
                          const Eigen::MatrixBase<TangentVectorType2> & a,
                          const container::aligned_vector< ForceTpl<Scalar,Options> > & fext)
   {
+    data.allocate(model,ALLOCATE_DERIVATIVES);
     computeRNEADerivatives(model,data,q.derived(),v.derived(),a.derived(),fext,
                            data.dtau_dq, data.dtau_dv, data.M);
   }
@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_rnea_second_order_derivatives_hpp__
+#define __pinocchio_rnea_second_order_derivatives_hpp__
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+#include "pinocchio/math/tensor.hpp"
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Computes the second order partial derivatives of the Recursive Newton Euler Algorithm
+  ///        with respect to the joint configuration, the joint velocity and the joint acceleration.
+  ///        The entry (j,m,p) of each tensor is the derivative of the entry (j,m) of the corresponding first order derivative
+  ///        (see computeRNEADerivatives) with respect to the p-th component of the second variable:
+  ///          - d2tau_dqdq(j,m,p) is the derivative of dtau_dq(j,m) with respect to q(p),
+  ///          - d2tau_dvdv(j,m,p) is the derivative of dtau_dv(j,m) with respect to v(p),
+  ///          - d2tau_dqdv(j,m,p) is the derivative of dtau_dq(j,m) with respect to v(p),
+  ///          - d2tau_dadq(j,m,p) is the derivative of dtau_da(j,m), i.e. of the joint space inertia matrix M(j,m), with respect to q(p).
+  ///        As for computeRNEADerivatives, the derivatives with respect to q are taken along the tangent space of the configuration space.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  /// \tparam ConfigVectorType Type of the joint configuration vector.
+  /// \tparam TangentVectorType1 Type of the joint velocity vector.
+  /// \tparam TangentVectorType2 Type of the joint acceleration vector.
+  /// \tparam Tensor1 Type of the tensor containing the second order derivative with respect to the joint configuration twice.
+  /// \tparam Tensor2 Type of the tensor containing the second order derivative with respect to the joint velocity twice.
+  /// \tparam Tensor3 Type of the tensor containing the cross derivative with respect to the joint configuration and the joint velocity.
+  /// \tparam Tensor4 Type of the tensor containing the cross derivative with respect to the joint acceleration and the joint configuration.
+  ///
+  /// \param[in] model The model structure of the rigid body system.
+  /// \param[in] data The data structure of the rigid body system.
+  /// \param[in] q The joint configuration vector (dim model.nq).
+  /// \param[in] v The joint velocity vector (dim model.nv).
+  /// \param[in] a The joint acceleration vector (dim model.nv).
+  /// \param[out] d2tau_dqdq Second order derivative of the generalized torque vector with respect to the joint configuration (dim nv x nv x nv).
+  /// \param[out] d2tau_dvdv Second order derivative of the generalized torque vector with respect to the joint velocity (dim nv x nv x nv).
+  /// \param[out] d2tau_dqdv Cross derivative of the generalized torque vector with respect to the joint configuration and the joint velocity (dim nv x nv x nv).
+  /// \param[out] d2tau_dadq Cross derivative of the generalized torque vector with respect to the joint acceleration and the joint configuration (dim nv x nv x nv).
+  ///
+  /// \remarks The tensors are fully filled, including the lower triangular part of the derivatives of M.
+  ///          As for computeRNEADerivatives, the motion subspaces of the joints must not depend on the joint configuration
+  ///          (revolute, prismatic, spherical, planar, translation and free flyer joints and their composition with fixed placements).
+  ///
+  /// \sa pinocchio::computeRNEADerivatives
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType1, typename TangentVectorType2,
+  typename Tensor1, typename Tensor2, typename Tensor3, typename Tensor4>
+  inline void
+  computeRNEASecondOrderDerivatives(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const Eigen::MatrixBase<ConfigVectorType> & q,
+                                    const Eigen::MatrixBase<TangentVectorType1> & v,
+                                    const Eigen::MatrixBase<TangentVectorType2> & a,
+                                    Tensor1 & d2tau_dqdq,
+                                    Tensor2 & d2tau_dvdv,
+                                    Tensor3 & d2tau_dqdv,
+                                    Tensor4 & d2tau_dadq);
+
+} // namespace pinocchio
+
+#include "pinocchio/algorithm/rnea-second-order-derivatives.hxx"
+
+#endif // ifndef __pinocchio_rnea_second_order_derivatives_hpp__
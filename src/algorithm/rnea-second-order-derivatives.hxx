@@ -0,0 +1,327 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_rnea_second_order_derivatives_hxx__
+#define __pinocchio_rnea_second_order_derivatives_hxx__
+
+#include "pinocchio/algorithm/rnea-derivatives.hpp"
+#include "pinocchio/multibody/visitor.hpp"
+#include "pinocchio/algorithm/check.hpp"
+
+namespace pinocchio
+{
+
+  ///
+  /// Notations used below, all the quantities being expressed in the world frame:
+  ///   - S_k, psi_k = ov_{parent} x S_k, nu_k = ov_i x S_k and alpha_k = oa_gf_{parent} x S_k + ov_{parent} x psi_k
+  ///     are the columns of data.J, data.dVdq, data.dJ and data.dAdq computed by ComputeRNEADerivativesForwardStep,
+  ///     for the degree of freedom k supported by the joint i,
+  ///   - Y, B and F are the composite quantities of the subtree of the current joint: the inertia data.oYcrb,
+  ///     the derivative of the forces with respect to the velocity data.doYcrb and the forces data.of.
+  ///
+  /// Each entry (j,m,p) of the tensors is computed once, at the backward step of the deepest joint among the joints
+  /// supporting j, m and p:
+  ///   - if this joint supports j or m, the entry is computed from the composite quantities of this joint, for all the degrees of freedom p of its support,
+  ///   - otherwise the joint supports p only, and the entry is computed from the composite quantities of this joint for all the pairs (j,m) of its support.
+  ///
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename Tensor1, typename Tensor2, typename Tensor3, typename Tensor4>
+  struct ComputeRNEASecondOrderDerivativesBackwardStep
+  : public fusion::JointUnaryVisitorBase< ComputeRNEASecondOrderDerivativesBackwardStep<Scalar,Options,JointCollectionTpl,Tensor1,Tensor2,Tensor3,Tensor4> >
+  {
+    typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+
+    typedef boost::fusion::vector<const Model &,
+                                  Data &,
+                                  Tensor1 &,
+                                  Tensor2 &,
+                                  Tensor3 &,
+                                  Tensor4 &
+                                  > ArgsType;
+
+    template<typename JointModel>
+    static void algo(const JointModelBase<JointModel> & jmodel,
+                     const Model & model,
+                     Data & data,
+                     Tensor1 & d2tau_dqdq,
+                     Tensor2 & d2tau_dvdv,
+                     Tensor3 & d2tau_dqdv,
+                     Tensor4 & d2tau_dadq)
+    {
+      typedef typename Model::JointIndex JointIndex;
+      typedef typename Data::Motion Motion;
+      typedef typename Data::Force Force;
+      typedef typename Data::Inertia Inertia;
+      typedef typename Data::Matrix6 Matrix6;
+      typedef typename Force::Vector6 Vector6;
+      typedef typename Data::Matrix6x::ColXpr ColXpr;
+
+      const JointIndex & i = jmodel.id();
+      const JointIndex & parent = model.parents[i];
+      const int first = jmodel.idx_v();
+      const int last = jmodel.idx_v() + jmodel.nv() - 1;
+      const Eigen::DenseIndex nv = model.nv;
+
+      const Inertia & Y = data.oYcrb[i];
+      const Matrix6 & B = data.doYcrb[i];
+      const Force & F = data.of[i];
+
+      Scalar * dqdq = d2tau_dqdq.data();
+      Scalar * dvdv = d2tau_dvdv.data();
+      Scalar * dqdv = d2tau_dqdv.data();
+      Scalar * dadq = d2tau_dadq.data();
+
+      // entries (j,m,p) where j belongs to the current joint and m supports it
+      for(int j = first; j <= last; ++j)
+      {
+        const Motion S_j(data.J.col(j));
+        const Force y(Y * S_j);
+        const Force b(B.transpose() * S_j.toVector());
+
+        for(int m = last; m >= 0; m = data.parents_fromRow[(std::size_t)m])
+        {
+          const Motion S_m(data.J.col(m));
+          const Motion psi_m(data.dVdq.col(m));
+          const Motion alpha_m(data.dAdq.col(m));
+          const int start_m = data.start_idx_v_fromRow[(std::size_t)m];
+          const int end_m = data.end_idx_v_fromRow[(std::size_t)m];
+
+          const Force S_m_y(S_m.cross(y));
+          const Force psi_m_y(psi_m.cross(y));
+          const Force Y_psi_m_S_j(Y * psi_m.cross(S_j));
+          const Force S_j_Y_psi_m(S_j.cross(Y * psi_m));
+          const Force X(psi_m_y + Y_psi_m_S_j + S_j_Y_psi_m);
+          const Force Z(psi_m_y - Y_psi_m_S_j - S_j_Y_psi_m + S_m.cross(b));
+          const Force W(alpha_m.cross(y) + psi_m.cross(b));
+          const Force V(-(Y * S_m.cross(S_j)) - S_j.cross(Y * S_m));
+
+          const Vector6 c_dqdq_S(-W.toVector());
+          const Vector6 c_dqdq_psi(-X.toVector());
+          const Vector6 c_dvdv_low((S_m_y + V).toVector());
+          const Vector6 c_dvdv_up((V - S_m_y).toVector());
+
+          for(int p = last; p >= 0; p = data.parents_fromRow[(std::size_t)p])
+          {
+            const ColXpr S_p = data.J.col(p);
+            const ColXpr psi_p = data.dVdq.col(p);
+            const Eigen::DenseIndex k = index(nv,j,m,p);
+
+            if(p <= end_m)
+            {
+              dqdq[k] = S_m_y.toVector().dot(data.dAdq.col(p)) + Z.toVector().dot(psi_p);
+              dadq[k] = Scalar(0);
+            }
+            else
+            {
+              dqdq[k] = c_dqdq_psi.dot(psi_p) + c_dqdq_S.dot(S_p);
+              dadq[k] = -S_m_y.toVector().dot(S_p);
+            }
+
+            if(p < start_m)
+            {
+              dqdv[k] = S_m_y.toVector().dot(psi_p + data.dJ.col(p)) + Z.toVector().dot(S_p);
+              dvdv[k] = c_dvdv_low.dot(S_p);
+            }
+            else
+            {
+              dqdv[k] = c_dqdq_psi.dot(S_p);
+              if(p <= end_m)
+                dvdv[k] = V.toVector().dot(S_p);
+              else
+                dvdv[k] = c_dvdv_up.dot(S_p);
+            }
+          }
+        }
+      }
+
+      // entries (j,m,p) where m belongs to the current joint and j strictly supports it
+      for(int m = first; m <= last; ++m)
+      {
+        const Motion S_m(data.J.col(m));
+        const Motion psi_m(data.dVdq.col(m));
+        const Motion alpha_m(data.dAdq.col(m));
+
+        const Force Y_S_m(Y * S_m);
+        const Force Y_psi_m(Y * psi_m);
+        const Force W(S_m.cross(F) + Y * alpha_m + Force(B * psi_m.toVector()));
+
+        for(int j = data.parents_fromRow[(std::size_t)first]; j >= 0; j = data.parents_fromRow[(std::size_t)j])
+        {
+          const Motion S_j(data.J.col(j));
+          const Force y(Y * S_j);
+          const Force b(B.transpose() * S_j.toVector());
+          const int end_j = data.end_idx_v_fromRow[(std::size_t)j];
+
+          const Motion S_m_S_j(S_m.cross(S_j));
+          const Force S_m_y(S_m.cross(y));
+          const Force Y_S_m_S_j(Y * S_m_S_j);
+          const Force Bt_S_m_S_j(B.transpose() * S_m_S_j.toVector());
+          const Force S_j_Y_S_m(S_j.cross(Y_S_m));
+          const Force psi_m_y(psi_m.cross(y));
+          const Force Y_psi_m_S_j(Y * psi_m.cross(S_j));
+          const Force S_j_Y_psi_m(S_j.cross(Y_psi_m));
+
+          const Force X(psi_m_y + Y_psi_m_S_j + S_j_Y_psi_m);
+          const Force Z(psi_m_y - Y_psi_m_S_j - S_j_Y_psi_m + S_m.cross(b) - Bt_S_m_S_j);
+          const Force S_j_W(S_j.cross(W));
+          const Force V(-Y_S_m_S_j - S_j_Y_S_m);
+
+          const Vector6 c_alpha((S_m_y - Y_S_m_S_j).toVector());
+          const Vector6 c_dvdv_low((S_m_y + V).toVector());
+          const Vector6 c_dqdv_S(-(Bt_S_m_S_j + X).toVector());
+
+          for(int p = last; p >= 0; p = data.parents_fromRow[(std::size_t)p])
+          {
+            const ColXpr S_p = data.J.col(p);
+            const ColXpr psi_p = data.dVdq.col(p);
+            const Eigen::DenseIndex k = index(nv,j,m,p);
+
+            dqdq[k] = c_alpha.dot(data.dAdq.col(p)) + Z.toVector().dot(psi_p);
+            if(p > end_j)
+            {
+              dqdq[k] -= S_j_W.toVector().dot(S_p);
+              dadq[k] = -S_j_Y_S_m.toVector().dot(S_p);
+            }
+            else
+              dadq[k] = Scalar(0);
+
+            if(p < first)
+            {
+              dqdv[k] = c_alpha.dot(psi_p + data.dJ.col(p)) + Z.toVector().dot(S_p);
+              dvdv[k] = c_dvdv_low.dot(S_p);
+            }
+            else
+            {
+              dqdv[k] = -Y_S_m_S_j.toVector().dot(psi_p + data.dJ.col(p)) + c_dqdv_S.dot(S_p);
+              dvdv[k] = V.toVector().dot(S_p);
+            }
+          }
+        }
+      }
+
+      // entries (j,m,p) where p belongs to the current joint and j and m strictly support it
+      if(parent > 0)
+      {
+        for(int p = first; p <= last; ++p)
+        {
+          const Motion S_p(data.J.col(p));
+          const Motion psi_p(data.dVdq.col(p));
+          const Motion nu_p(data.dJ.col(p));
+          const Motion alpha_p(data.dAdq.col(p));
+
+          const Force Y_S_p(Y * S_p);
+          const Force Y_psi_p(Y * psi_p);
+          const Force g(S_p.cross(F) + Y * alpha_p + Force(B * psi_p.toVector()));
+          const Force h(Y * (psi_p + nu_p) + Force(B * S_p.toVector()));
+
+          for(int m = data.parents_fromRow[(std::size_t)first]; m >= 0; m = data.parents_fromRow[(std::size_t)m])
+          {
+            const Motion S_m(data.J.col(m));
+            const Motion psi_m(data.dVdq.col(m));
+            const Motion alpha_m(data.dAdq.col(m));
+            const int start_m = data.start_idx_v_fromRow[(std::size_t)m];
+
+            // variation of Y and B along S_p applied to alpha_m, psi_m and S_m
+            const Force Y_psi_m(Y * psi_m);
+            const Force x(S_p.cross(Force(B * psi_m.toVector())) - Force(B * S_p.cross(psi_m).toVector())
+                          + Y * psi_m.cross(psi_p) + psi_m.cross(Y_psi_p) + psi_p.cross(Y_psi_m)
+                          + S_p.cross(Y * alpha_m) - Y * S_p.cross(alpha_m));
+            const Force z_psi(Y * psi_m.cross(S_p) + psi_m.cross(Y_S_p) + S_p.cross(Y_psi_m));
+            const Force Y_S_m(Y * S_m);
+            const Force z_S(Y * S_m.cross(S_p) + S_m.cross(Y_S_p) + S_p.cross(Y_S_m));
+            const Force w(S_p.cross(Y_S_m) - Y * S_p.cross(S_m));
+            // (S_j x S_m) . g = S_j . (S_m x* g) is added for the degrees of freedom j strictly supporting m
+            const Force x_up(x + S_m.cross(g));
+            const Force z_psi_up(z_psi + S_m.cross(h));
+
+            for(int j = data.parents_fromRow[(std::size_t)first]; j >= 0; j = data.parents_fromRow[(std::size_t)j])
+            {
+              const ColXpr S_j = data.J.col(j);
+              const Eigen::DenseIndex k = index(nv,j,m,p);
+
+              if(j < start_m)
+              {
+                dqdq[k] = S_j.dot(x_up.toVector());
+                dqdv[k] = S_j.dot(z_psi_up.toVector());
+              }
+              else
+              {
+                dqdq[k] = S_j.dot(x.toVector());
+                dqdv[k] = S_j.dot(z_psi.toVector());
+              }
+              dvdv[k] = S_j.dot(z_S.toVector());
+              dadq[k] = S_j.dot(w.toVector());
+            }
+          }
+        }
+
+        data.oYcrb[parent] += data.oYcrb[i];
+        data.doYcrb[parent] += data.doYcrb[i];
+        data.of[parent] += data.of[i];
+      }
+    }
+
+    static Eigen::DenseIndex index(const Eigen::DenseIndex nv, const int j, const int m, const int p)
+    { return j + nv * (m + nv * p); }
+  };
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType1, typename TangentVectorType2,
+  typename Tensor1, typename Tensor2, typename Tensor3, typename Tensor4>
+  inline void
+  computeRNEASecondOrderDerivatives(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                    DataTpl<Scalar,Options,JointCollectionTpl> & data,
+                                    const Eigen::MatrixBase<ConfigVectorType> & q,
+                                    const Eigen::MatrixBase<TangentVectorType1> & v,
+                                    const Eigen::MatrixBase<TangentVectorType2> & a,
+                                    Tensor1 & d2tau_dqdq,
+                                    Tensor2 & d2tau_dvdv,
+                                    Tensor3 & d2tau_dqdv,
+                                    Tensor4 & d2tau_dadq)
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(), model.nq, "The joint configuration vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(v.size(), model.nv, "The joint velocity vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(a.size(), model.nv, "The joint acceleration vector is not of right size");
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dqdq.dimension(0), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dqdq.dimension(1), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dqdq.dimension(2), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dvdv.dimension(0), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dvdv.dimension(1), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dvdv.dimension(2), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dqdv.dimension(0), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dqdv.dimension(1), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dqdv.dimension(2), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dadq.dimension(0), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dadq.dimension(1), model.nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(d2tau_dadq.dimension(2), model.nv);
+    assert(model.check(data) && "data is not consistent with model.");
+
+    typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+    typedef typename Model::JointIndex JointIndex;
+
+    // the entries involving degrees of freedom which do not support each other are never visited
+    d2tau_dqdq.setZero();
+    d2tau_dvdv.setZero();
+    d2tau_dqdv.setZero();
+    d2tau_dadq.setZero();
+
+    data.oa_gf[0] = -model.gravity;
+
+    typedef ComputeRNEADerivativesForwardStep<Scalar,Options,JointCollectionTpl,ConfigVectorType,TangentVectorType1,TangentVectorType2> Pass1;
+    for(JointIndex i=1; i<(JointIndex) model.njoints; ++i)
+    {
+      Pass1::run(model.joints[i],data.joints[i],
+                 typename Pass1::ArgsType(model,data,q.derived(),v.derived(),a.derived()));
+    }
+
+    typedef ComputeRNEASecondOrderDerivativesBackwardStep<Scalar,Options,JointCollectionTpl,Tensor1,Tensor2,Tensor3,Tensor4> Pass2;
+    for(JointIndex i=(JointIndex)(model.njoints-1); i>0; --i)
+    {
+      Pass2::run(model.joints[i],
+                 typename Pass2::ArgsType(model,data,d2tau_dqdq,d2tau_dvdv,d2tau_dqdv,d2tau_dadq));
+    }
+  }
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_rnea_second_order_derivatives_hxx__
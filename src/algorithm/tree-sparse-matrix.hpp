@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_tree_sparse_matrix_hpp__
+#define __pinocchio_algorithm_tree_sparse_matrix_hpp__
+
+#include "pinocchio/multibody/model.hpp"
+
+namespace pinocchio
+{
+  ///
+  /// \brief Symmetric matrix of dimension model.nv with the sparsity pattern induced by the kinematic tree,
+  ///        such as the joint space inertia matrix (see pinocchio::crba).
+  ///        The entry (i,j) is structurally zero as soon as the degrees of freedom i and j do not belong to the same branch,
+  ///        i.e. neither of them supports the other one.
+  ///        Only the upper triangular part is stored: thanks to the depth-first ordering of the degrees of freedom,
+  ///        the nonzero entries of the row i are the contiguous columns i to i+rowSize(i)-1 (the subtree of i).
+  ///
+  /// \tparam _Scalar Scalar type.
+  /// \tparam _Options Alignment options of the Eigen matrices.
+  ///
+  template<typename _Scalar, int _Options>
+  struct TreeSparseMatrixTpl
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef _Scalar Scalar;
+    enum { Options = _Options };
+
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1,Options> VectorXs;
+    typedef Eigen::VectorBlock<VectorXs> RowSegment;
+    typedef Eigen::VectorBlock<const VectorXs> ConstRowSegment;
+    typedef std::vector<int> IndexVector;
+
+    /// \brief Default constructor: an empty matrix.
+    TreeSparseMatrixTpl()
+    : m_nv(0)
+    , m_row_offsets(1,0)
+    {}
+
+    ///
+    /// \brief Build the sparsity pattern associated to the kinematic tree of the model. The entries are set to zero.
+    ///
+    /// \param[in] model The model structure of the rigid body system.
+    ///
+    template<template<typename,int> class JointCollectionTpl>
+    explicit TreeSparseMatrixTpl(const ModelTpl<Scalar,Options,JointCollectionTpl> & model)
+    { resize(model); }
+
+    ///
+    /// \brief Build the sparsity pattern associated to the kinematic tree of the model. The entries are set to zero.
+    ///
+    /// \param[in] model The model structure of the rigid body system.
+    ///
+    template<template<typename,int> class JointCollectionTpl>
+    void resize(const ModelTpl<Scalar,Options,JointCollectionTpl> & model);
+
+    /// \returns the number of rows of the matrix.
+    int rows() const { return m_nv; }
+
+    /// \returns the number of columns of the matrix.
+    int cols() const { return m_nv; }
+
+    /// \returns the number of stored entries, i.e. the nonzero entries of the upper triangular part.
+    int nonZeros() const { return (int)m_values.size(); }
+
+    /// \returns the number of stored entries of the row i, starting at the diagonal.
+    int rowSize(const int i) const { return m_row_sizes[(size_t)i]; }
+
+    /// \returns the parent of the degree of freedom i in the kinematic tree (-1 for the degrees of freedom attached to the universe).
+    int parent(const int i) const { return m_parents[(size_t)i]; }
+
+    /// \returns the stored entries of the row i, i.e. the columns i to i+rowSize(i)-1.
+    RowSegment row(const int i)
+    { return RowSegment(m_values,m_row_offsets[(size_t)i],m_row_sizes[(size_t)i]); }
+    ConstRowSegment row(const int i) const
+    { return ConstRowSegment(m_values,m_row_offsets[(size_t)i],m_row_sizes[(size_t)i]); }
+
+    /// \returns the entry (i,j) of the matrix, which is zero outside of the sparsity pattern.
+    Scalar coeff(const int i, const int j) const;
+
+    /// \returns a reference to the entry (i,j) of the upper triangular part. It must belong to the sparsity pattern.
+    Scalar & coeffRef(const int i, const int j)
+    {
+      assert(i <= j && j-i < m_row_sizes[(size_t)i] && "(i,j) is not part of the sparsity pattern.");
+      return m_values[m_row_offsets[(size_t)i]+j-i];
+    }
+
+    /// \returns the vector of the stored entries, stored row by row.
+    const VectorXs & values() const { return m_values; }
+    VectorXs & values() { return m_values; }
+
+    ///
+    /// \brief Read the entries of the sparsity pattern from the upper triangular part of a dense matrix,
+    ///        typically data.M after pinocchio::crba.
+    ///
+    /// \param[in] mat The dense matrix (dim rows() x cols()). Only its upper triangular part is read.
+    ///
+    template<typename MatrixLike>
+    void fromDense(const Eigen::MatrixBase<MatrixLike> & mat);
+
+    ///
+    /// \brief Write the dense version of the matrix into mat (both triangular parts are filled).
+    ///
+    /// \param[out] mat The dense matrix (dim rows() x cols()).
+    ///
+    template<typename MatrixLike>
+    void toDense(const Eigen::MatrixBase<MatrixLike> & mat) const;
+
+  protected:
+
+    int m_nv;
+    IndexVector m_row_offsets;
+    IndexVector m_row_sizes;
+    IndexVector m_parents;
+    VectorXs m_values;
+
+  }; // struct TreeSparseMatrixTpl
+
+  typedef TreeSparseMatrixTpl<double,0> TreeSparseMatrix;
+
+  ///
+  /// \brief Factorization \f$ U D U^{\top} \f$ of a tree sparse matrix, with U unit upper triangular (as in pinocchio::cholesky::decompose).
+  ///        U has the sparsity pattern of the factorized matrix: there is no fill-in and the factors are stored in the same compressed way.
+  ///
+  /// \note The inverse of a tree sparse matrix does not keep the sparsity pattern: two degrees of freedom of different branches
+  ///       are coupled through the degrees of freedom supporting both of them, and the inverse is dense for a floating base system.
+  ///       Products with the inverse (e.g. \f$ M^{-1} B \f$) should rather be computed with solveInPlace.
+  ///
+  template<typename _Scalar, int _Options>
+  struct TreeSparseLDLTTpl
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef _Scalar Scalar;
+    enum { Options = _Options };
+
+    typedef TreeSparseMatrixTpl<Scalar,Options> TreeSparseMatrix;
+    typedef typename TreeSparseMatrix::VectorXs VectorXs;
+
+    TreeSparseLDLTTpl() {}
+
+    ///
+    /// \brief Compute the factorization of mat.
+    ///
+    /// \param[in] mat The symmetric positive definite tree sparse matrix to factorize.
+    ///
+    void compute(const TreeSparseMatrix & mat);
+
+    ///
+    /// \brief Solve in place mat * x = b, where mat is the factorized matrix.
+    ///
+    /// \param[in,out] x The right hand side b as input, the solution x as output (dim rows() x any number of columns).
+    ///
+    template<typename MatrixLike>
+    void solveInPlace(const Eigen::MatrixBase<MatrixLike> & x) const;
+
+    /// \returns the unit upper triangular factor U (its diagonal is stored and equal to one).
+    const TreeSparseMatrix & matrixU() const { return m_U; }
+
+    /// \returns the diagonal of D.
+    const VectorXs & vectorD() const { return m_D; }
+
+    /// \returns the dimension of the factorized matrix.
+    int rows() const { return m_U.rows(); }
+
+  protected:
+
+    TreeSparseMatrix m_U;
+    VectorXs m_D;
+    VectorXs m_Dinv;
+    VectorXs m_tmp;
+
+  }; // struct TreeSparseLDLTTpl
+
+  typedef TreeSparseLDLTTpl<double,0> TreeSparseLDLT;
+
+  ///
+  /// \brief Compute the product of a tree sparse matrix with a vector or a matrix, only visiting the stored entries.
+  ///
+  /// \note The rows are visited one by one: for small models (a few tens of degrees of freedom), the dense product
+  ///       of Eigen may remain faster. The gain grows with the number of branches of the kinematic tree.
+  ///
+  /// \param[in] mat The tree sparse matrix.
+  /// \param[in] x The input vector or matrix (dim mat.cols() x n).
+  /// \param[out] res The result mat*x (dim mat.rows() x n).
+  ///
+  template<typename Scalar, int Options, typename MatrixLike, typename ResultMatrixType>
+  inline void treeSparseProduct(const TreeSparseMatrixTpl<Scalar,Options> & mat,
+                                const Eigen::MatrixBase<MatrixLike> & x,
+                                const Eigen::MatrixBase<ResultMatrixType> & res);
+
+} // namespace pinocchio
+
+/* --- Details -------------------------------------------------------------------- */
+#include "pinocchio/algorithm/tree-sparse-matrix.hxx"
+
+#endif // ifndef __pinocchio_algorithm_tree_sparse_matrix_hpp__
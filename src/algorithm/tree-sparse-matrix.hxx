@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_algorithm_tree_sparse_matrix_hxx__
+#define __pinocchio_algorithm_tree_sparse_matrix_hxx__
+
+#include "pinocchio/macros.hpp"
+
+/// @cond DEV
+
+namespace pinocchio
+{
+  template<typename Scalar, int Options>
+  template<template<typename,int> class JointCollectionTpl>
+  void TreeSparseMatrixTpl<Scalar,Options>::resize(const ModelTpl<Scalar,Options,JointCollectionTpl> & model)
+  {
+    m_nv = model.nv;
+    m_row_sizes.assign((size_t)model.nv,0);
+    m_parents.assign((size_t)model.nv,-1);
+    m_row_offsets.assign((size_t)model.nv+1,0);
+
+    for(JointIndex joint_id = 1; joint_id < (JointIndex)model.njoints; ++joint_id)
+    {
+      const int idx_v = model.joints[joint_id].idx_v();
+      const int nv = model.joints[joint_id].nv();
+
+      int nv_subtree = 0;
+      const typename ModelTpl<Scalar,Options,JointCollectionTpl>::IndexVector & subtree = model.subtrees[joint_id];
+      for(size_t k = 0; k < subtree.size(); ++k)
+        nv_subtree += model.joints[subtree[k]].nv();
+
+      const JointIndex parent = model.parents[joint_id];
+      if(parent > 0)
+        m_parents[(size_t)idx_v] = model.joints[parent].idx_v() + model.joints[parent].nv() - 1;
+      for(int row = 0; row < nv; ++row)
+      {
+        if(row > 0) m_parents[(size_t)(idx_v+row)] = idx_v+row-1;
+        m_row_sizes[(size_t)(idx_v+row)] = nv_subtree-row;
+      }
+    }
+
+    for(int i = 0; i < m_nv; ++i)
+      m_row_offsets[(size_t)i+1] = m_row_offsets[(size_t)i] + m_row_sizes[(size_t)i];
+    m_values.setZero(m_row_offsets[(size_t)m_nv]);
+  }
+
+  template<typename Scalar, int Options>
+  Scalar TreeSparseMatrixTpl<Scalar,Options>::coeff(const int i, const int j) const
+  {
+    const int r = std::min(i,j), c = std::max(i,j);
+    if(c-r >= m_row_sizes[(size_t)r])
+      return Scalar(0);
+    return m_values[m_row_offsets[(size_t)r]+c-r];
+  }
+
+  template<typename Scalar, int Options>
+  template<typename MatrixLike>
+  void TreeSparseMatrixTpl<Scalar,Options>::fromDense(const Eigen::MatrixBase<MatrixLike> & mat)
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(mat.rows(), m_nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(mat.cols(), m_nv);
+
+    for(int i = 0; i < m_nv; ++i)
+      row(i) = mat.row(i).segment(i,m_row_sizes[(size_t)i]).transpose();
+  }
+
+  template<typename Scalar, int Options>
+  template<typename MatrixLike>
+  void TreeSparseMatrixTpl<Scalar,Options>::toDense(const Eigen::MatrixBase<MatrixLike> & mat) const
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(mat.rows(), m_nv);
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(mat.cols(), m_nv);
+
+    MatrixLike & mat_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixLike,mat);
+    mat_.setZero();
+    for(int i = 0; i < m_nv; ++i)
+    {
+      const int n = m_row_sizes[(size_t)i];
+      mat_.row(i).segment(i,n) = row(i).transpose();
+      mat_.col(i).segment(i+1,n-1) = row(i).tail(n-1);
+    }
+  }
+
+  template<typename Scalar, int Options>
+  void TreeSparseLDLTTpl<Scalar,Options>::compute(const TreeSparseMatrix & mat)
+  {
+    const int nv = mat.rows();
+    m_U = mat;
+    m_D.resize(nv); m_Dinv.resize(nv); m_tmp.resize(nv);
+
+    // Same algorithm as cholesky::decompose, the entries of mat being overwritten by the ones of U.
+    for(int j = nv-1; j >= 0; --j)
+    {
+      const int NVT = m_U.rowSize(j)-1;
+      typename TreeSparseMatrix::RowSegment U_j = m_U.row(j);
+
+      typename VectorXs::SegmentReturnType DUt_partial = m_tmp.head(NVT);
+      DUt_partial.noalias() = U_j.tail(NVT).cwiseProduct(m_D.segment(j+1,NVT));
+
+      m_D[j] = U_j[0] - U_j.tail(NVT).dot(DUt_partial);
+      m_Dinv[j] = Scalar(1) / m_D[j];
+      U_j[0] = Scalar(1);
+
+      for(int i = m_U.parent(j); i >= 0; i = m_U.parent(i))
+      {
+        Scalar & U_ij = m_U.coeffRef(i,j);
+        U_ij = (U_ij - m_U.row(i).segment(j+1-i,NVT).dot(DUt_partial)) * m_Dinv[j];
+      }
+    }
+  }
+
+  template<typename Scalar, int Options>
+  template<typename MatrixLike>
+  void TreeSparseLDLTTpl<Scalar,Options>::solveInPlace(const Eigen::MatrixBase<MatrixLike> & x) const
+  {
+    const int nv = rows();
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(x.rows(), nv);
+
+    MatrixLike & x_ = PINOCCHIO_EIGEN_CONST_CAST(MatrixLike,x);
+
+    // x = U^-1 x
+    for(int k = nv-2; k >= 0; --k)
+    {
+      const int NVT = m_U.rowSize(k)-1;
+      if(NVT > 0)
+        x_.row(k).noalias() -= m_U.row(k).tail(NVT).transpose() * x_.middleRows(k+1,NVT);
+    }
+
+    // x = D^-1 x
+    x_ = m_Dinv.asDiagonal() * x_;
+
+    // x = U^-T x
+    for(int k = 0; k < nv-1; ++k)
+    {
+      const int NVT = m_U.rowSize(k)-1;
+      if(NVT > 0)
+        x_.middleRows(k+1,NVT).noalias() -= m_U.row(k).tail(NVT) * x_.row(k);
+    }
+  }
+
+  template<typename Scalar, int Options, typename MatrixLike, typename ResultMatrixType>
+  inline void treeSparseProduct(const TreeSparseMatrixTpl<Scalar,Options> & mat,
+                                const Eigen::MatrixBase<MatrixLike> & x,
+                                const Eigen::MatrixBase<ResultMatrixType> & res)
+  {
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(x.rows(), mat.cols());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.rows(), mat.rows());
+    PINOCCHIO_CHECK_ARGUMENT_SIZE(res.cols(), x.cols());
+
+    ResultMatrixType & res_ = PINOCCHIO_EIGEN_CONST_CAST(ResultMatrixType,res);
+    res_.setZero();
+    for(int i = 0; i < mat.rows(); ++i)
+    {
+      const int NVT = mat.rowSize(i)-1;
+      typename TreeSparseMatrixTpl<Scalar,Options>::ConstRowSegment row_i = mat.row(i);
+
+      // Upper triangular part (diagonal included) and its symmetric counterpart.
+      res_.row(i).noalias() += row_i.transpose() * x.middleRows(i,NVT+1);
+      res_.middleRows(i+1,NVT).noalias() += row_i.tail(NVT) * x.row(i);
+    }
+  }
+
+} // namespace pinocchio
+
+/// @endcond
+
+#endif // ifndef __pinocchio_algorithm_tree_sparse_matrix_hxx__
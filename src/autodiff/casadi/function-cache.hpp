@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_autodiff_casadi_function_cache_hpp__
+#define __pinocchio_autodiff_casadi_function_cache_hpp__
+
+#include "pinocchio/autodiff/casadi.hpp"
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+#include "pinocchio/algorithm/rnea.hpp"
+#include "pinocchio/algorithm/aba.hpp"
+#include "pinocchio/algorithm/crba.hpp"
+#include "pinocchio/algorithm/rnea-derivatives.hpp"
+#include "pinocchio/algorithm/aba-derivatives.hpp"
+#include "pinocchio/serialization/model.hpp"
+#include "pinocchio/utils/hash.hpp"
+#include "pinocchio/utils/version.hpp"
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+
+namespace pinocchio
+{
+  namespace casadi
+  {
+    namespace internal
+    {
+      ///
+      /// \brief Symbolic inputs (q,v,u) of an algorithm, where u is the acceleration or the torque.
+      ///
+      struct SymbolicInputs
+      {
+        typedef ModelTpl< ::casadi::SX> ADModel;
+
+        SymbolicInputs(const ModelTpl<double> & model, const std::string & u_name)
+        : cs_q(::casadi::SX::sym("q",model.nq))
+        , cs_v(::casadi::SX::sym("v",model.nv))
+        , cs_u(::casadi::SX::sym(u_name,model.nv))
+        , q(model.nq), v(model.nv), u(model.nv)
+        , names({"q","v",u_name})
+        {
+          pinocchio::casadi::copy(cs_q,q);
+          pinocchio::casadi::copy(cs_v,v);
+          pinocchio::casadi::copy(cs_u,u);
+        }
+
+        ::casadi::SXVector symbols() const
+        { return ::casadi::SXVector {cs_q,cs_v,cs_u}; }
+
+        ::casadi::SX cs_q, cs_v, cs_u;
+        ADModel::ConfigVectorType q;
+        ADModel::TangentVectorType v, u;
+        std::vector<std::string> names;
+      };
+
+      template<typename MatrixType>
+      ::casadi::SX toSX(const Eigen::MatrixBase<MatrixType> & mat)
+      {
+        ::casadi::SX res(mat.rows(),mat.cols());
+        pinocchio::casadi::copy(mat,res);
+        return res;
+      }
+    } // namespace internal
+
+    ///
+    /// \brief Function (q,v,a) -> tau of the Recursive Newton-Euler algorithm.
+    ///
+    inline ::casadi::Function buildRNEAFunction(const ModelTpl<double> & model,
+                                                const std::string & name = "rnea")
+    {
+      typedef internal::SymbolicInputs::ADModel ADModel;
+      ADModel ad_model = model.cast< ::casadi::SX>();
+      ADModel::Data ad_data(ad_model);
+
+      internal::SymbolicInputs inputs(model,"a");
+      rnea(ad_model,ad_data,inputs.q,inputs.v,inputs.u);
+
+      return ::casadi::Function(name,inputs.symbols(),
+                                ::casadi::SXVector {internal::toSX(ad_data.tau)},
+                                inputs.names,std::vector<std::string>{"tau"});
+    }
+
+    ///
+    /// \brief Function (q,v,tau) -> ddq of the Articulated Body algorithm.
+    ///
+    inline ::casadi::Function buildABAFunction(const ModelTpl<double> & model,
+                                               const std::string & name = "aba")
+    {
+      typedef internal::SymbolicInputs::ADModel ADModel;
+      ADModel ad_model = model.cast< ::casadi::SX>();
+      ADModel::Data ad_data(ad_model);
+
+      internal::SymbolicInputs inputs(model,"tau");
+      aba(ad_model,ad_data,inputs.q,inputs.v,inputs.u);
+
+      return ::casadi::Function(name,inputs.symbols(),
+                                ::casadi::SXVector {internal::toSX(ad_data.ddq)},
+                                inputs.names,std::vector<std::string>{"ddq"});
+    }
+
+    ///
+    /// \brief Function q -> M of the Composite Rigid Body algorithm, with the full joint space inertia matrix.
+    ///
+    inline ::casadi::Function buildCRBAFunction(const ModelTpl<double> & model,
+                                                const std::string & name = "crba")
+    {
+      typedef internal::SymbolicInputs::ADModel ADModel;
+      ADModel ad_model = model.cast< ::casadi::SX>();
+      ADModel::Data ad_data(ad_model);
+
+      internal::SymbolicInputs inputs(model,"a");
+      crba(ad_model,ad_data,inputs.q);
+      ad_data.M.triangularView<Eigen::StrictlyLower>()
+      = ad_data.M.transpose().triangularView<Eigen::StrictlyLower>();
+
+      return ::casadi::Function(name,::casadi::SXVector {inputs.cs_q},
+                                ::casadi::SXVector {internal::toSX(ad_data.M)},
+                                std::vector<std::string>{"q"},std::vector<std::string>{"M"});
+    }
+
+    ///
+    /// \brief Function (q,v,a) -> (dtau_dq,dtau_dv,dtau_da) of the analytical derivatives of the Recursive Newton-Euler algorithm.
+    ///
+    inline ::casadi::Function buildRNEADerivativesFunction(const ModelTpl<double> & model,
+                                                           const std::string & name = "rnea_derivatives")
+    {
+      typedef internal::SymbolicInputs::ADModel ADModel;
+      ADModel ad_model = model.cast< ::casadi::SX>();
+      ADModel::Data ad_data(ad_model);
+
+      internal::SymbolicInputs inputs(model,"a");
+      computeRNEADerivatives(ad_model,ad_data,inputs.q,inputs.v,inputs.u);
+      ad_data.M.triangularView<Eigen::StrictlyLower>()
+      = ad_data.M.transpose().triangularView<Eigen::StrictlyLower>();
+
+      return ::casadi::Function(name,inputs.symbols(),
+                                ::casadi::SXVector {internal::toSX(ad_data.dtau_dq),
+                                                    internal::toSX(ad_data.dtau_dv),
+                                                    internal::toSX(ad_data.M)},
+                                inputs.names,std::vector<std::string>{"dtau_dq","dtau_dv","dtau_da"});
+    }
+
+    ///
+    /// \brief Function (q,v,tau) -> (ddq_dq,ddq_dv,ddq_dtau) of the analytical derivatives of the Articulated Body algorithm.
+    ///
+    inline ::casadi::Function buildABADerivativesFunction(const ModelTpl<double> & model,
+                                                          const std::string & name = "aba_derivatives")
+    {
+      typedef internal::SymbolicInputs::ADModel ADModel;
+      ADModel ad_model = model.cast< ::casadi::SX>();
+      ADModel::Data ad_data(ad_model);
+
+      internal::SymbolicInputs inputs(model,"tau");
+      computeABADerivatives(ad_model,ad_data,inputs.q,inputs.v,inputs.u);
+      ad_data.Minv.triangularView<Eigen::StrictlyLower>()
+      = ad_data.Minv.transpose().triangularView<Eigen::StrictlyLower>();
+
+      return ::casadi::Function(name,inputs.symbols(),
+                                ::casadi::SXVector {internal::toSX(ad_data.ddq_dq),
+                                                    internal::toSX(ad_data.ddq_dv),
+                                                    internal::toSX(ad_data.Minv)},
+                                inputs.names,std::vector<std::string>{"ddq_dq","ddq_dv","ddq_dtau"});
+    }
+
+    ///
+    /// \brief Cache of the CasADi functions of a model.
+    ///        A function is built the first time it is requested, then saved on disk under a name depending on
+    ///        the content of the model, on the function and on the versions of Pinocchio and CasADi.
+    ///        Later requests, in the same process or in another one, load it instead of building it again.
+    ///
+    class FunctionCache
+    {
+    public:
+
+      typedef ModelTpl<double> Model;
+      typedef ::casadi::Function (*Builder)(const Model &, const std::string &);
+
+      ///
+      /// \brief Constructor.
+      ///
+      /// \param[in] model The model the functions are built from.
+      /// \param[in] cache_directory Directory where the functions are saved. It is created if needed. By default, the working directory is used.
+      ///
+      explicit FunctionCache(const Model & model,
+                             const std::string & cache_directory = "")
+      : model(model)
+      , model_hash(hashString(model.saveToString()))
+      , cache_directory(cache_directory)
+      {
+        addBuilder("rnea",&buildRNEAFunction);
+        addBuilder("aba",&buildABAFunction);
+        addBuilder("crba",&buildCRBAFunction);
+        addBuilder("rnea_derivatives",&buildRNEADerivativesFunction);
+        addBuilder("aba_derivatives",&buildABADerivativesFunction);
+      }
+
+      ///
+      /// \brief Register a builder of function. The name must identify what the builder computes,
+      ///        since the functions saved on disk are retrieved by their name.
+      ///
+      /// \param[in] name Name of the function.
+      /// \param[in] builder Builder of the function.
+      /// \param[in] version Version of the builder, part of the name of the saved function:
+      ///            changing it when the builder changes discards the functions saved by the previous versions.
+      ///
+      void addBuilder(const std::string & name, Builder builder, const std::string & version = "")
+      {
+        builders[name] = builder;
+        builder_versions[name] = version;
+      }
+
+      /// \returns true if a builder is registered under this name.
+      bool hasBuilder(const std::string & name) const
+      { return builders.find(name) != builders.end(); }
+
+      ///
+      /// \brief Get the function registered under name, loading it from the disk or building it if needed.
+      ///        A saved function which cannot be loaded (e.g. a corrupted file) is removed and built again.
+      ///
+      const ::casadi::Function & get(const std::string & name)
+      {
+        std::map<std::string,::casadi::Function>::const_iterator it = functions.find(name);
+        if(it != functions.end())
+          return it->second;
+
+        std::map<std::string,Builder>::const_iterator builder = builders.find(name);
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(builder != builders.end(), "No CasADi function is registered under the name " + name);
+
+        const std::string file = path(name);
+        if(boost::filesystem::exists(file))
+        {
+          try
+          {
+            return functions[name] = ::casadi::Function::load(file);
+          }
+          catch(const std::exception &)
+          {
+            boost::system::error_code error_code;
+            boost::filesystem::remove(file,error_code);
+          }
+        }
+
+        const ::casadi::Function f = builder->second(model,name);
+        if(!cache_directory.empty())
+          boost::filesystem::create_directories(cache_directory);
+        // save into a temporary file first, so that concurrent processes never load a partially written function
+        const std::string tmp = file + "." + boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%").string() + ".tmp";
+        f.save(tmp);
+        boost::filesystem::rename(tmp,file);
+        return functions[name] = f;
+      }
+
+      /// \returns true if the function registered under name has been saved on disk.
+      bool exists(const std::string & name) const
+      { return boost::filesystem::exists(path(name)); }
+
+      /// \returns the file where the function registered under name is saved.
+      std::string path(const std::string & name) const
+      {
+        std::ostringstream key;
+        key << printVersion() << "|" << ::casadi::CasadiMeta::version() << "|" << name;
+        std::map<std::string,std::string>::const_iterator version = builder_versions.find(name);
+        if(version != builder_versions.end())
+          key << "|" << version->second;
+        const std::string filename = name + "_" + hashToString(hashString(key.str(),model_hash)) + ".casadi";
+        if(cache_directory.empty())
+          return filename;
+        return (boost::filesystem::path(cache_directory) / filename).string();
+      }
+
+      /// \brief Directory where the functions are saved.
+      const std::string & getCacheDirectory() const { return cache_directory; }
+
+    protected:
+
+      const Model model;
+      const boost::uint64_t model_hash;
+      const std::string cache_directory;
+
+      std::map<std::string,Builder> builders;
+      std::map<std::string,std::string> builder_versions;
+      std::map<std::string,::casadi::Function> functions;
+
+    }; // class FunctionCache
+
+  } // namespace casadi
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_autodiff_casadi_function_cache_hpp__
@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_autodiff_cppad_tape_hpp__
+#define __pinocchio_autodiff_cppad_tape_hpp__
+
+#include "pinocchio/autodiff/cppad.hpp"
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+#include "pinocchio/algorithm/rnea.hpp"
+#include "pinocchio/algorithm/aba.hpp"
+
+#include <chrono>
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Record of an algorithm on a CppAD tape, where the inertias of the bodies and the placements of the joints
+  ///        are CppAD dynamic parameters: they can be changed with setModelParameters without recording the algorithm again.
+  ///        The tape also reports the time spent to record it and to evaluate it.
+  ///
+  /// \remarks The dynamic parameters require a version of CppAD released after June 2018.
+  ///
+  template<typename _Scalar>
+  struct CppADTapeTpl
+  {
+    typedef _Scalar Scalar;
+    typedef CppAD::AD<Scalar> ADScalar;
+
+    enum { Options = 0 };
+
+    typedef ModelTpl<Scalar,Options> Model;
+    typedef ModelTpl<ADScalar,Options> ADModel;
+    typedef DataTpl<ADScalar,Options> ADData;
+
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1,Options> VectorXs;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Options|Eigen::RowMajor> RowMatrixXs;
+    typedef Eigen::Matrix<ADScalar,Eigen::Dynamic,1,Options> ADVectorXs;
+
+    typedef CppAD::ADFun<Scalar> ADFun;
+
+    /// \brief Number of parameters of a joint: the 10 dynamic parameters of its inertia (see InertiaTpl::toDynamicParameters),
+    ///        then the rotation (column major) and the translation of its placement.
+    enum { NumParametersPerJoint = 10 + 9 + 3 };
+
+    explicit CppADTapeTpl(const Model & model)
+    : ad_model(model.template cast<ADScalar>())
+    , ad_data(ad_model)
+    , taping_time(0.)
+    , evaluation_time(0.)
+    , num_evaluations(0)
+    {
+      parameters = VectorXs(numParameters(model));
+      getModelParameters(model,parameters);
+    }
+
+    /// \returns the number of dynamic parameters of the tape.
+    static Eigen::DenseIndex numParameters(const Model & model)
+    { return NumParametersPerJoint * (model.njoints-1); }
+
+    ///
+    /// \brief Stack the inertias and the joint placements of the model into params (see NumParametersPerJoint).
+    ///
+    template<typename VectorLike>
+    static void getModelParameters(const Model & model,
+                                   const Eigen::MatrixBase<VectorLike> & params)
+    {
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(params.size(),numParameters(model));
+      VectorLike & params_ = PINOCCHIO_EIGEN_CONST_CAST(VectorLike,params);
+
+      Eigen::DenseIndex it = 0;
+      for(JointIndex i = 1; i < (JointIndex)model.njoints; ++i)
+      {
+        params_.template segment<10>(it) = model.inertias[i].toDynamicParameters(); it += 10;
+        for(int k = 0; k < 3; ++k)
+        {
+          params_.template segment<3>(it) = model.jointPlacements[i].rotation().col(k); it += 3;
+        }
+        params_.template segment<3>(it) = model.jointPlacements[i].translation(); it += 3;
+      }
+    }
+
+    ///
+    /// \brief Set the inertias and the joint placements of the model from params (see NumParametersPerJoint).
+    ///
+    template<typename OtherScalar, typename VectorLike>
+    static void setModelParameters(ModelTpl<OtherScalar,Options> & model,
+                                   const Eigen::MatrixBase<VectorLike> & params)
+    {
+      typedef ModelTpl<OtherScalar,Options> OtherModel;
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(params.size(),NumParametersPerJoint * (model.njoints-1));
+
+      Eigen::DenseIndex it = 0;
+      for(JointIndex i = 1; i < (JointIndex)model.njoints; ++i)
+      {
+        model.inertias[i] = OtherModel::Inertia::FromDynamicParameters(params.template segment<10>(it)); it += 10;
+        typename OtherModel::SE3 & placement = model.jointPlacements[i];
+        for(int k = 0; k < 3; ++k)
+        {
+          placement.rotation().col(k) = params.template segment<3>(it); it += 3;
+        }
+        placement.translation() = params.template segment<3>(it); it += 3;
+      }
+    }
+
+    ///
+    /// \brief Record the algorithm on the tape, with the current parameters of the model.
+    ///
+    /// \param[in] algo Functor called as algo(ad_model,ad_data,ad_x,ad_y), computing the output ad_y from the input ad_x (see RNEATapeFunctor).
+    /// \param[in] x0 Input at which the algorithm is recorded.
+    ///
+    template<typename Algorithm, typename VectorLike>
+    void record(const Algorithm & algo,
+                const Eigen::MatrixBase<VectorLike> & x0)
+    {
+      const double start = now();
+
+      ADVectorXs ad_x = x0.template cast<ADScalar>();
+      ADVectorXs ad_p = parameters.template cast<ADScalar>();
+      CppAD::Independent(ad_x,0,false,ad_p);
+
+      // the model depends on the dynamic parameters of the tape
+      setModelParameters(ad_model,ad_p);
+
+      ADVectorXs ad_y;
+      algo(ad_model,ad_data,ad_x,ad_y);
+
+      ad_fun.Dependent(ad_x,ad_y);
+      ad_fun.optimize("no_compare_op");
+
+      x = CPPAD_TESTVECTOR(Scalar)((size_t)ad_x.size());
+      y = VectorXs::Zero(ad_y.size());
+      jac = RowMatrixXs::Zero(ad_y.size(),ad_x.size());
+
+      taping_time = now() - start;
+      evaluation_time = 0.;
+      num_evaluations = 0;
+    }
+
+    ///
+    /// \brief Update the inertias and the joint placements used by the tape, without recording it again.
+    ///
+    void setModelParameters(const Model & model)
+    {
+      getModelParameters(model,parameters);
+
+      CPPAD_TESTVECTOR(Scalar) p((size_t)parameters.size());
+      Eigen::Map<VectorXs>(p.data(),parameters.size()) = parameters;
+      ad_fun.new_dynamic(p);
+    }
+
+    /// \brief Evaluate the recorded algorithm. The result is stored in y.
+    template<typename VectorLike>
+    const VectorXs & evalFunction(const Eigen::MatrixBase<VectorLike> & x_in)
+    {
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(x_in.size(),(Eigen::DenseIndex)x.size());
+      const double start = now();
+
+      Eigen::Map<VectorXs>(x.data(),x_in.size()) = x_in;
+      CPPAD_TESTVECTOR(Scalar) y_ = ad_fun.Forward(0,x);
+      y = Eigen::Map<VectorXs>(y_.data(),y.size());
+
+      evaluation_time += now() - start;
+      ++num_evaluations;
+      return y;
+    }
+
+    /// \brief Evaluate the Jacobian of the recorded algorithm. The result is stored in jac.
+    template<typename VectorLike>
+    const RowMatrixXs & evalJacobian(const Eigen::MatrixBase<VectorLike> & x_in)
+    {
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(x_in.size(),(Eigen::DenseIndex)x.size());
+      const double start = now();
+
+      Eigen::Map<VectorXs>(x.data(),x_in.size()) = x_in;
+      CPPAD_TESTVECTOR(Scalar) jac_ = ad_fun.Jacobian(x);
+      jac = Eigen::Map<RowMatrixXs>(jac_.data(),jac.rows(),jac.cols());
+
+      evaluation_time += now() - start;
+      ++num_evaluations;
+      return jac;
+    }
+
+    /// \brief Time spent to record the tape, in seconds.
+    double getTapingTime() const { return taping_time; }
+
+    /// \brief Time spent to evaluate the tape since it has been recorded, in seconds.
+    double getEvaluationTime() const { return evaluation_time; }
+
+    /// \brief Number of evaluations of the tape since it has been recorded.
+    std::size_t getNumEvaluations() const { return num_evaluations; }
+
+    /// \brief Current dynamic parameters of the tape.
+    const VectorXs & getParameters() const { return parameters; }
+
+    /// \brief Output of the last call to evalFunction.
+    VectorXs y;
+
+    /// \brief Jacobian computed by the last call to evalJacobian.
+    RowMatrixXs jac;
+
+  protected:
+
+    /// \brief Current wall-clock time in seconds, used to measure the taping and evaluation times.
+    static double now()
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ADModel ad_model;
+    ADData ad_data;
+    ADFun ad_fun;
+
+    VectorXs parameters;
+    CPPAD_TESTVECTOR(Scalar) x;
+
+    double taping_time;
+    double evaluation_time;
+    std::size_t num_evaluations;
+
+  }; // struct CppADTapeTpl
+
+  ///
+  /// \brief Records rnea on a CppADTapeTpl: the input is (q,v,a) and the output is tau.
+  ///
+  struct RNEATapeFunctor
+  {
+    template<typename ADModel, typename ADData, typename ADVector>
+    void operator()(const ADModel & model, ADData & data,
+                    const ADVector & x, ADVector & y) const
+    {
+      y = rnea(model,data,
+               x.head(model.nq),
+               x.segment(model.nq,model.nv),
+               x.tail(model.nv));
+    }
+  };
+
+  ///
+  /// \brief Records aba on a CppADTapeTpl: the input is (q,v,tau) and the output is ddq.
+  ///
+  struct ABATapeFunctor
+  {
+    template<typename ADModel, typename ADData, typename ADVector>
+    void operator()(const ADModel & model, ADData & data,
+                    const ADVector & x, ADVector & y) const
+    {
+      y = aba(model,data,
+              x.head(model.nq),
+              x.segment(model.nq,model.nv),
+              x.tail(model.nv));
+    }
+  };
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_autodiff_cppad_tape_hpp__
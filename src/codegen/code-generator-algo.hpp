@@ -13,9 +13,63 @@
 #include "pinocchio/algorithm/aba.hpp"
 #include "pinocchio/algorithm/rnea-derivatives.hpp"
 #include "pinocchio/algorithm/aba-derivatives.hpp"
+#include "pinocchio/algorithm/kinematics.hpp"
+#include "pinocchio/algorithm/frames.hpp"
+#include "pinocchio/algorithm/jacobian.hpp"
+#include "pinocchio/algorithm/center-of-mass.hpp"
+#include "pinocchio/algorithm/centroidal.hpp"
+
+#include <vector>
+#include <sstream>
+#include <algorithm>
 
 namespace pinocchio
 {
+  namespace internal
+  {
+    ///
+    /// \brief Append to (rows,cols) the entries of a Jacobian which can be non-zero because of the kinematic tree:
+    ///        the torque of a joint only depends on the joints of its support and of its subtree.
+    ///
+    /// \param[in] model The model structure of the rigid body system.
+    /// \param[in] col_offset Index of the first column of the block.
+    /// \param[in] wrt_configuration If true, the columns of the block correspond to the configuration vector (dim model.nq), otherwise to the tangent space (dim model.nv).
+    /// \param[out] rows Row indexes of the entries.
+    /// \param[out] cols Column indexes of the entries.
+    ///
+    template<typename Model>
+    void appendKinematicTreeSparsity(const Model & model,
+                                     const std::size_t col_offset,
+                                     const bool wrt_configuration,
+                                     std::vector<std::size_t> & rows,
+                                     std::vector<std::size_t> & cols)
+    {
+      for(JointIndex i = 1; i < (JointIndex)model.njoints; ++i)
+      {
+        const std::vector<JointIndex> & support_i = model.supports[i];
+        for(JointIndex j = 1; j < (JointIndex)model.njoints; ++j)
+        {
+          const std::vector<JointIndex> & support_j = model.supports[j];
+          const bool same_branch = (j <= i && std::find(support_i.begin(),support_i.end(),j) != support_i.end())
+                                || (i < j && std::find(support_j.begin(),support_j.end(),i) != support_j.end());
+          if(!same_branch)
+            continue;
+          
+          const int idx_j = wrt_configuration ? model.joints[j].idx_q() : model.joints[j].idx_v();
+          const int n_j = wrt_configuration ? model.joints[j].nq() : model.joints[j].nv();
+          for(int r = model.joints[i].idx_v(); r < model.joints[i].idx_v() + model.joints[i].nv(); ++r)
+          {
+            for(int c = idx_j; c < idx_j + n_j; ++c)
+            {
+              rows.push_back((std::size_t)r);
+              cols.push_back(col_offset + (std::size_t)c);
+            }
+          }
+        }
+      }
+    }
+  } // namespace internal
+  
   template<typename _Scalar>
   struct CodeGenRNEA : public CodeGenBase<_Scalar>
   {
@@ -27,6 +81,7 @@ namespace pinocchio
     typedef typename Base::ADTangentVectorType ADTangentVectorType;
     typedef typename Base::MatrixXs MatrixXs;
     typedef typename Base::VectorXs VectorXs;
+    typedef typename Base::SparseMatrixXs SparseMatrixXs;
     
     CodeGenRNEA(const Model & model,
                 const std::string & function_name = "rnea",
@@ -42,8 +97,18 @@ namespace pinocchio
       dtau_dq = MatrixXs::Zero(model.nv,model.nq);
       dtau_dv = MatrixXs::Zero(model.nv,model.nv);
       dtau_da = MatrixXs::Zero(model.nv,model.nv);
+      
+      // sparsity pattern of the derivatives, used when the sparse Jacobian is built
+      internal::appendKinematicTreeSparsity(model,0,true,
+                                            Base::jacobian_sparsity_rows,Base::jacobian_sparsity_cols);
+      internal::appendKinematicTreeSparsity(model,(std::size_t)model.nq,false,
+                                            Base::jacobian_sparsity_rows,Base::jacobian_sparsity_cols);
+      internal::appendKinematicTreeSparsity(model,(std::size_t)(model.nq+model.nv),false,
+                                            Base::jacobian_sparsity_rows,Base::jacobian_sparsity_cols);
     }
     
+    std::string getGeneratorTag() const { return "CodeGenRNEA"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -96,8 +161,35 @@ namespace pinocchio
       dtau_da = Base::jac.middleCols(it,ad_model.nv); it += ad_model.nv;
     }
     
+    using Base::evalSparseJacobian;
+    template<typename ConfigVectorType, typename TangentVector1, typename TangentVector2>
+    void evalSparseJacobian(const Eigen::MatrixBase<ConfigVectorType> & q,
+                            const Eigen::MatrixBase<TangentVector1> & v,
+                            const Eigen::MatrixBase<TangentVector2> & a)
+    {
+      // fill x
+      Eigen::DenseIndex it = 0;
+      x.segment(it,ad_model.nq) = q; it += ad_model.nq;
+      x.segment(it,ad_model.nv) = v; it += ad_model.nv;
+      x.segment(it,ad_model.nv) = a; it += ad_model.nv;
+      
+      evalSparseJacobian(x);
+      
+      // sparse_jac is stored column by column: the values of each block of columns are contiguous,
+      // and they are copied into the patterns set by initSparseJacobian.
+      const Scalar * values = Base::sparse_jac.valuePtr();
+      const typename SparseMatrixXs::StorageIndex * outer = Base::sparse_jac.outerIndexPtr();
+      it = 0;
+      std::copy(values + outer[it], values + outer[it+ad_model.nq], sparse_dtau_dq.valuePtr()); it += ad_model.nq;
+      std::copy(values + outer[it], values + outer[it+ad_model.nv], sparse_dtau_dv.valuePtr()); it += ad_model.nv;
+      std::copy(values + outer[it], values + outer[it+ad_model.nv], sparse_dtau_da.valuePtr()); it += ad_model.nv;
+    }
+    
     MatrixXs dtau_dq, dtau_dv, dtau_da;
     
+    /// \brief Derivatives computed by evalSparseJacobian, restricted to their structurally non-zero entries
+    SparseMatrixXs sparse_dtau_dq, sparse_dtau_dv, sparse_dtau_da;
+    
   protected:
     
     using Base::ad_model;
@@ -108,6 +200,19 @@ namespace pinocchio
     using Base::y;
     using Base::jac;
     
+    void initSparseJacobian()
+    {
+      Base::initSparseJacobian();
+      
+      Eigen::DenseIndex it = 0;
+      sparse_dtau_dq = Base::sparse_jac.middleCols(it,ad_model.nq); it += ad_model.nq;
+      sparse_dtau_dv = Base::sparse_jac.middleCols(it,ad_model.nv); it += ad_model.nv;
+      sparse_dtau_da = Base::sparse_jac.middleCols(it,ad_model.nv); it += ad_model.nv;
+      sparse_dtau_dq.makeCompressed();
+      sparse_dtau_dv.makeCompressed();
+      sparse_dtau_da.makeCompressed();
+    }
+    
     VectorXs x;
     VectorXs res;
     
@@ -143,6 +248,8 @@ namespace pinocchio
       da_dtau = MatrixXs::Zero(model.nv,model.nv);
     }
 
+    std::string getGeneratorTag() const { return "CodeGenABA"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -240,6 +347,8 @@ namespace pinocchio
       Base::build_jacobian = false;
     }
     
+    std::string getGeneratorTag() const { return "CodeGenCRBA"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -329,6 +438,8 @@ namespace pinocchio
       Base::build_jacobian = false;
     }
     
+    std::string getGeneratorTag() const { return "CodeGenMinv"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -429,6 +540,8 @@ namespace pinocchio
       Base::build_jacobian = false;
     }
     
+    std::string getGeneratorTag() const { return "CodeGenRNEADerivatives"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -538,6 +651,8 @@ namespace pinocchio
       Base::build_jacobian = false;
     }
     
+    std::string getGeneratorTag() const { return "CodeGenABADerivatives"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -630,6 +745,8 @@ namespace pinocchio
       res = VectorXs::Zero(Base::getOutputDimension());
     }
     
+    std::string getGeneratorTag() const { return "CodeGenIntegrate"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -697,6 +814,8 @@ namespace pinocchio
       res = VectorXs::Zero(Base::getOutputDimension());
     }
     
+    std::string getGeneratorTag() const { return "CodeGenDifference"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -767,6 +886,8 @@ namespace pinocchio
       x = VectorXs::Zero(Base::getInputDimension());
     }
     
+    std::string getGeneratorTag() const { return "CodeGenDDifference"; }
+    
     void buildMap()
     {
       CppAD::Independent(ad_X);
@@ -827,6 +948,487 @@ namespace pinocchio
     ADMatrixXs ad_J1;
   };
 
+  namespace internal
+  {
+    ///
+    /// \brief Check the frame indexes given to a code generator and describe them for the library hash.
+    ///
+    template<typename Model>
+    std::string codeGenFramesOptions(const Model & model,
+                                     const std::vector<FrameIndex> & frame_ids,
+                                     const ReferenceFrame rf)
+    {
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(!frame_ids.empty(), "The list of frames is empty.");
+      std::ostringstream oss;
+      oss << "rf:" << rf << "|frames:";
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(frame_ids[k] < (FrameIndex)model.nframes, "A frame index is out of range.");
+        oss << frame_ids[k] << ",";
+      }
+      return oss.str();
+    }
+  } // namespace internal
+  
+  ///
+  /// \brief Placements of a list of frames, expressed in the world frame.
+  ///        The list of frames is fixed at generation time. The output stores, for each frame, its rotation (column major) followed by its translation.
+  ///
+  template<typename _Scalar>
+  struct CodeGenFramePlacements : public CodeGenBase<_Scalar>
+  {
+    typedef CodeGenBase<_Scalar> Base;
+    typedef typename Base::Scalar Scalar;
+    
+    typedef typename Base::Model Model;
+    typedef typename Base::Data Data;
+    typedef typename Base::ADConfigVectorType ADConfigVectorType;
+    typedef typename Base::MatrixXs MatrixXs;
+    typedef typename Base::VectorXs VectorXs;
+    typedef typename Data::SE3 SE3;
+    
+    enum { OutputSizePerFrame = 12 };
+    
+    CodeGenFramePlacements(const Model & model,
+                           const std::vector<FrameIndex> & frame_ids,
+                           const std::string & function_name = "frame_placements",
+                           const std::string & library_name = "cg_frame_placements_eval")
+    : Base(model,model.nq,OutputSizePerFrame*(Eigen::DenseIndex)frame_ids.size(),function_name,library_name)
+    , frame_ids(frame_ids)
+    , oMf(frame_ids.size(),SE3::Identity())
+    {
+      Base::function_options = internal::codeGenFramesOptions(model,frame_ids,WORLD);
+      ad_q = ADConfigVectorType(model.nq); ad_q = neutral(ad_model);
+      x = VectorXs::Zero(Base::getInputDimension());
+    }
+    
+    std::string getGeneratorTag() const { return "CodeGenFramePlacements"; }
+    
+    void buildMap()
+    {
+      CppAD::Independent(ad_X);
+      
+      ad_q = ad_X;
+      pinocchio::framesForwardKinematics(ad_model,ad_data,ad_q);
+      
+      Eigen::DenseIndex it = 0;
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        const typename Base::ADData::SE3 & ad_oMf = ad_data.oMf[frame_ids[k]];
+        Eigen::Map<typename Base::ADMatrixXs>(ad_Y.data()+it,3,3) = ad_oMf.rotation(); it += 9;
+        ad_Y.segment(it,3) = ad_oMf.translation(); it += 3;
+      }
+      
+      ad_fun.Dependent(ad_X,ad_Y);
+      ad_fun.optimize("no_compare_op");
+    }
+    
+    using Base::evalFunction;
+    template<typename ConfigVectorType>
+    void evalFunction(const Eigen::MatrixBase<ConfigVectorType> & q)
+    {
+      x = q;
+      evalFunction(x);
+      
+      Eigen::DenseIndex it = 0;
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        oMf[k].rotation() = Eigen::Map<MatrixXs>(Base::y.data()+it,3,3); it += 9;
+        oMf[k].translation() = Base::y.segment(it,3); it += 3;
+      }
+    }
+    
+    /// \brief Frames the function is generated for
+    const std::vector<FrameIndex> frame_ids;
+    
+    /// \brief Placements of the frames, in the order of frame_ids
+    PINOCCHIO_ALIGNED_STD_VECTOR(SE3) oMf;
+    
+  protected:
+    
+    using Base::ad_model;
+    using Base::ad_data;
+    using Base::ad_fun;
+    using Base::ad_X;
+    using Base::ad_Y;
+    using Base::y;
+    
+    VectorXs x;
+    
+    ADConfigVectorType ad_q;
+  };
+  
+  ///
+  /// \brief Jacobians of a list of frames, expressed in a given reference frame (see getFrameJacobian).
+  ///        The list of frames and the reference frame are fixed at generation time.
+  ///
+  template<typename _Scalar>
+  struct CodeGenFrameJacobians : public CodeGenBase<_Scalar>
+  {
+    typedef CodeGenBase<_Scalar> Base;
+    typedef typename Base::Scalar Scalar;
+    
+    typedef typename Base::Model Model;
+    typedef typename Base::Data Data;
+    typedef typename Base::ADData ADData;
+    typedef typename Base::ADConfigVectorType ADConfigVectorType;
+    typedef typename Base::MatrixXs MatrixXs;
+    typedef typename Base::VectorXs VectorXs;
+    typedef typename Data::Matrix6x Matrix6x;
+    
+    CodeGenFrameJacobians(const Model & model,
+                          const std::vector<FrameIndex> & frame_ids,
+                          const ReferenceFrame rf = LOCAL,
+                          const std::string & function_name = "frame_jacobians",
+                          const std::string & library_name = "cg_frame_jacobians_eval")
+    : Base(model,model.nq,6*model.nv*(Eigen::DenseIndex)frame_ids.size(),function_name,library_name)
+    , frame_ids(frame_ids)
+    , reference_frame(rf)
+    , J(frame_ids.size(),Matrix6x::Zero(6,model.nv))
+    {
+      Base::function_options = internal::codeGenFramesOptions(model,frame_ids,rf);
+      Base::build_jacobian = false;
+      ad_q = ADConfigVectorType(model.nq); ad_q = neutral(ad_model);
+      ad_J = ADMatrix6x::Zero(6,model.nv);
+      x = VectorXs::Zero(Base::getInputDimension());
+    }
+    
+    std::string getGeneratorTag() const { return "CodeGenFrameJacobians"; }
+    
+    void buildMap()
+    {
+      CppAD::Independent(ad_X);
+      
+      ad_q = ad_X;
+      pinocchio::computeJointJacobians(ad_model,ad_data,ad_q);
+      
+      Eigen::DenseIndex it = 0;
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        ad_J.setZero();
+        pinocchio::getFrameJacobian(ad_model,ad_data,frame_ids[k],reference_frame,ad_J);
+        Eigen::Map<ADMatrix6x>(ad_Y.data()+it,6,ad_model.nv) = ad_J; it += 6*ad_model.nv;
+      }
+      
+      ad_fun.Dependent(ad_X,ad_Y);
+      ad_fun.optimize("no_compare_op");
+    }
+    
+    using Base::evalFunction;
+    template<typename ConfigVectorType>
+    void evalFunction(const Eigen::MatrixBase<ConfigVectorType> & q)
+    {
+      x = q;
+      evalFunction(x);
+      
+      Eigen::DenseIndex it = 0;
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        J[k] = Eigen::Map<Matrix6x>(Base::y.data()+it,6,ad_model.nv); it += 6*ad_model.nv;
+      }
+    }
+    
+    /// \brief Frames the function is generated for
+    const std::vector<FrameIndex> frame_ids;
+    
+    /// \brief Reference frame in which the Jacobians are expressed
+    const ReferenceFrame reference_frame;
+    
+    /// \brief Jacobians of the frames, in the order of frame_ids
+    PINOCCHIO_ALIGNED_STD_VECTOR(Matrix6x) J;
+    
+  protected:
+    
+    typedef typename ADData::Matrix6x ADMatrix6x;
+    
+    using Base::ad_model;
+    using Base::ad_data;
+    using Base::ad_fun;
+    using Base::ad_X;
+    using Base::ad_Y;
+    using Base::y;
+    
+    VectorXs x;
+    
+    ADConfigVectorType ad_q;
+    ADMatrix6x ad_J;
+  };
+  
+  ///
+  /// \brief Spatial velocities and accelerations of a list of frames, expressed in a given reference frame
+  ///        (see getFrameVelocity and getFrameAcceleration).
+  ///        The list of frames and the reference frame are fixed at generation time.
+  ///        The output stores, for each frame, its velocity followed by its acceleration.
+  ///
+  template<typename _Scalar>
+  struct CodeGenFrameKinematics : public CodeGenBase<_Scalar>
+  {
+    typedef CodeGenBase<_Scalar> Base;
+    typedef typename Base::Scalar Scalar;
+    
+    typedef typename Base::Model Model;
+    typedef typename Base::Data Data;
+    typedef typename Base::ADConfigVectorType ADConfigVectorType;
+    typedef typename Base::ADTangentVectorType ADTangentVectorType;
+    typedef typename Base::MatrixXs MatrixXs;
+    typedef typename Base::VectorXs VectorXs;
+    typedef typename Data::Motion Motion;
+    
+    enum { OutputSizePerFrame = 12 };
+    
+    CodeGenFrameKinematics(const Model & model,
+                           const std::vector<FrameIndex> & frame_ids,
+                           const ReferenceFrame rf = LOCAL,
+                           const std::string & function_name = "frame_kinematics",
+                           const std::string & library_name = "cg_frame_kinematics_eval")
+    : Base(model,model.nq+2*model.nv,OutputSizePerFrame*(Eigen::DenseIndex)frame_ids.size(),function_name,library_name)
+    , frame_ids(frame_ids)
+    , reference_frame(rf)
+    , frame_v(frame_ids.size(),Motion::Zero())
+    , frame_a(frame_ids.size(),Motion::Zero())
+    {
+      Base::function_options = internal::codeGenFramesOptions(model,frame_ids,rf);
+      ad_q = ADConfigVectorType(model.nq); ad_q = neutral(ad_model);
+      ad_v = ADTangentVectorType(model.nv); ad_v.setZero();
+      ad_a = ADTangentVectorType(model.nv); ad_a.setZero();
+      x = VectorXs::Zero(Base::getInputDimension());
+    }
+    
+    std::string getGeneratorTag() const { return "CodeGenFrameKinematics"; }
+    
+    void buildMap()
+    {
+      CppAD::Independent(ad_X);
+      
+      Eigen::DenseIndex it = 0;
+      ad_q = ad_X.segment(it,ad_model.nq); it += ad_model.nq;
+      ad_v = ad_X.segment(it,ad_model.nv); it += ad_model.nv;
+      ad_a = ad_X.segment(it,ad_model.nv); it += ad_model.nv;
+      
+      pinocchio::forwardKinematics(ad_model,ad_data,ad_q,ad_v,ad_a);
+      
+      it = 0;
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        ad_Y.segment(it,6) = pinocchio::getFrameVelocity(ad_model,ad_data,frame_ids[k],reference_frame).toVector(); it += 6;
+        ad_Y.segment(it,6) = pinocchio::getFrameAcceleration(ad_model,ad_data,frame_ids[k],reference_frame).toVector(); it += 6;
+      }
+      
+      ad_fun.Dependent(ad_X,ad_Y);
+      ad_fun.optimize("no_compare_op");
+    }
+    
+    using Base::evalFunction;
+    template<typename ConfigVectorType, typename TangentVector1, typename TangentVector2>
+    void evalFunction(const Eigen::MatrixBase<ConfigVectorType> & q,
+                      const Eigen::MatrixBase<TangentVector1> & v,
+                      const Eigen::MatrixBase<TangentVector2> & a)
+    {
+      // fill x
+      Eigen::DenseIndex it = 0;
+      x.segment(it,ad_model.nq) = q; it += ad_model.nq;
+      x.segment(it,ad_model.nv) = v; it += ad_model.nv;
+      x.segment(it,ad_model.nv) = a; it += ad_model.nv;
+      
+      evalFunction(x);
+      
+      it = 0;
+      for(std::size_t k = 0; k < frame_ids.size(); ++k)
+      {
+        frame_v[k].toVector() = Base::y.segment(it,6); it += 6;
+        frame_a[k].toVector() = Base::y.segment(it,6); it += 6;
+      }
+    }
+    
+    /// \brief Frames the function is generated for
+    const std::vector<FrameIndex> frame_ids;
+    
+    /// \brief Reference frame in which the velocities and accelerations are expressed
+    const ReferenceFrame reference_frame;
+    
+    /// \brief Spatial velocities and accelerations of the frames, in the order of frame_ids
+    PINOCCHIO_ALIGNED_STD_VECTOR(Motion) frame_v, frame_a;
+    
+  protected:
+    
+    using Base::ad_model;
+    using Base::ad_data;
+    using Base::ad_fun;
+    using Base::ad_X;
+    using Base::ad_Y;
+    using Base::y;
+    
+    VectorXs x;
+    
+    ADConfigVectorType ad_q;
+    ADTangentVectorType ad_v, ad_a;
+  };
+  
+  ///
+  /// \brief Center of mass of the whole system and its Jacobian, expressed in the world frame (see jacobianCenterOfMass).
+  ///
+  template<typename _Scalar>
+  struct CodeGenCenterOfMass : public CodeGenBase<_Scalar>
+  {
+    typedef CodeGenBase<_Scalar> Base;
+    typedef typename Base::Scalar Scalar;
+    
+    typedef typename Base::Model Model;
+    typedef typename Base::Data Data;
+    typedef typename Base::ADData ADData;
+    typedef typename Base::ADConfigVectorType ADConfigVectorType;
+    typedef typename Base::MatrixXs MatrixXs;
+    typedef typename Base::VectorXs VectorXs;
+    typedef typename Data::Vector3 Vector3;
+    typedef typename Data::Matrix3x Matrix3x;
+    
+    CodeGenCenterOfMass(const Model & model,
+                        const std::string & function_name = "com",
+                        const std::string & library_name = "cg_com_eval")
+    : Base(model,model.nq,3+3*model.nv,function_name,library_name)
+    {
+      Base::build_jacobian = false;
+      ad_q = ADConfigVectorType(model.nq); ad_q = neutral(ad_model);
+      x = VectorXs::Zero(Base::getInputDimension());
+      
+      com.setZero();
+      Jcom = Matrix3x::Zero(3,model.nv);
+    }
+    
+    std::string getGeneratorTag() const { return "CodeGenCenterOfMass"; }
+    
+    void buildMap()
+    {
+      CppAD::Independent(ad_X);
+      
+      ad_q = ad_X;
+      pinocchio::jacobianCenterOfMass(ad_model,ad_data,ad_q,false);
+      
+      ad_Y.head(3) = ad_data.com[0];
+      Eigen::Map<typename ADData::Matrix3x>(ad_Y.data()+3,3,ad_model.nv) = ad_data.Jcom;
+      
+      ad_fun.Dependent(ad_X,ad_Y);
+      ad_fun.optimize("no_compare_op");
+    }
+    
+    using Base::evalFunction;
+    template<typename ConfigVectorType>
+    void evalFunction(const Eigen::MatrixBase<ConfigVectorType> & q)
+    {
+      x = q;
+      evalFunction(x);
+      
+      com = Base::y.head(3);
+      Jcom = Eigen::Map<Matrix3x>(Base::y.data()+3,3,ad_model.nv);
+    }
+    
+    /// \brief Center of mass of the system
+    Vector3 com;
+    /// \brief Jacobian of the center of mass
+    Matrix3x Jcom;
+    
+  protected:
+    
+    using Base::ad_model;
+    using Base::ad_data;
+    using Base::ad_fun;
+    using Base::ad_X;
+    using Base::ad_Y;
+    using Base::y;
+    
+    VectorXs x;
+    
+    ADConfigVectorType ad_q;
+  };
+  
+  ///
+  /// \brief Centroidal momentum matrix and centroidal momentum (see ccrba).
+  ///
+  template<typename _Scalar>
+  struct CodeGenCCRBA : public CodeGenBase<_Scalar>
+  {
+    typedef CodeGenBase<_Scalar> Base;
+    typedef typename Base::Scalar Scalar;
+    
+    typedef typename Base::Model Model;
+    typedef typename Base::Data Data;
+    typedef typename Base::ADData ADData;
+    typedef typename Base::ADConfigVectorType ADConfigVectorType;
+    typedef typename Base::ADTangentVectorType ADTangentVectorType;
+    typedef typename Base::MatrixXs MatrixXs;
+    typedef typename Base::VectorXs VectorXs;
+    typedef typename Data::Matrix6x Matrix6x;
+    typedef typename Data::Force Force;
+    
+    CodeGenCCRBA(const Model & model,
+                 const std::string & function_name = "ccrba",
+                 const std::string & library_name = "cg_ccrba_eval")
+    : Base(model,model.nq+model.nv,6*model.nv+6,function_name,library_name)
+    {
+      Base::build_jacobian = false;
+      ad_q = ADConfigVectorType(model.nq); ad_q = neutral(ad_model);
+      ad_v = ADTangentVectorType(model.nv); ad_v.setZero();
+      x = VectorXs::Zero(Base::getInputDimension());
+      
+      Ag = Matrix6x::Zero(6,model.nv);
+      hg.setZero();
+    }
+    
+    std::string getGeneratorTag() const { return "CodeGenCCRBA"; }
+    
+    void buildMap()
+    {
+      CppAD::Independent(ad_X);
+      
+      Eigen::DenseIndex it = 0;
+      ad_q = ad_X.segment(it,ad_model.nq); it += ad_model.nq;
+      ad_v = ad_X.segment(it,ad_model.nv); it += ad_model.nv;
+      
+      pinocchio::ccrba(ad_model,ad_data,ad_q,ad_v);
+      
+      Eigen::Map<typename ADData::Matrix6x>(ad_Y.data(),6,ad_model.nv) = ad_data.Ag;
+      ad_Y.tail(6) = ad_data.hg.toVector();
+      
+      ad_fun.Dependent(ad_X,ad_Y);
+      ad_fun.optimize("no_compare_op");
+    }
+    
+    using Base::evalFunction;
+    template<typename ConfigVectorType, typename TangentVector>
+    void evalFunction(const Eigen::MatrixBase<ConfigVectorType> & q,
+                      const Eigen::MatrixBase<TangentVector> & v)
+    {
+      // fill x
+      Eigen::DenseIndex it = 0;
+      x.segment(it,ad_model.nq) = q; it += ad_model.nq;
+      x.segment(it,ad_model.nv) = v; it += ad_model.nv;
+      
+      evalFunction(x);
+      
+      Ag = Eigen::Map<Matrix6x>(Base::y.data(),6,ad_model.nv);
+      hg.toVector() = Base::y.tail(6);
+    }
+    
+    /// \brief Centroidal momentum matrix
+    Matrix6x Ag;
+    /// \brief Centroidal momentum
+    Force hg;
+    
+  protected:
+    
+    using Base::ad_model;
+    using Base::ad_data;
+    using Base::ad_fun;
+    using Base::ad_X;
+    using Base::ad_Y;
+    using Base::y;
+    
+    VectorXs x;
+    
+    ADConfigVectorType ad_q;
+    ADTangentVectorType ad_v;
+  };
+
 } // namespace pinocchio
 
 #endif // ifndef __pinocchio_codegen_code_generator_algo_hpp__
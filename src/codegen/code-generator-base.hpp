@@ -6,13 +6,152 @@
 #define __pinocchio_utils_code_generator_base_hpp__
 
 #include "pinocchio/codegen/cppadcg.hpp"
+#include "pinocchio/codegen/parallel-compiler.hpp"
 
 #include "pinocchio/multibody/model.hpp"
 #include "pinocchio/multibody/data.hpp"
+#include "pinocchio/serialization/model.hpp"
+#include "pinocchio/utils/hash.hpp"
+#include "pinocchio/utils/version.hpp"
+#include "pinocchio/utils/openmp.hpp"
+
+#include <Eigen/Sparse>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 namespace pinocchio
 {
   
+  namespace internal
+  {
+    ///
+    /// \returns the path, without extension, of the library named library_name and identified by hash in the cache directory.
+    ///
+    inline std::string codeGenLibraryPath(const std::string & library_name,
+                                          const boost::uint64_t hash,
+                                          const std::string & cache_directory)
+    {
+      const std::string library_file = library_name + "_" + hashToString(hash);
+      if(cache_directory.empty())
+        return library_file;
+      
+      boost::filesystem::create_directories(cache_directory);
+      return (boost::filesystem::path(cache_directory) / library_file).string();
+    }
+    
+    ///
+    /// \brief Save the sources generated by libcgen and compile them into the library library_file (without extension).
+    ///        The sources are compiled concurrently, and each object file is cached in the cache directory:
+    ///        only the sources which differ from a previous compilation are rebuilt.
+    ///        The sources are generated in a directory unique to this call, so that concurrent generations of the same library never mix their files,
+    ///        and are then moved to library_file + "_sources", which holds the sources of the last generation.
+    ///
+    template<typename Scalar>
+    void compileCodeGenLibrary(CppAD::cg::ModelLibraryCSourceGen<Scalar> & libcgen,
+                               const std::string & library_file,
+                               const std::string & cache_directory,
+                               const std::string & compiler_path,
+                               const std::vector<std::string> & compile_flags,
+                               const std::size_t compile_jobs)
+    {
+      const std::string sources_directory = library_file + "_sources";
+      const std::string generation_directory
+      = sources_directory + "." + boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%").string() + ".tmp";
+      boost::system::error_code error_code;
+      try
+      {
+        boost::filesystem::create_directories(generation_directory);
+        
+        CppAD::cg::SaveFilesModelLibraryProcessor<Scalar> source_saver(libcgen);
+        source_saver.saveSourcesTo(generation_directory);
+        
+        std::vector<std::string> sources;
+        for(boost::filesystem::directory_iterator it(generation_directory), end; it != end; ++it)
+        {
+          if(it->path().extension() == ".c")
+            sources.push_back(it->path().string());
+        }
+        std::sort(sources.begin(),sources.end());
+        
+        const boost::filesystem::path cache_path(cache_directory.empty() ? "." : cache_directory);
+        ParallelCCompiler compiler((cache_path / "cg_objects").string(),compile_jobs,compiler_path);
+        compiler.compile_flags = compile_flags;
+        compiler.createDynamicLibrary(sources,library_file + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION);
+      }
+      catch(...)
+      {
+        boost::filesystem::remove_all(generation_directory,error_code);
+        throw;
+      }
+      
+      // The object files remain cached by content: the sources are only kept for inspection.
+      boost::filesystem::remove_all(sources_directory,error_code);
+      boost::filesystem::rename(generation_directory,sources_directory,error_code);
+      if(error_code) // another process has just moved its own sources
+        boost::filesystem::remove_all(generation_directory,error_code);
+    }
+    
+    /// \returns true if the library library_file (without extension) exists.
+    inline bool existCodeGenLibrary(const std::string & library_file)
+    {
+      const std::string filename = library_file + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+      std::ifstream file(filename.c_str());
+      return file.good();
+    }
+    
+    /// \brief Open the library handled by manager.
+    template<typename Scalar>
+    std::shared_ptr<CppAD::cg::DynamicLib<Scalar> >
+    loadCodeGenLibrary(CppAD::cg::DynamicModelLibraryProcessor<Scalar> & manager)
+    {
+      const std::string filename = manager.getLibraryName() + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+      const auto it = manager.getOptions().find("dlOpenMode");
+      if (it == manager.getOptions().end())
+        return std::make_shared<CppAD::cg::LinuxDynamicLib<Scalar> >(filename);
+      
+      int dlOpenMode = std::stoi(it->second);
+      return std::make_shared<CppAD::cg::LinuxDynamicLib<Scalar> >(filename,dlOpenMode);
+    }
+    
+    ///
+    /// \brief Open the library handled by manager and check that it contains all the functions named in function_names.
+    ///
+    /// \returns the opened library, or an empty pointer if the library cannot be opened (e.g. a truncated or corrupted file) or misses a function.
+    ///
+    template<typename Scalar>
+    std::shared_ptr<CppAD::cg::DynamicLib<Scalar> >
+    openValidCodeGenLibrary(CppAD::cg::DynamicModelLibraryProcessor<Scalar> & manager,
+                            const std::vector<std::string> & function_names)
+    {
+      std::shared_ptr<CppAD::cg::DynamicLib<Scalar> > lib;
+      try
+      {
+        lib = loadCodeGenLibrary(manager);
+      }
+      catch(const std::exception &)
+      {
+        return std::shared_ptr<CppAD::cg::DynamicLib<Scalar> >();
+      }
+      
+      const std::set<std::string> names = lib->getModelNames();
+      for(std::vector<std::string>::const_iterator it = function_names.begin(); it != function_names.end(); ++it)
+      {
+        if(names.find(*it) == names.end())
+          return std::shared_ptr<CppAD::cg::DynamicLib<Scalar> >();
+      }
+      return lib;
+    }
+  } // namespace internal
+  
   template<typename _Scalar>
   struct CodeGenBase
   {
@@ -34,6 +173,7 @@ namespace pinocchio
     typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Options|Eigen::RowMajor> RowMatrixXs;
     typedef Eigen::Matrix<ADScalar,Eigen::Dynamic,1,Options> ADVectorXs;
     typedef Eigen::Matrix<ADScalar,Eigen::Dynamic,Eigen::Dynamic,Options> ADMatrixXs;
+    typedef Eigen::SparseMatrix<Scalar,Options> SparseMatrixXs;
     
     typedef typename Model::ConfigVectorType ConfigVectorType;
     typedef typename Model::TangentVectorType TangentVectorType;
@@ -54,6 +194,10 @@ namespace pinocchio
     , library_name(library_name + "_" + model.name)
     , build_forward(true)
     , build_jacobian(true)
+    , build_sparse_jacobian(false)
+    , model_hash(hashString(model.saveToString()))
+    , compile_jobs(0)
+    , max_assignments_per_function(0)
     {
       ad_X = ADVectorXs(dim_input);
       ad_Y = ADVectorXs(dim_output);
@@ -61,12 +205,28 @@ namespace pinocchio
       y = VectorXs(ad_Y.size());
       
       jac = RowMatrixXs(ad_Y.size(),ad_X.size());
+      
+      CppAD::cg::GccCompiler<Scalar> compiler;
+      compiler_path = compiler.getCompilerPath();
+      compile_flags = compiler.getCompileFlags();
+      compile_flags[0] = "-Ofast";
     }
     
     /// \brief build the mapping Y = f(X)
     virtual void buildMap() = 0;
     
-    void initLib()
+    ///
+    /// \brief Tag identifying the kind of generated function in the hash of the library (see getLibraryHash).
+    ///        Each generator returns its own tag, so that two generators with the same names and dimensions never share a library:
+    ///        a class deriving from CodeGenBase should override it.
+    ///
+    virtual std::string getGeneratorTag() const { return "CodeGenBase"; }
+    
+    ///
+    /// \brief Tape the function and create its source generator, without creating a library.
+    ///        This is the first step of initLib, also used by CodeGenLibrary to gather several functions in one library.
+    ///
+    void initCodeGenerator()
     {
       buildMap();
       
@@ -74,50 +234,157 @@ namespace pinocchio
       cgen_ptr = std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> >(new CppAD::cg::ModelCSourceGen<Scalar>(ad_fun, function_name));
       cgen_ptr->setCreateForwardZero(build_forward);
       cgen_ptr->setCreateJacobian(build_jacobian);
+      cgen_ptr->setCreateSparseJacobian(build_sparse_jacobian);
+      if(build_sparse_jacobian && !jacobian_sparsity_rows.empty())
+        cgen_ptr->setCustomSparseJacobianElements(jacobian_sparsity_rows,jacobian_sparsity_cols);
+      if(max_assignments_per_function > 0)
+        cgen_ptr->setMaxAssignmentsPerFunc(max_assignments_per_function);
+    }
+    
+    void initLib()
+    {
+      initCodeGenerator();
+      
       libcgen_ptr = std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> >(new CppAD::cg::ModelLibraryCSourceGen<Scalar>(*cgen_ptr));
       
+      // the library is cached under a name depending on everything which impacts the generated code
+      const std::string library_path = internal::codeGenLibraryPath(library_name,getLibraryHash(),cache_directory);
+      
       dynamicLibManager_ptr
-      = std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> >(new CppAD::cg::DynamicModelLibraryProcessor<Scalar>(*libcgen_ptr,library_name));
+      = std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> >(new CppAD::cg::DynamicModelLibraryProcessor<Scalar>(*libcgen_ptr,library_path));
     }
     
     CppAD::cg::ModelCSourceGen<Scalar> & codeGenerator()
     { return *cgen_ptr; }
     
+    ///
+    /// \brief Compile the generated sources into the library.
+    ///        The sources are compiled concurrently (see setCompileJobs), and each object file is cached in the cache directory:
+    ///        only the sources which differ from a previous compilation are rebuilt.
+    ///
     void compileLib()
     {
-      CppAD::cg::GccCompiler<Scalar> compiler;
-      std::vector<std::string> compile_options = compiler.getCompileFlags();
-      compile_options[0] = "-Ofast";
-      compiler.setCompileFlags(compile_options);
-      dynamicLibManager_ptr->createDynamicLibrary(compiler,false);
+      internal::compileCodeGenLibrary(*libcgen_ptr,getLibraryName(),cache_directory,compiler_path,compile_flags,compile_jobs);
+    }
+    
+    ///
+    /// \brief Hash identifying the compiled library in the cache.
+    ///        It depends on the structure and the parameters of the model, on the generated function (its tag, name and options),
+    ///        on the size of the scalar type, on the compile flags and on the version of Pinocchio:
+    ///        a library is reused only if none of them has changed since its compilation.
+    ///
+    boost::uint64_t getLibraryHash() const
+    {
+      std::ostringstream key;
+      key << printVersion() << "|" << getGeneratorTag() << "|" << sizeof(Scalar)
+          << "|" << function_name << "|" << library_name
+          << "|" << ad_X.size() << "|" << ad_Y.size()
+          << "|" << build_forward << "|" << build_jacobian << "|" << build_sparse_jacobian
+          << "|" << max_assignments_per_function
+          << "|" << function_options;
+      if(build_sparse_jacobian)
+      {
+        for(std::size_t k = 0; k < jacobian_sparsity_rows.size(); ++k)
+          key << "|" << jacobian_sparsity_rows[k] << "," << jacobian_sparsity_cols[k];
+      }
+      key << "|" << compiler_path;
+      for(std::vector<std::string>::const_iterator it = compile_flags.begin();
+          it != compile_flags.end(); ++it)
+        key << "|" << *it;
+      
+      return hashString(key.str(),model_hash);
+    }
+    
+    /// \brief Name of the library file, without extension (only valid after initLib).
+    std::string getLibraryName() const
+    { return dynamicLibManager_ptr->getLibraryName(); }
+    
+    /// \brief Set the directory where the compiled libraries are cached. It is created if needed. By default, the working directory is used.
+    void setCacheDirectory(const std::string & directory) { cache_directory = directory; }
+    /// \brief Directory where the compiled libraries are cached.
+    const std::string & getCacheDirectory() const { return cache_directory; }
+    
+    /// \brief Path of the compiler executable, by default the one of CppAD::cg::GccCompiler (must be set before initLib).
+    const std::string & getCompilerPath() const { return compiler_path; }
+    void setCompilerPath(const std::string & path) { compiler_path = path; }
+    
+    /// \brief Flags passed to the compiler (must be set before initLib).
+    const std::vector<std::string> & getCompileFlags() const { return compile_flags; }
+    void setCompileFlags(const std::vector<std::string> & flags) { compile_flags = flags; }
+    
+    /// \brief Set the maximum number of source files compiled at the same time (0: number of hardware threads).
+    void setCompileJobs(const std::size_t num_jobs) { compile_jobs = num_jobs; }
+    
+    ///
+    /// \brief Set the maximum number of assignments in a generated C function (must be set before initLib).
+    ///        Larger functions are split into several functions, each generated in its own source file, which can be compiled concurrently.
+    ///        0 keeps the default of CppADCodeGen.
+    ///
+    void setMaxAssignmentsPerFunction(const std::size_t max_assignments) { max_assignments_per_function = max_assignments; }
+    
+    ///
+    /// \brief Generate the Jacobian restricted to its structurally non-zero entries, evaluated with evalSparseJacobian (must be set before initLib).
+    ///        The entries are the ones given by the generator (e.g. from the kinematic tree) or, by default, the sparsity pattern detected by CppAD.
+    ///        The dense Jacobian, which doubles the generated code, is then not built anymore: call setBuildJacobian(true) afterwards to keep both.
+    ///
+    void setBuildSparseJacobian(const bool value)
+    {
+      build_sparse_jacobian = value;
+      if(value)
+        build_jacobian = false;
     }
     
+    /// \brief Generate the dense Jacobian, evaluated with evalJacobian (must be set before initLib).
+    void setBuildJacobian(const bool value) { build_jacobian = value; }
+    
     bool existLib() const
     {
-      const std::string filename = dynamicLibManager_ptr->getLibraryName() + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
-      std::ifstream file(filename.c_str());
-      return file.good();
+      return internal::existCodeGenLibrary(getLibraryName());
     }
     
+    ///
+    /// \brief Open the library, after compiling it if needed.
+    ///        A library found in the cache is checked before being used: if it cannot be opened or misses the function
+    ///        (e.g. a file truncated by an interrupted process), it is compiled again when generate_if_not_exist is true.
+    ///
     void loadLib(const bool generate_if_not_exist = true)
     {
       if(!existLib() && generate_if_not_exist)
         compileLib();
       
-      const auto it = dynamicLibManager_ptr->getOptions().find("dlOpenMode");
-      if (it == dynamicLibManager_ptr->getOptions().end())
-      {
-        dynamicLib_ptr.reset(new CppAD::cg::LinuxDynamicLib<Scalar>(dynamicLibManager_ptr->getLibraryName() +  CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION));
-      }
-      else
+      const std::vector<std::string> function_names(1,function_name);
+      std::shared_ptr<CppAD::cg::DynamicLib<Scalar> > lib = internal::openValidCodeGenLibrary(*dynamicLibManager_ptr,function_names);
+      if(!lib && generate_if_not_exist)
       {
-        int dlOpenMode = std::stoi(it->second);
-        dynamicLib_ptr.reset(new CppAD::cg::LinuxDynamicLib<Scalar>(dynamicLibManager_ptr->getLibraryName() +  CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION, dlOpenMode));
+        compileLib();
+        lib = internal::openValidCodeGenLibrary(*dynamicLibManager_ptr,function_names);
       }
+      if(!lib)
+        throw std::runtime_error("The library " + getLibraryName() + " cannot be loaded.");
       
+      attachLib(lib);
+    }
+    
+    ///
+    /// \brief Evaluate the function with the compiled code contained in lib, which is kept alive as long as it is used.
+    ///
+    void attachLib(const std::shared_ptr<CppAD::cg::DynamicLib<Scalar> > & lib)
+    {
+      batchFun_ptrs.clear();
+      generatedFun_ptr.reset();
+      dynamicLib_ptr = lib;
       generatedFun_ptr = dynamicLib_ptr->model(function_name.c_str());
+      
+      if(build_sparse_jacobian)
+        initSparseJacobian();
     }
     
+    /// \brief Name of the generated function
+    const std::string & getFunctionName() const { return function_name; }
+    
+    /// \brief Hash of the model the function is generated from
+    boost::uint64_t getModelHash() const { return model_hash; }
+    
     template<typename Vector>
     void evalFunction(const Eigen::MatrixBase<Vector> & x)
     {
@@ -136,6 +403,84 @@ namespace pinocchio
       generatedFun_ptr->Jacobian(x_,jac_);
     }
     
+    ///
+    /// \brief Evaluate the function for a batch of inputs, writing the outputs in place.
+    ///
+    /// \param[in] X Inputs stacked column-wise (dim getInputDimension() x N).
+    /// \param[out] Y Outputs stacked column-wise (dim getOutputDimension() x N).
+    /// \param[in] num_threads Number of OpenMP threads sharing the samples (0: value of OMP_NUM_THREADS, see getOpenMPNumThreadsEnv).
+    ///
+    /// \note Without OpenMP support, the samples are evaluated sequentially and num_threads is ignored.
+    ///
+    void evalFunctionBatch(const Eigen::Ref<const MatrixXs> & X,
+                           Eigen::Ref<MatrixXs> Y,
+                           const std::size_t num_threads = 1)
+    {
+      assert(build_forward);
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(X.rows(),getInputDimension());
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(Y.rows(),getOutputDimension());
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(Y.cols(),X.cols());
+      
+      runBatch(X.cols(),num_threads,
+               [&](CppAD::cg::GenericModel<Scalar> & fun, const Eigen::DenseIndex k)
+               {
+                 CppAD::cg::ArrayView<const Scalar> x_(X.col(k).data(),(size_t)X.rows());
+                 CppAD::cg::ArrayView<Scalar> y_(Y.col(k).data(),(size_t)Y.rows());
+                 fun.ForwardZero(x_,y_);
+               });
+    }
+    
+    ///
+    /// \brief Evaluate the Jacobian for a batch of inputs, writing the Jacobians in place.
+    ///
+    /// \param[in] X Inputs stacked column-wise (dim getInputDimension() x N).
+    /// \param[out] J Jacobians stacked column-wise, each one stored row-major (dim getOutputDimension()*getInputDimension() x N).
+    /// \param[in] num_threads Number of OpenMP threads sharing the samples (0: value of OMP_NUM_THREADS, see getOpenMPNumThreadsEnv).
+    ///
+    /// \note Without OpenMP support, the samples are evaluated sequentially and num_threads is ignored.
+    ///
+    void evalJacobianBatch(const Eigen::Ref<const MatrixXs> & X,
+                           Eigen::Ref<MatrixXs> J,
+                           const std::size_t num_threads = 1)
+    {
+      assert(build_jacobian);
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(X.rows(),getInputDimension());
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(J.rows(),getOutputDimension()*getInputDimension());
+      PINOCCHIO_CHECK_ARGUMENT_SIZE(J.cols(),X.cols());
+      
+      runBatch(X.cols(),num_threads,
+               [&](CppAD::cg::GenericModel<Scalar> & fun, const Eigen::DenseIndex k)
+               {
+                 CppAD::cg::ArrayView<const Scalar> x_(X.col(k).data(),(size_t)X.rows());
+                 CppAD::cg::ArrayView<Scalar> jac_(J.col(k).data(),(size_t)J.rows());
+                 fun.Jacobian(x_,jac_);
+               });
+    }
+    
+    ///
+    /// \brief Evaluate the structurally non-zero entries of the Jacobian and store them in sparse_jac.
+    ///        The sparsity pattern of sparse_jac is set once when loading the library: each evaluation only writes its values.
+    ///
+    template<typename Vector>
+    void evalSparseJacobian(const Eigen::MatrixBase<Vector> & x)
+    {
+      assert(build_sparse_jacobian);
+      
+      CppAD::cg::ArrayView<const Scalar> x_(PINOCCHIO_EIGEN_CONST_CAST(Vector,x).data(),(size_t)x.size());
+      CppAD::cg::ArrayView<Scalar> values_(sparse_jac_values.data(),(size_t)sparse_jac_values.size());
+      size_t const * rows;
+      size_t const * cols;
+      generatedFun_ptr->SparseJacobian(x_,values_,&rows,&cols);
+      // The entries follow the pattern checked by initSparseJacobian.
+      assert(std::equal(sparse_jac_rows.begin(),sparse_jac_rows.end(),rows)
+             && std::equal(sparse_jac_cols.begin(),sparse_jac_cols.end(),cols));
+      PINOCCHIO_UNUSED_VARIABLE(rows); PINOCCHIO_UNUSED_VARIABLE(cols);
+      
+      Scalar * sparse_jac_data = sparse_jac.valuePtr();
+      for(std::size_t k = 0; k < sparse_jac_positions.size(); ++k)
+        sparse_jac_data[sparse_jac_positions[k]] = sparse_jac_values[(Eigen::DenseIndex)k];
+    }
+    
     /// \brief Dimension of the input vector
     Eigen::DenseIndex getInputDimension() const { return ad_X.size(); }
     /// \brief Dimension of the output vector
@@ -157,6 +502,33 @@ namespace pinocchio
     /// \brief Options to build or not the Jacobian of he function
     bool build_jacobian;
     
+    /// \brief Options to build or not the sparse Jacobian of the function
+    bool build_sparse_jacobian;
+    
+    /// \brief Entries of the sparse Jacobian to generate (all the structurally non-zero ones if empty)
+    std::vector<std::size_t> jacobian_sparsity_rows, jacobian_sparsity_cols;
+    
+    /// \brief Hash of the serialized model
+    const boost::uint64_t model_hash;
+    
+    /// \brief Generation options of the function which are not reflected by its dimensions (e.g. a list of frames), entering the library hash
+    std::string function_options;
+    
+    /// \brief Directory of the library cache
+    std::string cache_directory;
+    
+    /// \brief Path of the compiler executable
+    std::string compiler_path;
+    
+    /// \brief Flags passed to the compiler
+    std::vector<std::string> compile_flags;
+    
+    /// \brief Maximum number of source files compiled at the same time
+    std::size_t compile_jobs;
+    
+    /// \brief Maximum number of assignments in a generated C function
+    std::size_t max_assignments_per_function;
+    
     ADVectorXs ad_X, ad_Y;
     ADFun ad_fun;
     
@@ -166,12 +538,110 @@ namespace pinocchio
     VectorXs y;
     RowMatrixXs jac;
     
+    /// \brief Sparse Jacobian, with the sparsity pattern of the generated code
+    SparseMatrixXs sparse_jac;
+    /// \brief Values of the sparse Jacobian in the order of the generated code, and their position in sparse_jac
+    VectorXs sparse_jac_values;
+    std::vector<Eigen::Index> sparse_jac_positions;
+    /// \brief Row and column of each value of sparse_jac_values
+    std::vector<size_t> sparse_jac_rows, sparse_jac_cols;
+    
     std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> > cgen_ptr;
     std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> > libcgen_ptr;
     std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> > dynamicLibManager_ptr;
-    std::unique_ptr<CppAD::cg::DynamicLib<Scalar> > dynamicLib_ptr;
+    std::shared_ptr<CppAD::cg::DynamicLib<Scalar> > dynamicLib_ptr;
     std::unique_ptr<CppAD::cg::GenericModel<Scalar> > generatedFun_ptr;
     
+    /// \brief Additional instances of the generated function, one per OpenMP thread of the batched evaluations beyond the first one (a GenericModel is not reentrant)
+    std::vector<std::unique_ptr<CppAD::cg::GenericModel<Scalar> > > batchFun_ptrs;
+    
+    ///
+    /// \brief Evaluate f(fun,k) for the samples k of the batch, following the pattern of the parallel algorithms
+    ///        (see pinocchio/algorithm/parallel): an OpenMP loop over the samples, in which each thread uses its own instance
+    ///        of the generated function. Without OpenMP support, the samples are evaluated sequentially.
+    ///
+    template<typename Function>
+    void runBatch(const Eigen::DenseIndex num_samples,
+                  const std::size_t num_threads,
+                  const Function & f)
+    {
+#ifdef _OPENMP
+      const std::size_t nthreads = num_threads == 0 ? (std::size_t)getOpenMPNumThreadsEnv() : num_threads;
+      
+      // the thread 0 uses generatedFun_ptr
+      while(batchFun_ptrs.size() + 1 < nthreads)
+        batchFun_ptrs.push_back(dynamicLib_ptr->model(function_name.c_str()));
+#else
+      PINOCCHIO_UNUSED_VARIABLE(num_threads);
+#endif
+      
+      OpenMPException exception;
+      Eigen::DenseIndex k;
+      
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads((int)nthreads)
+#endif
+      for(k = 0; k < num_samples; ++k)
+      {
+#ifdef _OPENMP
+        const std::size_t thread_id = (std::size_t)omp_get_thread_num();
+#else
+        const std::size_t thread_id = 0;
+#endif
+        CppAD::cg::GenericModel<Scalar> & fun = thread_id == 0 ? *generatedFun_ptr : *batchFun_ptrs[thread_id-1];
+        try
+        {
+          f(fun,k);
+        }
+        catch(...)
+        {
+          exception.capture();
+        }
+      }
+      exception.rethrow();
+    }
+    
+    ///
+    /// \brief Set the sparsity pattern of sparse_jac from the generated code, and check once that the entries evaluated
+    ///        by the generated code follow it, so that evalSparseJacobian only copies the values.
+    ///        Derived classes may override it to set up the patterns of their own sparse outputs, once per library.
+    ///
+    virtual void initSparseJacobian()
+    {
+      std::vector<size_t> & rows = sparse_jac_rows;
+      std::vector<size_t> & cols = sparse_jac_cols;
+      generatedFun_ptr->JacobianSparsity(rows,cols);
+      
+      {
+        const VectorXs x = VectorXs::Zero(ad_X.size());
+        VectorXs values = VectorXs::Zero((Eigen::DenseIndex)rows.size());
+        CppAD::cg::ArrayView<const Scalar> x_(x.data(),(size_t)x.size());
+        CppAD::cg::ArrayView<Scalar> values_(values.data(),(size_t)values.size());
+        size_t const * eval_rows;
+        size_t const * eval_cols;
+        generatedFun_ptr->SparseJacobian(x_,values_,&eval_rows,&eval_cols);
+        PINOCCHIO_THROW(std::equal(rows.begin(),rows.end(),eval_rows)
+                        && std::equal(cols.begin(),cols.end(),eval_cols),
+                        std::logic_error,
+                        "The entries returned by the generated code do not follow its Jacobian sparsity pattern.");
+      }
+      
+      typedef Eigen::Triplet<Scalar> Triplet;
+      std::vector<Triplet> triplets;
+      triplets.reserve(rows.size());
+      for(std::size_t k = 0; k < rows.size(); ++k)
+        triplets.push_back(Triplet((int)rows[k],(int)cols[k],Scalar(0)));
+      
+      sparse_jac.resize(ad_Y.size(),ad_X.size());
+      sparse_jac.setFromTriplets(triplets.begin(),triplets.end());
+      sparse_jac.makeCompressed();
+      
+      sparse_jac_values = VectorXs::Zero((Eigen::DenseIndex)rows.size());
+      sparse_jac_positions.resize(rows.size());
+      for(std::size_t k = 0; k < rows.size(); ++k)
+        sparse_jac_positions[k] = &sparse_jac.coeffRef((Eigen::Index)rows[k],(Eigen::Index)cols[k]) - sparse_jac.valuePtr();
+    }
+    
   }; // struct CodeGenBase
   
 } // namespace pinocchio
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_codegen_code_generator_library_hpp__
+#define __pinocchio_codegen_code_generator_library_hpp__
+
+#include "pinocchio/codegen/code-generator-base.hpp"
+
+#include <stdexcept>
+
+namespace pinocchio
+{
+  
+  ///
+  /// \brief Gather several code-generated functions of the same model (e.g. CodeGenRNEA, CodeGenABA, CodeGenCRBA) in a single library.
+  ///        The library is compiled once and opened once, and each registered function then evaluates with it as if it had loaded its own library.
+  ///
+  /// \note The registered functions must outlive the calls to initLib and loadLib.
+  ///       The opened library is shared by the functions, and stays open as long as one of them exists.
+  ///
+  template<typename _Scalar>
+  struct CodeGenLibrary
+  {
+    typedef _Scalar Scalar;
+    typedef CodeGenBase<Scalar> CodeGenFunction;
+    typedef typename CodeGenFunction::Model Model;
+    
+    CodeGenLibrary(const Model & model,
+                   const std::string & library_name = "cg_library")
+    : library_name(library_name + "_" + model.name)
+    , model_hash(hashString(model.saveToString()))
+    , compile_jobs(0)
+    {
+      CppAD::cg::GccCompiler<Scalar> compiler;
+      compiler_path = compiler.getCompilerPath();
+      compile_flags = compiler.getCompileFlags();
+      compile_flags[0] = "-Ofast";
+    }
+    
+    ///
+    /// \brief Register a function in the library (before initLib).
+    ///
+    /// \param[in] function The code-generated function. It must have been built from the model of the library, and its name must be unique in the library.
+    ///
+    void addFunction(CodeGenFunction & function)
+    {
+      if(function.getModelHash() != model_hash)
+        throw std::invalid_argument("The function " + function.getFunctionName() + " is not built from the model of the library.");
+      for(typename FunctionVector::const_iterator it = functions.begin(); it != functions.end(); ++it)
+      {
+        if((*it)->getFunctionName() == function.getFunctionName())
+          throw std::invalid_argument("A function named " + function.getFunctionName() + " is already registered in the library.");
+      }
+      functions.push_back(&function);
+    }
+    
+    /// \brief Number of registered functions.
+    std::size_t size() const { return functions.size(); }
+    
+    ///
+    /// \brief Tape all the registered functions and prepare the generation of the library.
+    ///
+    void initLib()
+    {
+      if(functions.empty())
+        throw std::invalid_argument("No function is registered in the library.");
+      
+      for(typename FunctionVector::const_iterator it = functions.begin(); it != functions.end(); ++it)
+        (*it)->initCodeGenerator();
+      
+      libcgen_ptr = std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> >(new CppAD::cg::ModelLibraryCSourceGen<Scalar>(functions[0]->codeGenerator()));
+      for(std::size_t k = 1; k < functions.size(); ++k)
+        libcgen_ptr->addModel(functions[k]->codeGenerator());
+      
+      const std::string library_path = internal::codeGenLibraryPath(library_name,getLibraryHash(),cache_directory);
+      dynamicLibManager_ptr
+      = std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> >(new CppAD::cg::DynamicModelLibraryProcessor<Scalar>(*libcgen_ptr,library_path));
+    }
+    
+    void compileLib()
+    {
+      internal::compileCodeGenLibrary(*libcgen_ptr,getLibraryName(),cache_directory,compiler_path,compile_flags,compile_jobs);
+    }
+    
+    bool existLib() const
+    {
+      return internal::existCodeGenLibrary(getLibraryName());
+    }
+    
+    ///
+    /// \brief Open the library, after compiling it if needed, and make all the registered functions use it.
+    ///        As in CodeGenBase::loadLib, a library which cannot be opened or misses a function is compiled again when generate_if_not_exist is true.
+    ///
+    void loadLib(const bool generate_if_not_exist = true)
+    {
+      if(!existLib() && generate_if_not_exist)
+        compileLib();
+      
+      std::vector<std::string> function_names;
+      for(typename FunctionVector::const_iterator it = functions.begin(); it != functions.end(); ++it)
+        function_names.push_back((*it)->getFunctionName());
+      
+      std::shared_ptr<CppAD::cg::DynamicLib<Scalar> > lib = internal::openValidCodeGenLibrary(*dynamicLibManager_ptr,function_names);
+      if(!lib && generate_if_not_exist)
+      {
+        compileLib();
+        lib = internal::openValidCodeGenLibrary(*dynamicLibManager_ptr,function_names);
+      }
+      if(!lib)
+        throw std::runtime_error("The library " + getLibraryName() + " cannot be loaded.");
+      
+      for(typename FunctionVector::const_iterator it = functions.begin(); it != functions.end(); ++it)
+        (*it)->attachLib(lib);
+    }
+    
+    ///
+    /// \brief Hash identifying the compiled library in the cache. It combines the hashes of the registered functions (see CodeGenBase::getLibraryHash)
+    ///        with the compile flags of the library.
+    ///
+    boost::uint64_t getLibraryHash() const
+    {
+      std::ostringstream key;
+      key << printVersion() << "|" << sizeof(Scalar) << "|" << library_name;
+      for(typename FunctionVector::const_iterator it = functions.begin(); it != functions.end(); ++it)
+        key << "|" << hashToString((*it)->getLibraryHash());
+      key << "|" << compiler_path;
+      for(std::vector<std::string>::const_iterator it = compile_flags.begin();
+          it != compile_flags.end(); ++it)
+        key << "|" << *it;
+      
+      return hashString(key.str(),model_hash);
+    }
+    
+    /// \brief Name of the library file, without extension (only valid after initLib).
+    std::string getLibraryName() const
+    { return dynamicLibManager_ptr->getLibraryName(); }
+    
+    /// \brief Set the directory where the compiled libraries are cached. It is created if needed. By default, the working directory is used.
+    void setCacheDirectory(const std::string & directory) { cache_directory = directory; }
+    /// \brief Directory where the compiled libraries are cached.
+    const std::string & getCacheDirectory() const { return cache_directory; }
+    
+    /// \brief Path of the compiler executable, by default the one of CppAD::cg::GccCompiler (must be set before initLib).
+    const std::string & getCompilerPath() const { return compiler_path; }
+    void setCompilerPath(const std::string & path) { compiler_path = path; }
+    
+    /// \brief Flags passed to the compiler (must be set before initLib).
+    const std::vector<std::string> & getCompileFlags() const { return compile_flags; }
+    void setCompileFlags(const std::vector<std::string> & flags) { compile_flags = flags; }
+    
+    /// \brief Set the maximum number of source files compiled at the same time (0: number of hardware threads).
+    void setCompileJobs(const std::size_t num_jobs) { compile_jobs = num_jobs; }
+    
+  protected:
+    
+    typedef std::vector<CodeGenFunction *> FunctionVector;
+    
+    /// \brief Name of the library
+    const std::string library_name;
+    
+    /// \brief Hash of the serialized model
+    const boost::uint64_t model_hash;
+    
+    /// \brief Directory of the library cache
+    std::string cache_directory;
+    
+    /// \brief Path of the compiler executable
+    std::string compiler_path;
+    
+    /// \brief Flags passed to the compiler
+    std::vector<std::string> compile_flags;
+    
+    /// \brief Maximum number of source files compiled at the same time
+    std::size_t compile_jobs;
+    
+    /// \brief Registered functions
+    FunctionVector functions;
+    
+    std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> > libcgen_ptr;
+    std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> > dynamicLibManager_ptr;
+    
+  }; // struct CodeGenLibrary
+  
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_codegen_code_generator_library_hpp__
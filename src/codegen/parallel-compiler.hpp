@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_codegen_parallel_compiler_hpp__
+#define __pinocchio_codegen_parallel_compiler_hpp__
+
+#include "pinocchio/codegen/cppadcg.hpp"
+#include "pinocchio/utils/hash.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Compile a set of C source files into a shared library, several files at a time.
+  ///        Each object file is cached under a hash of its source and of the compile flags:
+  ///        building again a library only recompiles the sources which have changed.
+  ///        As CppAD::cg::GccCompiler, the compiler is executed directly with its list of arguments
+  ///        (see CppAD::cg::system::callExecutable), without going through a shell.
+  ///
+  struct ParallelCCompiler
+  {
+    ///
+    /// \brief Constructor.
+    ///
+    /// \param[in] object_directory Directory where the object files are cached. It is created if needed.
+    /// \param[in] num_jobs Maximum number of files compiled at the same time (0: number of hardware threads).
+    /// \param[in] compiler_path Path of the compiler executable (the default one of CppAD::cg::GccCompiler).
+    ///
+    explicit ParallelCCompiler(const std::string & object_directory,
+                               const std::size_t num_jobs = 0,
+                               const std::string & compiler_path = "/usr/bin/gcc")
+    : compiler(compiler_path)
+    , object_directory(object_directory)
+    , num_jobs(num_jobs)
+    {
+      compile_flags.push_back("-O2");
+      link_flags.push_back("-shared");
+      link_flags.push_back("-rdynamic");
+    }
+
+    ///
+    /// \brief Compile the sources and link them into a shared library.
+    ///
+    /// \param[in] sources Paths of the C source files.
+    /// \param[in] library_path Path of the shared library to create, including its extension.
+    ///            It is replaced atomically: the library is linked into a temporary file which is then renamed.
+    ///
+    /// \returns the number of sources which have been compiled, i.e. which were not found in the cache.
+    ///
+    std::size_t createDynamicLibrary(const std::vector<std::string> & sources,
+                                     const std::string & library_path) const
+    {
+      boost::filesystem::create_directories(object_directory);
+
+      // compile into a temporary file first, so that a failed or interrupted compilation never lands in the cache
+      std::vector<std::string> objects(sources.size()), tmp_objects(sources.size());
+      std::vector<std::size_t> to_compile;
+      for(std::size_t k = 0; k < sources.size(); ++k)
+      {
+        objects[k] = objectPath(sources[k]);
+        if(!boost::filesystem::exists(objects[k]))
+        {
+          tmp_objects[k] = temporaryPath(objects[k]);
+          to_compile.push_back(k);
+        }
+      }
+
+      std::atomic<std::size_t> next(0);
+      std::vector<std::string> failures;
+      std::mutex failures_mutex;
+      run(to_compile.size(),[&]()
+      {
+        for(std::size_t i = next++; i < to_compile.size(); i = next++)
+        {
+          const std::size_t k = to_compile[i];
+          std::vector<std::string> args(compile_flags);
+          args.push_back("-fPIC");
+          args.push_back("-c");
+          args.push_back(sources[k]);
+          args.push_back("-o");
+          args.push_back(tmp_objects[k]);
+          std::string error;
+          boost::system::error_code error_code;
+          bool success = execute(args,error);
+          if(success)
+          {
+            boost::filesystem::rename(tmp_objects[k],objects[k],error_code);
+            if(error_code) { success = false; error = error_code.message(); }
+          }
+          if(!success)
+          {
+            boost::filesystem::remove(tmp_objects[k],error_code);
+            std::lock_guard<std::mutex> lock(failures_mutex);
+            failures.push_back("Failed to compile " + sources[k] + ": " + error);
+          }
+        }
+      });
+      if(!failures.empty())
+        throw std::runtime_error(failures.front());
+
+      // link into a temporary file, then rename it: a process opening the library never sees a partially written file
+      const std::string tmp_library = temporaryPath(library_path);
+      std::vector<std::string> args(link_flags);
+      args.push_back("-o");
+      args.push_back(tmp_library);
+      args.insert(args.end(),objects.begin(),objects.end());
+      args.push_back("-lm");
+      std::string error;
+      boost::system::error_code error_code;
+      bool success = execute(args,error);
+      if(success)
+      {
+        boost::filesystem::rename(tmp_library,library_path,error_code);
+        if(error_code) { success = false; error = error_code.message(); }
+      }
+      if(!success)
+      {
+        boost::filesystem::remove(tmp_library,error_code);
+        throw std::runtime_error("Failed to link the library " + library_path + ": " + error);
+      }
+
+      return to_compile.size();
+    }
+
+    ///
+    /// \returns the path of the cached object file corresponding to a source file.
+    ///
+    std::string objectPath(const std::string & source) const
+    {
+      std::ifstream file(source.c_str(), std::ios::binary);
+      if(!file.good())
+        throw std::invalid_argument("The source file " + source + " does not exist");
+      std::ostringstream content;
+      content << file.rdbuf();
+
+      boost::uint64_t hash = hashString(compiler);
+      for(std::vector<std::string>::const_iterator it = compile_flags.begin(); it != compile_flags.end(); ++it)
+        hash = hashString(*it,hash);
+      hash = hashString(content.str(),hash);
+      return (boost::filesystem::path(object_directory) / (hashToString(hash) + ".o")).string();
+    }
+
+    /// \brief Path of the compiler executable. It is executed directly, hence the full path is required.
+    std::string compiler;
+
+    /// \brief Flags used to compile each source file.
+    std::vector<std::string> compile_flags;
+
+    /// \brief Flags used to link the object files into the shared library.
+    std::vector<std::string> link_flags;
+
+    /// \brief Directory where the object files are cached.
+    std::string object_directory;
+
+    /// \brief Maximum number of files compiled at the same time (0: number of hardware threads).
+    std::size_t num_jobs;
+
+  protected:
+
+    ///
+    /// \returns a path next to path, unique among the processes and the threads sharing the directory,
+    ///          where a file can be written before being renamed into path.
+    ///
+    static std::string temporaryPath(const std::string & path)
+    {
+      return path + "." + boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%").string() + ".tmp";
+    }
+
+    /// \brief Run the compiler with the given arguments. \returns false on failure, with the error output of the compiler in error.
+    bool execute(const std::vector<std::string> & args, std::string & error) const
+    {
+      try
+      {
+        CppAD::cg::system::callExecutable(compiler,args);
+      }
+      catch(const std::exception & e)
+      {
+        error = e.what();
+        return false;
+      }
+      return true;
+    }
+
+    /// \brief Run worker on min(num_jobs,num_tasks) threads, worker being in charge of distributing the tasks.
+    template<typename Worker>
+    void run(const std::size_t num_tasks, const Worker & worker) const
+    {
+      std::size_t nthreads = num_jobs;
+      if(nthreads == 0)
+        nthreads = std::max<std::size_t>(1,std::thread::hardware_concurrency());
+      nthreads = std::min(nthreads,num_tasks);
+
+      std::vector<std::thread> threads;
+      for(std::size_t t = 0; t < nthreads; ++t)
+        threads.push_back(std::thread(worker));
+      for(std::size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    }
+
+  }; // struct ParallelCCompiler
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_codegen_parallel_compiler_hpp__
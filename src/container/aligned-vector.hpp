@@ -8,9 +8,11 @@
 #include <vector>
 #include <Eigen/StdVector>
 
+#include "pinocchio/container/arena.hpp"
+
 #define PINOCCHIO_ALIGNED_STD_VECTOR(Type) \
   ::pinocchio::container::aligned_vector<Type>
-//  std::vector<Type,Eigen::aligned_allocator<Type> >
+//  std::vector<Type,::pinocchio::container::aligned_allocator<Type> >
 
 namespace pinocchio
 {
@@ -19,13 +21,14 @@ namespace pinocchio
   
     ///
     /// \brief Specialization of an std::vector with an aligned allocator. This specialization might be used when the type T is or contains some Eigen members.
+    ///        The allocator may draw its memory from an Arena (see container::aligned_allocator). A copy always allocates its memory on the heap.
     ///
     /// \tparam T Type of the elements.
     ///
     template<typename T>
-    struct aligned_vector : public std::vector<T, Eigen::aligned_allocator<T> >
+    struct aligned_vector : public std::vector<T, aligned_allocator<T> >
     {
-      typedef ::std::vector<T, Eigen::aligned_allocator<T> > vector_base;
+      typedef ::std::vector<T, aligned_allocator<T> > vector_base;
       typedef const vector_base & const_vector_base_ref;
       typedef vector_base & vector_base_ref;
       
@@ -38,12 +41,31 @@ namespace pinocchio
       template<typename InputIterator>
       aligned_vector(InputIterator first, InputIterator last, const allocator_type& a = allocator_type())
       : vector_base(first, last, a) {}
-      aligned_vector(const aligned_vector & c) : vector_base(c) {}
+      aligned_vector(const aligned_vector & c) : vector_base(c.begin(), c.end()) {}
       explicit aligned_vector(size_type num, const value_type & val = value_type())
       : vector_base(num, val) {}
+      aligned_vector(size_type num, const value_type & val, const allocator_type & a)
+      : vector_base(num, val, a) {}
       aligned_vector(iterator start, iterator end) : vector_base(start, end) {}
       aligned_vector & operator=(const aligned_vector& x)
       { vector_base::operator=(x); return *this; }
+#ifdef PINOCCHIO_WITH_CXX11_SUPPORT
+      aligned_vector(aligned_vector && c) : vector_base(std::move(c.base())) {}
+      aligned_vector & operator=(aligned_vector && x)
+      { vector_base::operator=(std::move(x.base())); return *this; }
+#else
+      // Before C++11, std::vector::resize takes the value by copy, which breaks the alignment of the fixed-size Eigen types.
+      // As in the specialization of Eigen/StdVector for Eigen::aligned_allocator, the value is passed by reference.
+      void resize(size_type new_size)
+      { resize(new_size,value_type()); }
+      void resize(size_type new_size, const value_type & x)
+      {
+        if(vector_base::size() < new_size)
+          vector_base::insert(vector_base::end(),new_size - vector_base::size(),x);
+        else if(new_size < vector_base::size())
+          vector_base::erase(vector_base::begin() + (std::ptrdiff_t)new_size,vector_base::end());
+      }
+#endif
       
       vector_base & base() { return *static_cast<vector_base*>(this); }
       const vector_base & base() const { return *static_cast<const vector_base*>(this); }
@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_container_arena_hpp__
+#define __pinocchio_container_arena_hpp__
+
+#include <cassert>
+#include <cstddef>
+#include <Eigen/Core>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "pinocchio/macros.hpp"
+
+#ifdef PINOCCHIO_WITH_CXX11_SUPPORT
+  #include <type_traits>
+#endif
+
+namespace pinocchio
+{
+  namespace container
+  {
+
+    ///
+    /// \brief Monotonic memory buffer: a single block, allocated once, handed out sequentially and released all at once.
+    ///        When the block is exhausted, the requests are forwarded to the regular aligned heap allocation.
+    ///
+    struct Arena : boost::noncopyable
+    {
+#if defined(EIGEN_MAX_ALIGN_BYTES) && EIGEN_MAX_ALIGN_BYTES > 16
+      enum { ALIGNMENT = EIGEN_MAX_ALIGN_BYTES };
+#else
+      enum { ALIGNMENT = 16 };
+#endif
+
+      /// \returns bytes rounded up to the arena alignment.
+      static std::size_t align(const std::size_t bytes)
+      { return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+      ///
+      /// \brief Allocate the block of the arena.
+      ///
+      /// \param[in] capacity Size of the block in bytes.
+      ///
+      explicit Arena(const std::size_t capacity)
+      : m_data(NULL)
+      , m_capacity(align(capacity))
+      , m_used(0)
+      , m_released(0)
+      , m_num_overflows(0)
+      {
+        if(m_capacity > 0)
+          m_data = static_cast<char*>(Eigen::internal::aligned_malloc(m_capacity));
+      }
+
+      ~Arena()
+      {
+        Eigen::internal::aligned_free(m_data);
+      }
+
+      ///
+      /// \brief Take bytes from the block of the arena.
+      ///
+      /// \returns a pointer aligned on ALIGNMENT, or NULL if the arena is exhausted (the request is then counted in numOverflows()).
+      ///
+      void * allocate(const std::size_t bytes)
+      {
+        const std::size_t size = align(bytes);
+        if(size > m_capacity - m_used)
+        {
+          ++m_num_overflows;
+          return NULL;
+        }
+        void * ptr = m_data + m_used;
+        m_used += size;
+        return ptr;
+      }
+
+      ///
+      /// \brief Give back bytes taken from the block. The memory is not reused before the arena is destroyed:
+      ///        it is only counted in released().
+      ///
+      void release(const void * ptr, const std::size_t bytes)
+      {
+        assert(owns(ptr) && "The memory does not belong to the arena.");
+        PINOCCHIO_UNUSED_VARIABLE(ptr);
+        m_released += align(bytes);
+      }
+
+      /// \returns true if ptr lies inside the block of the arena.
+      bool owns(const void * ptr) const
+      {
+        const char * p = static_cast<const char*>(ptr);
+        return m_data != NULL && p >= m_data && p < m_data + m_capacity;
+      }
+
+      /// \returns the size of the block in bytes.
+      std::size_t capacity() const { return m_capacity; }
+
+      /// \returns the number of bytes already handed out.
+      std::size_t used() const { return m_used; }
+
+      /// \returns the number of bytes handed out and then given back, which are lost until the arena is destroyed.
+      std::size_t released() const { return m_released; }
+
+      /// \returns the number of requests which did not fit in the remaining block and were forwarded to the heap.
+      std::size_t numOverflows() const { return m_num_overflows; }
+
+    protected:
+
+      char * m_data;
+      std::size_t m_capacity;
+      std::size_t m_used;
+      std::size_t m_released;
+      std::size_t m_num_overflows;
+
+    }; // struct Arena
+
+    ///
+    /// \brief Aligned allocator drawing its memory from an Arena when one is provided, from the heap otherwise.
+    ///        The allocator shares the ownership of its arena, which thus lives as long as a container may hold some of its memory.
+    ///        Memory taken from the arena is only given back when the arena is destroyed (see Arena::release),
+    ///        and the requests which do not fit in the arena anymore are served by the heap (see Arena::numOverflows).
+    ///
+    /// \tparam T Type of the elements.
+    ///
+    template<typename T>
+    struct aligned_allocator : public Eigen::aligned_allocator<T>
+    {
+      typedef Eigen::aligned_allocator<T> Base;
+      typedef typename Base::size_type size_type;
+      typedef typename Base::pointer pointer;
+      typedef boost::shared_ptr<Arena> ArenaPtr;
+
+      template<typename U>
+      struct rebind { typedef aligned_allocator<U> other; };
+
+#ifdef PINOCCHIO_WITH_CXX11_SUPPORT
+      // Two allocators are only equal when they share the same arena (or both use the heap).
+      // A buffer always travels with the allocator it comes from: a move or a swap exchanges the allocators together with the buffers,
+      // while a copy assignment keeps the allocator of the destination and copies the elements into its memory.
+      typedef std::false_type is_always_equal;
+      typedef std::true_type propagate_on_container_swap;
+      typedef std::true_type propagate_on_container_move_assignment;
+      typedef std::false_type propagate_on_container_copy_assignment;
+
+      /// \brief A copy of a container always allocates its memory on the heap: it does not keep the arena of the original alive.
+      aligned_allocator select_on_container_copy_construction() const { return aligned_allocator(); }
+#endif
+
+      aligned_allocator() : Base() {}
+      explicit aligned_allocator(const ArenaPtr & arena) : Base(), m_arena(arena) {}
+      aligned_allocator(const aligned_allocator & other) : Base(other), m_arena(other.m_arena) {}
+      aligned_allocator & operator=(const aligned_allocator & other)
+      { m_arena = other.m_arena; return *this; } // Eigen::aligned_allocator is stateless
+      template<typename U>
+      aligned_allocator(const aligned_allocator<U> & other) : Base(other), m_arena(other.arenaPtr()) {}
+
+      pointer allocate(size_type num, const void * hint = 0)
+      {
+        if(m_arena)
+        {
+          void * ptr = m_arena->allocate(num * sizeof(T));
+          if(ptr != NULL) return static_cast<pointer>(ptr);
+        }
+        return Base::allocate(num,hint);
+      }
+
+      void deallocate(pointer ptr, size_type num)
+      {
+        if(m_arena && m_arena->owns(ptr))
+          m_arena->release(ptr,num * sizeof(T));
+        else
+          Base::deallocate(ptr,num);
+      }
+
+      /// \returns the arena the memory is taken from, NULL for the heap.
+      Arena * arena() const { return m_arena.get(); }
+
+      /// \returns the shared ownership of the arena the memory is taken from, empty for the heap.
+      const ArenaPtr & arenaPtr() const { return m_arena; }
+
+    protected:
+
+      ArenaPtr m_arena;
+
+    }; // struct aligned_allocator
+
+    template<typename T, typename U>
+    bool operator==(const aligned_allocator<T> & lhs, const aligned_allocator<U> & rhs)
+    { return lhs.arena() == rhs.arena(); }
+
+    template<typename T, typename U>
+    bool operator!=(const aligned_allocator<T> & lhs, const aligned_allocator<U> & rhs)
+    { return lhs.arena() != rhs.arena(); }
+
+  } // namespace container
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_container_arena_hpp__
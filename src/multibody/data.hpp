@@ -361,19 +361,69 @@ namespace pinocchio
     /// \brief Tensor containing the kinematic Hessian of all the joints.
     Tensor3x kinematic_hessians;
     
+    /// \brief Optional buffers currently allocated (combination of pinocchio::DataAllocation flags).
+    int allocation;
+    
     ///
     /// \brief Default constructor of pinocchio::Data from a pinocchio::Model.
     ///
     /// \param[in] model The model structure of the rigid body system.
+    /// \param[in] allocation The optional buffers to allocate at construction (combination of pinocchio::DataAllocation flags).
+    ///            The other optional buffers are left empty and allocated on first use by the algorithms requiring them.
+    /// \param[in] use_arena If true, the per-joint and per-frame vectors are allocated contiguously, in a single arena sized from the model.
+    ///            The Eigen matrices and the index vectors keep their own allocations.
+    ///
+    /// \note With use_arena, the arena is shared by the allocators of the vectors, and lives as long as one of them holds some of its memory.
+    ///       A copy of the data allocates its vectors on the heap, a copy assignment keeps the memory of the destination,
+    ///       and a move or a swap hands the buffers over together with their arena. The memory the vectors release or request
+    ///       beyond the arena (e.g. when resized) is reported by arena()->released() and arena()->numOverflows().
     ///
-    explicit DataTpl(const Model & model);
+    explicit DataTpl(const Model & model, const int allocation = ALLOCATE_ALL, const bool use_arena = false);
     
     ///
     /// \brief Default constructor
     ///
-    DataTpl() {}
+    DataTpl() : allocation(ALLOCATE_NONE) {}
+    
+    ///
+    /// \brief Allocate the optional buffers listed in flags which are not allocated yet.
+    ///        The buffers already allocated are left untouched.
+    ///
+    /// \param[in] model The model structure of the rigid body system.
+    /// \param[in] flags Combination of pinocchio::DataAllocation flags.
+    ///
+    void allocate(const Model & model, const int flags);
+    
+    ///
+    /// \brief Release the optional buffers listed in flags.
+    ///
+    /// \param[in] flags Combination of pinocchio::DataAllocation flags.
+    ///
+    void release(const int flags);
+    
+    /// \returns true if all the optional buffers listed in flags are allocated.
+    bool isAllocated(const int flags) const { return (allocation & flags) == flags; }
+    
+    /// \returns the arena of the per-joint and per-frame vectors if the data has been constructed with use_arena, NULL otherwise.
+    container::Arena * arena() const { return joints.get_allocator().arena(); }
+    
+    ///
+    /// \returns the memory footprint of the data, detailed field by field.
+    ///          The arenas holding some of the vectors are reported as a whole in the field "arena",
+    ///          and the vectors stored in them only count the dynamic memory of their elements.
+    ///
+    MemoryFootprint memoryFootprint() const;
 
   private:
+    static std::size_t arenaSize(const Model & model);
+    
+    ///
+    /// \brief Call visitor(field,size) on each of the vectors allocated in the arena with use_arena,
+    ///        size being its number of elements for a model with njoints joints and nframes frames.
+    ///
+    template<typename Visitor>
+    static void visitArenaVectors(Visitor & visitor, const std::size_t njoints, const std::size_t nframes);
+    
     void computeLastChild(const Model & model);
     void computeParents_fromRow(const Model & model);
     void computeSupports_fromRow(const Model & model);
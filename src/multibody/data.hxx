@@ -9,38 +9,75 @@
 #include "pinocchio/spatial/fwd.hpp"
 #include "pinocchio/multibody/model.hpp"
 #include "pinocchio/utils/string-generator.hpp"
+#include "pinocchio/utils/memory-footprint.hpp"
 #include "pinocchio/multibody/liegroup/liegroup-algo.hpp"
 
+#include <algorithm>
+
 /// @cond DEV
 
 namespace pinocchio
 {
-  
+  namespace internal
+  {
+    /// \brief Sum the size of the blocks taken in the arena by the vectors of the data.
+    struct DataArenaSizeVisitor
+    {
+      DataArenaSizeVisitor() : size(0) {}
+
+      template<typename Data, typename Vector>
+      void operator()(Vector Data::*, const std::size_t n)
+      { size += container::Arena::align(n * sizeof(typename Vector::value_type)); }
+
+      std::size_t size;
+    };
+
+    /// \brief Gather the arenas in which the storage of the vectors of the data lies.
+    template<typename Data>
+    struct DataArenaVisitor
+    {
+      explicit DataArenaVisitor(const Data & data) : data(data) {}
+
+      template<typename Vector>
+      void operator()(Vector Data::* field, const std::size_t)
+      {
+        const Vector & vec = data.*field;
+        const container::Arena * arena = vec.get_allocator().arena();
+        if(arena != NULL && !vec.empty() && arena->owns(&vec[0])
+           && std::find(arenas.begin(),arenas.end(),arena) == arenas.end())
+          arenas.push_back(arena);
+      }
+
+      const Data & data;
+      std::vector<const container::Arena *> arenas;
+    };
+  } // namespace internal
+
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
   inline DataTpl<Scalar,Options,JointCollectionTpl>::
-  DataTpl(const Model & model)
-  : joints(0)
-  , a((std::size_t)model.njoints,Motion::Zero())
-  , oa((std::size_t)model.njoints,Motion::Zero())
-  , a_gf((std::size_t)model.njoints,Motion::Zero())
-  , oa_gf((std::size_t)model.njoints,Motion::Zero())
-  , v((std::size_t)model.njoints,Motion::Zero())
-  , ov((std::size_t)model.njoints,Motion::Zero())
-  , f((std::size_t)model.njoints,Force::Zero())
-  , of((std::size_t)model.njoints,Force::Zero())
-  , h((std::size_t)model.njoints,Force::Zero())
-  , oh((std::size_t)model.njoints,Force::Zero())
-  , oMi((std::size_t)model.njoints,SE3::Identity())
-  , liMi((std::size_t)model.njoints,SE3::Identity())
+  DataTpl(const Model & model, const int allocation, const bool use_arena)
+  : joints(typename JointDataVector::allocator_type(boost::shared_ptr<container::Arena>(use_arena ? new container::Arena(arenaSize(model)) : NULL)))
+  , a((std::size_t)model.njoints,Motion::Zero(),joints.get_allocator())
+  , oa((std::size_t)model.njoints,Motion::Zero(),joints.get_allocator())
+  , a_gf((std::size_t)model.njoints,Motion::Zero(),joints.get_allocator())
+  , oa_gf((std::size_t)model.njoints,Motion::Zero(),joints.get_allocator())
+  , v((std::size_t)model.njoints,Motion::Zero(),joints.get_allocator())
+  , ov((std::size_t)model.njoints,Motion::Zero(),joints.get_allocator())
+  , f((std::size_t)model.njoints,Force::Zero(),joints.get_allocator())
+  , of((std::size_t)model.njoints,Force::Zero(),joints.get_allocator())
+  , h((std::size_t)model.njoints,Force::Zero(),joints.get_allocator())
+  , oh((std::size_t)model.njoints,Force::Zero(),joints.get_allocator())
+  , oMi((std::size_t)model.njoints,SE3::Identity(),joints.get_allocator())
+  , liMi((std::size_t)model.njoints,SE3::Identity(),joints.get_allocator())
   , tau(VectorXs::Zero(model.nv))
   , nle(VectorXs::Zero(model.nv))
   , g(VectorXs::Zero(model.nv))
-  , oMf((std::size_t)model.nframes,SE3::Identity())
-  , Ycrb((std::size_t)model.njoints,Inertia::Zero())
-  , dYcrb((std::size_t)model.njoints,Inertia::Zero())
+  , oMf((std::size_t)model.nframes,SE3::Identity(),joints.get_allocator())
+  , Ycrb((std::size_t)model.njoints,Inertia::Zero(),joints.get_allocator())
+  , dYcrb((std::size_t)model.njoints,Inertia::Matrix6::Zero(),joints.get_allocator())
   , M(MatrixXs::Zero(model.nv,model.nv))
-  , Minv(MatrixXs::Zero(model.nv,model.nv))
-  , C(MatrixXs::Zero(model.nv,model.nv))
+  , Minv()
+  , C()
   , dHdq(Matrix6x::Zero(6,model.nv))
   , dFdq(Matrix6x::Zero(6,model.nv))
   , dFdv(Matrix6x::Zero(6,model.nv))
@@ -48,20 +85,20 @@ namespace pinocchio
   , SDinv(Matrix6x::Zero(6,model.nv))
   , UDinv(Matrix6x::Zero(6,model.nv))
   , IS(MatrixXs::Zero(6,model.nv))
-  , vxI((std::size_t)model.njoints,Inertia::Matrix6::Zero())
-  , Ivx((std::size_t)model.njoints,Inertia::Matrix6::Zero())
-  , oinertias((std::size_t)model.njoints,Inertia::Zero())
-  , oYcrb((std::size_t)model.njoints,Inertia::Zero())
-  , doYcrb((std::size_t)model.njoints,Inertia::Matrix6::Zero())
+  , vxI((std::size_t)model.njoints,Inertia::Matrix6::Zero(),joints.get_allocator())
+  , Ivx((std::size_t)model.njoints,Inertia::Matrix6::Zero(),joints.get_allocator())
+  , oinertias((std::size_t)model.njoints,Inertia::Zero(),joints.get_allocator())
+  , oYcrb((std::size_t)model.njoints,Inertia::Zero(),joints.get_allocator())
+  , doYcrb((std::size_t)model.njoints,Inertia::Matrix6::Zero(),joints.get_allocator())
   , ddq(VectorXs::Zero(model.nv))
-  , Yaba((std::size_t)model.njoints,Inertia::Matrix6::Zero())
+  , Yaba((std::size_t)model.njoints,Inertia::Matrix6::Zero(),joints.get_allocator())
   , u(VectorXs::Zero(model.nv))
   , Ag(Matrix6x::Zero(6,model.nv))
   , dAg(Matrix6x::Zero(6,model.nv))
   , hg(Force::Zero())
   , dhg(Force::Zero())
   , Ig(Inertia::Zero())
-  , Fcrb((std::size_t)model.njoints,Matrix6x::Zero(6,model.nv))
+  , Fcrb((std::size_t)model.njoints,Matrix6x::Zero(6,model.nv),joints.get_allocator())
   , lastChild((std::size_t)model.njoints,-1)
   , nvSubtree((std::size_t)model.njoints,-1)
   , start_idx_v_fromRow((std::size_t)model.nv,-1)
@@ -78,14 +115,14 @@ namespace pinocchio
   , dVdq(Matrix6x::Zero(6,model.nv))
   , dAdq(Matrix6x::Zero(6,model.nv))
   , dAdv(Matrix6x::Zero(6,model.nv))
-  , dtau_dq(MatrixXs::Zero(model.nv,model.nv))
-  , dtau_dv(MatrixXs::Zero(model.nv,model.nv))
-  , ddq_dq(MatrixXs::Zero(model.nv,model.nv))
-  , ddq_dv(MatrixXs::Zero(model.nv,model.nv))
-  , iMf((std::size_t)model.njoints,SE3::Identity())
-  , com((std::size_t)model.njoints,Vector3::Zero())
-  , vcom((std::size_t)model.njoints,Vector3::Zero())
-  , acom((std::size_t)model.njoints,Vector3::Zero())
+  , dtau_dq()
+  , dtau_dv()
+  , ddq_dq()
+  , ddq_dv()
+  , iMf((std::size_t)model.njoints,SE3::Identity(),joints.get_allocator())
+  , com((std::size_t)model.njoints,Vector3::Zero(),joints.get_allocator())
+  , vcom((std::size_t)model.njoints,Vector3::Zero(),joints.get_allocator())
+  , acom((std::size_t)model.njoints,Vector3::Zero(),joints.get_allocator())
   , mass((std::size_t)model.njoints,(Scalar)(-1))
   , Jcom(Matrix3x::Zero(3,model.nv))
   , kinetic_energy((Scalar)-1)
@@ -93,27 +130,25 @@ namespace pinocchio
   , JMinvJt()
   , llt_JMinvJt()
   , lambda_c()
-  , sDUiJt(MatrixXs::Zero(model.nv,model.nv))
+  , sDUiJt()  // resized by the contact dynamics algorithms
   , torque_residual(VectorXs::Zero(model.nv))
   , dq_after(VectorXs::Zero(model.nv))
   , impulse_c()
-  , staticRegressor(Matrix3x::Zero(3,4*(model.njoints-1)))
+  , staticRegressor()
   , bodyRegressor(BodyRegressorType::Zero())
-  , jointTorqueRegressor(MatrixXs::Zero(model.nv,10*(model.njoints-1)))
-#if EIGEN_VERSION_AT_LEAST(3,2,90) && !EIGEN_VERSION_AT_LEAST(3,2,93)
-  , kinematic_hessians(6,std::max(1,model.nv),std::max(1,model.nv)) // the minimum size should be 1 for compatibility reasons
-#else
-  , kinematic_hessians(6,model.nv,model.nv)
-#endif
+  , jointTorqueRegressor()
+  , kinematic_hessians()
+  , allocation(ALLOCATE_NONE)
   {
     typedef typename Model::JointIndex JointIndex;
     
     /* Create data structure associated to the joints */
+    joints.reserve((std::size_t)model.njoints);
     for(JointIndex i=0;i<(JointIndex)(model.njoints);++i)
       joints.push_back(CreateJointData<Scalar,Options,JointCollectionTpl>::run(model.joints[i]));
 
     /* Init for CRBA */
-    M.setZero(); Minv.setZero();
+    M.setZero();
     for(JointIndex i=0;i<(JointIndex)(model.njoints);++i)
     { Fcrb[i].resize(6,model.nv); }
     
@@ -128,7 +163,207 @@ namespace pinocchio
     /* Init universe states relatively to itself */
     a_gf[0] = -model.gravity;
     
-    kinematic_hessians.setZero();
+    /* Optional buffers */
+    allocate(model,allocation);
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline void DataTpl<Scalar,Options,JointCollectionTpl>::
+  allocate(const Model & model, const int flags)
+  {
+    const int missing = flags & ~allocation;
+    if(missing == ALLOCATE_NONE) return;
+    
+    if(missing & ALLOCATE_MINV)
+      Minv.setZero(model.nv,model.nv);
+    if(missing & ALLOCATE_CORIOLIS)
+      C.setZero(model.nv,model.nv);
+    if(missing & ALLOCATE_DERIVATIVES)
+    {
+      dtau_dq.setZero(model.nv,model.nv);
+      dtau_dv.setZero(model.nv,model.nv);
+      ddq_dq.setZero(model.nv,model.nv);
+      ddq_dv.setZero(model.nv,model.nv);
+    }
+    if(missing & ALLOCATE_KINEMATIC_HESSIANS)
+    {
+#if EIGEN_VERSION_AT_LEAST(3,2,90) && !EIGEN_VERSION_AT_LEAST(3,2,93)
+      kinematic_hessians = Tensor3x(6,std::max(1,model.nv),std::max(1,model.nv)); // the minimum size should be 1 for compatibility reasons
+#else
+      kinematic_hessians = Tensor3x(6,model.nv,model.nv);
+#endif
+      kinematic_hessians.setZero();
+    }
+    if(missing & ALLOCATE_REGRESSORS)
+    {
+      staticRegressor.setZero(3,4*(model.njoints-1));
+      jointTorqueRegressor.setZero(model.nv,10*(model.njoints-1));
+    }
+    
+    allocation |= missing;
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline void DataTpl<Scalar,Options,JointCollectionTpl>::
+  release(const int flags)
+  {
+    const int allocated = flags & allocation;
+    
+    if(allocated & ALLOCATE_MINV)
+      Minv.resize(0,0);
+    if(allocated & ALLOCATE_CORIOLIS)
+      C.resize(0,0);
+    if(allocated & ALLOCATE_DERIVATIVES)
+    {
+      dtau_dq.resize(0,0); dtau_dv.resize(0,0);
+      ddq_dq.resize(0,0); ddq_dv.resize(0,0);
+    }
+    if(allocated & ALLOCATE_KINEMATIC_HESSIANS)
+      kinematic_hessians = Tensor3x();
+    if(allocated & ALLOCATE_REGRESSORS)
+    {
+      staticRegressor.resize(3,0);
+      jointTorqueRegressor.resize(0,0);
+    }
+    
+    allocation &= ~allocated;
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline MemoryFootprint DataTpl<Scalar,Options,JointCollectionTpl>::
+  memoryFootprint() const
+  {
+    MemoryFootprint footprint(sizeof(*this));
+    
+    // The vectors living in an arena only report the dynamic memory of their elements.
+    internal::DataArenaVisitor<DataTpl> arena_visitor(*this);
+    visitArenaVectors(arena_visitor,joints.size(),oMf.size());
+    std::size_t arena_capacity = 0;
+    for(std::size_t k = 0; k < arena_visitor.arenas.size(); ++k)
+      arena_capacity += arena_visitor.arenas[k]->capacity();
+    footprint.add("arena",arena_capacity);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,joints);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,a);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oa);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,a_gf);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oa_gf);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,v);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,ov);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,f);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,of);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,h);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oh);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oMi);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,liMi);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,tau);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,nle);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,g);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oMf);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Ycrb);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dYcrb);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,M);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Minv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,C);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dHdq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dFdq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dFdv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dFda);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,SDinv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,UDinv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,IS);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,vxI);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Ivx);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oinertias);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oYcrb);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,doYcrb);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,ddq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Yaba);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,u);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Ag);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dAg);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Fcrb);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,lastChild);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,nvSubtree);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,start_idx_v_fromRow);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,end_idx_v_fromRow);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,U);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,D);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Dinv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,tmp);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,parents_fromRow);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,supports_fromRow);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,nvSubtree_fromRow);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,J);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dJ);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dVdq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dAdq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dAdv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dtau_dq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dtau_dv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,ddq_dq);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,ddq_dv);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,iMf);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,com);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,vcom);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,acom);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,mass);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,Jcom);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,JMinvJt);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,llt_JMinvJt);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,lambda_c);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,sDUiJt);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,torque_residual);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,dq_after);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,impulse_c);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,staticRegressor);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,jointTorqueRegressor);
+    footprint.add("kinematic_hessians",(std::size_t)kinematic_hessians.size() * sizeof(Scalar));
+    
+    return footprint;
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline std::size_t DataTpl<Scalar,Options,JointCollectionTpl>::
+  arenaSize(const Model & model)
+  {
+    internal::DataArenaSizeVisitor visitor;
+    visitArenaVectors(visitor,(std::size_t)model.njoints,(std::size_t)model.nframes);
+    return visitor.size;
+  }
+
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  template<typename Visitor>
+  inline void DataTpl<Scalar,Options,JointCollectionTpl>::
+  visitArenaVectors(Visitor & visitor, const std::size_t njoints, const std::size_t nframes)
+  {
+    // Must match the vectors constructed on the arena in the constructor.
+    visitor(&DataTpl::joints,njoints);
+    visitor(&DataTpl::a,njoints);
+    visitor(&DataTpl::oa,njoints);
+    visitor(&DataTpl::a_gf,njoints);
+    visitor(&DataTpl::oa_gf,njoints);
+    visitor(&DataTpl::v,njoints);
+    visitor(&DataTpl::ov,njoints);
+    visitor(&DataTpl::f,njoints);
+    visitor(&DataTpl::of,njoints);
+    visitor(&DataTpl::h,njoints);
+    visitor(&DataTpl::oh,njoints);
+    visitor(&DataTpl::oMi,njoints);
+    visitor(&DataTpl::liMi,njoints);
+    visitor(&DataTpl::oMf,nframes);
+    visitor(&DataTpl::Ycrb,njoints);
+    visitor(&DataTpl::dYcrb,njoints); // stored as Matrix6
+    visitor(&DataTpl::vxI,njoints);
+    visitor(&DataTpl::Ivx,njoints);
+    visitor(&DataTpl::oinertias,njoints);
+    visitor(&DataTpl::oYcrb,njoints);
+    visitor(&DataTpl::doYcrb,njoints);
+    visitor(&DataTpl::Yaba,njoints);
+    visitor(&DataTpl::Fcrb,njoints);
+    visitor(&DataTpl::iMf,njoints);
+    visitor(&DataTpl::com,njoints);
+    visitor(&DataTpl::vcom,njoints);
+    visitor(&DataTpl::acom,njoints);
   }
 
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
@@ -214,6 +449,10 @@ namespace pinocchio
   bool operator==(const DataTpl<Scalar,Options,JointCollectionTpl> & data1,
                   const DataTpl<Scalar,Options,JointCollectionTpl> & data2)
   {
+    // The optional buffers are only compared when they are allocated, which requires the same allocation on both sides.
+    if(data1.allocation != data2.allocation)
+      return false;
+
     bool value =
        data1.joints == data2.joints
     && data1.a == data2.a
@@ -235,8 +474,6 @@ namespace pinocchio
     && data1.Ycrb == data2.Ycrb
     && data1.dYcrb == data2.dYcrb
     && data1.M == data2.M
-    && data1.Minv == data2.Minv
-    && data1.C == data2.C
     && data1.dHdq == data2.dHdq
     && data1.dFdq == data2.dFdq
     && data1.dFdv == data2.dFdv
@@ -273,10 +510,6 @@ namespace pinocchio
     && data1.dVdq == data2.dVdq
     && data1.dAdq == data2.dAdq
     && data1.dAdv == data2.dAdv
-    && data1.dtau_dq == data2.dtau_dq
-    && data1.dtau_dv == data2.dtau_dv
-    && data1.ddq_dq == data2.ddq_dq
-    && data1.ddq_dv == data2.ddq_dv
     && data1.iMf == data2.iMf
     && data1.com == data2.com
     && data1.vcom == data2.vcom
@@ -290,17 +523,33 @@ namespace pinocchio
     && data1.torque_residual == data2.torque_residual
     && data1.dq_after == data2.dq_after
     && data1.impulse_c == data2.impulse_c
-    && data1.staticRegressor == data2.staticRegressor
     && data1.bodyRegressor == data2.bodyRegressor
-    && data1.jointTorqueRegressor == data2.jointTorqueRegressor
     ;
     
+    if(data1.isAllocated(ALLOCATE_MINV))
+      value &= data1.Minv == data2.Minv;
+    if(data1.isAllocated(ALLOCATE_CORIOLIS))
+      value &= data1.C == data2.C;
+    if(data1.isAllocated(ALLOCATE_DERIVATIVES))
+      value &=
+         data1.dtau_dq == data2.dtau_dq
+      && data1.dtau_dv == data2.dtau_dv
+      && data1.ddq_dq == data2.ddq_dq
+      && data1.ddq_dv == data2.ddq_dv;
+    if(data1.isAllocated(ALLOCATE_REGRESSORS))
+      value &=
+         data1.staticRegressor == data2.staticRegressor
+      && data1.jointTorqueRegressor == data2.jointTorqueRegressor;
+
     // operator== for Eigen::Tensor provides an Expression which might be not evaluated as a boolean
-    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
-    typedef Eigen::Map<const typename Data::VectorXs> MapVectorXs;
-    value &=
-       MapVectorXs(data1.kinematic_hessians.data(),data1.kinematic_hessians.size())
-    == MapVectorXs(data2.kinematic_hessians.data(),data2.kinematic_hessians.size());
+    if(data1.isAllocated(ALLOCATE_KINEMATIC_HESSIANS))
+    {
+      typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+      typedef Eigen::Map<const typename Data::VectorXs> MapVectorXs;
+      value &=
+         MapVectorXs(data1.kinematic_hessians.data(),data1.kinematic_hessians.size())
+      == MapVectorXs(data2.kinematic_hessians.data(),data2.kinematic_hessians.size());
+    }
 
     return value;
   }
@@ -8,9 +8,11 @@
 #include "pinocchio/spatial/se3.hpp"
 #include "pinocchio/multibody/fwd.hpp"
 #include "pinocchio/container/aligned-vector.hpp"
+#include "pinocchio/utils/memory-footprint.hpp"
 
 #ifdef PINOCCHIO_WITH_HPP_FCL
   #include <hpp/fcl/collision_object.h>
+  #include <hpp/fcl/BVH/BVH_model.h>
   #include <hpp/fcl/collision.h>
   #include <hpp/fcl/distance.h>
   #include <hpp/fcl/shape/geometric_shapes.h>
@@ -229,6 +231,39 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_POP
 
   friend std::ostream & operator<< (std::ostream & os, const GeometryObject & geomObject);
 };
+
+namespace internal
+{
+  template<>
+  struct DynamicMemoryFootprint<GeometryObject>
+  {
+    static std::size_t run(const GeometryObject & object)
+    {
+      std::size_t res = dynamicMemoryFootprint(object.name)
+      + dynamicMemoryFootprint(object.meshPath)
+      + dynamicMemoryFootprint(object.meshTexturePath);
+#ifdef PINOCCHIO_WITH_HPP_FCL
+      // The collision geometry is counted for each object pointing to it.
+      if(object.geometry)
+      {
+        const fcl::BVHModelBase * bvh = dynamic_cast<const fcl::BVHModelBase *>(object.geometry.get());
+        if(bvh) res += (std::size_t)bvh->memUsage(0);
+        else    res += sizeof(fcl::CollisionGeometry);
+      }
+#endif // PINOCCHIO_WITH_HPP_FCL
+      return res;
+    }
+  };
+
+#ifdef PINOCCHIO_WITH_HPP_FCL
+  template<>
+  struct DynamicMemoryFootprint<fcl::CollisionResult>
+  {
+    static std::size_t run(const fcl::CollisionResult & result)
+    { return result.numContacts() * sizeof(fcl::Contact); }
+  };
+#endif // PINOCCHIO_WITH_HPP_FCL
+} // namespace internal
   
 
 } // namespace pinocchio
@@ -7,6 +7,7 @@
 
 #include "pinocchio/spatial/se3.hpp"
 #include "pinocchio/multibody/fwd.hpp"
+#include "pinocchio/utils/memory-footprint.hpp"
 
 #include <string>
 
@@ -136,6 +137,16 @@ namespace pinocchio
     return os;
   }
 
+  namespace internal
+  {
+    template<typename Scalar, int Options>
+    struct DynamicMemoryFootprint< FrameTpl<Scalar,Options> >
+    {
+      static std::size_t run(const FrameTpl<Scalar,Options> & frame)
+      { return dynamicMemoryFootprint(frame.name); }
+    };
+  } // namespace internal
+
 } // namespace pinocchio
 
 #endif // ifndef __pinocchio_frame_hpp__
@@ -58,6 +58,21 @@ namespace pinocchio
     ACCELERATION = 2 ///<  Refers to the quantities related to the 2nd-order kinematics (joint accelerations, center of mass acceleration, etc.).
   };
 
+  ///
+  /// \brief List of the optional buffers of DataTpl, which are only allocated when required by an algorithm.
+  ///        These flags can be combined with the bitwise OR operator.
+  ///
+  enum DataAllocation
+  {
+    ALLOCATE_NONE = 0, ///<  Only the buffers required by the core algorithms (kinematics, RNEA, CRBA, ABA, centroidal, etc.) are allocated.
+    ALLOCATE_MINV = 1 << 0, ///<  The inverse of the joint space inertia matrix (Minv), used by computeMinverse, cholesky::computeMinv and computeABADerivatives.
+    ALLOCATE_CORIOLIS = 1 << 1, ///<  The Coriolis matrix (C), used by computeCoriolisMatrix and getCoriolisMatrix.
+    ALLOCATE_DERIVATIVES = 1 << 2, ///<  The partial derivatives of the dynamics (dtau_dq, dtau_dv, ddq_dq, ddq_dv), used by computeRNEADerivatives and computeABADerivatives.
+    ALLOCATE_KINEMATIC_HESSIANS = 1 << 3, ///<  The kinematic Hessians (kinematic_hessians), used by computeJointKinematicHessians.
+    ALLOCATE_REGRESSORS = 1 << 4, ///<  The regressor matrices (staticRegressor, jointTorqueRegressor).
+    ALLOCATE_ALL = (1 << 5) - 1 ///<  All the buffers are allocated.
+  };
+
   /**
    * @}
    */
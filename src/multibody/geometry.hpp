@@ -152,6 +152,13 @@ namespace pinocchio
     friend std::ostream& operator<<(std::ostream & os,
                                     const GeometryModel & model_geom);
     
+    ///
+    /// \returns the memory footprint of the geometry model, detailed field by field.
+    ///
+    /// \note The FCL collision geometries are counted once per geometry object pointing to them.
+    ///
+    MemoryFootprint memoryFootprint() const;
+    
     /// \brief The number of GeometryObjects
     Index ngeoms;
 
@@ -235,6 +242,29 @@ namespace pinocchio
     ///
     std::vector<double> radius;
 
+    ///
+    /// \brief Enable the broad phase of the collision and distance computations.
+    ///
+    /// When true, updateGeometryPlacements also updates boundingSphereCenters and
+    /// the pairs whose bounding spheres are too far apart are skipped by computeCollisions
+    /// and computeDistances, without calling the FCL narrow phase.
+    ///
+    bool enableBroadPhase;
+
+    ///
+    /// \brief Centers of the bounding spheres of the geometry objects, expressed in the world frame.
+    ///
+    /// The bounding sphere of a geometry is given by the aabb_center and aabb_radius of its FCL collision geometry.
+    /// It is only updated by updateGeometryPlacements when enableBroadPhase is true.
+    ///
+    PINOCCHIO_ALIGNED_STD_VECTOR(SE3::Vector3) boundingSphereCenters;
+
+    ///
+    /// \brief Number of active collision pairs culled by the broad phase during the last call
+    /// to computeCollisions or computeDistances.
+    ///
+    std::size_t nculledPairs;
+
     ///
     /// \brief Index of the collision pair
     ///
@@ -296,6 +326,11 @@ namespace pinocchio
     /// \sa GeomData::activateCollisionPair
     ///
     void deactivateCollisionPair(const PairIndex pairId);
+    
+    ///
+    /// \returns the memory footprint of the geometry data, detailed field by field.
+    ///
+    MemoryFootprint memoryFootprint() const;
 
     friend std::ostream & operator<<(std::ostream & os, const GeometryData & geomData);
     
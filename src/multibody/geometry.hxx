@@ -32,6 +32,9 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_IGNORED_DEPRECECATED_DECLARATIONS
   , collisionRequests(geom_model.collisionPairs.size(), hpp::fcl::CollisionRequest(::hpp::fcl::NO_REQUEST,1))
   , collisionResults(geom_model.collisionPairs.size())
   , radius()
+  , enableBroadPhase(false)
+  , boundingSphereCenters(geom_model.ngeoms,SE3::Vector3::Zero())
+  , nculledPairs(0)
   , collisionPairIndex(0)
 #endif // PINOCCHIO_WITH_HPP_FCL
   , innerObjects()
@@ -69,6 +72,9 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_IGNORED_DEPRECECATED_DECLARATIONS
   , collisionRequests (other.collisionRequests)
   , collisionResults (other.collisionResults)
   , radius (other.radius)
+  , enableBroadPhase (other.enableBroadPhase)
+  , boundingSphereCenters (other.boundingSphereCenters)
+  , nculledPairs (other.nculledPairs)
   , collisionPairIndex (other.collisionPairIndex)
 #endif // PINOCCHIO_WITH_HPP_FCL
   , innerObjects (other.innerObjects)
@@ -234,6 +240,40 @@ PINOCCHIO_COMPILER_DIAGNOSTIC_POP
     activeCollisionPairs[pairId] = false;
   }
 
+  inline MemoryFootprint GeometryModel::memoryFootprint() const
+  {
+    MemoryFootprint footprint(sizeof(*this));
+    
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,geometryObjects);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,collisionPairs);
+    
+    return footprint;
+  }
+  
+  inline MemoryFootprint GeometryData::memoryFootprint() const
+  {
+    MemoryFootprint footprint(sizeof(*this));
+    
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,oMg);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,activeCollisionPairs);
+#ifdef PINOCCHIO_WITH_HPP_FCL
+PINOCCHIO_COMPILER_DIAGNOSTIC_PUSH
+PINOCCHIO_COMPILER_DIAGNOSTIC_IGNORED_DEPRECECATED_DECLARATIONS
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,collisionObjects);
+PINOCCHIO_COMPILER_DIAGNOSTIC_POP
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,distanceRequests);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,distanceResults);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,collisionRequests);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,collisionResults);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,radius);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,boundingSphereCenters);
+#endif // PINOCCHIO_WITH_HPP_FCL
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,innerObjects);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,outerObjects);
+    
+    return footprint;
+  }
+
 } // namespace pinocchio
 
 /// @endcond
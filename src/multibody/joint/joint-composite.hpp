@@ -10,6 +10,7 @@
 #include "pinocchio/multibody/joint/joint-basic-visitors.hpp"
 #include "pinocchio/container/aligned-vector.hpp"
 #include "pinocchio/spatial/act-on-set.hpp"
+#include "pinocchio/utils/memory-footprint.hpp"
 
 #include "pinocchio/serialization/fwd.hpp"
 
@@ -413,6 +414,7 @@ namespace pinocchio
   protected:
     
     friend struct Serialize<JointModelCompositeTpl>;
+    friend struct internal::DynamicMemoryFootprint<JointModelCompositeTpl>;
     
     template<typename, int, template<typename,int> class>
     friend struct JointModelCompositeTpl;
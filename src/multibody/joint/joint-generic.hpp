@@ -9,6 +9,7 @@
 #include "pinocchio/multibody/joint/joint-composite.hpp"
 #include "pinocchio/multibody/joint/joint-basic-visitors.hxx"
 #include "pinocchio/container/aligned-vector.hpp"
+#include "pinocchio/utils/memory-footprint.hpp"
 
 #include <boost/mpl/contains.hpp>
 
@@ -231,6 +232,71 @@ namespace pinocchio
   
   typedef PINOCCHIO_ALIGNED_STD_VECTOR(JointData) JointDataVector;
   typedef PINOCCHIO_ALIGNED_STD_VECTOR(JointModel) JointModelVector;
+  
+  namespace internal
+  {
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    struct DynamicMemoryFootprint< JointDataCompositeTpl<Scalar,Options,JointCollectionTpl> >
+    {
+      typedef JointDataCompositeTpl<Scalar,Options,JointCollectionTpl> JointData;
+      
+      static std::size_t run(const JointData & jdata)
+      {
+        return dynamicMemoryFootprint(jdata.joints)
+        + dynamicMemoryFootprint(jdata.iMlast) + dynamicMemoryFootprint(jdata.pjMi)
+        + (std::size_t)jdata.S.matrix().size() * sizeof(Scalar)
+        + dynamicMemoryFootprint(jdata.U) + dynamicMemoryFootprint(jdata.Dinv)
+        + dynamicMemoryFootprint(jdata.UDinv) + dynamicMemoryFootprint(jdata.StU);
+      }
+    };
+    
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    struct DynamicMemoryFootprint< JointModelCompositeTpl<Scalar,Options,JointCollectionTpl> >
+    {
+      typedef JointModelCompositeTpl<Scalar,Options,JointCollectionTpl> JointModel;
+      
+      static std::size_t run(const JointModel & jmodel)
+      {
+        return dynamicMemoryFootprint(jmodel.joints) + dynamicMemoryFootprint(jmodel.jointPlacements)
+        + dynamicMemoryFootprint(jmodel.m_idx_q) + dynamicMemoryFootprint(jmodel.m_nqs)
+        + dynamicMemoryFootprint(jmodel.m_idx_v) + dynamicMemoryFootprint(jmodel.m_nvs);
+      }
+    };
+    
+    ///
+    /// \brief Visitor computing the memory dynamically allocated by the joint contained in a joint variant.
+    ///
+    struct JointMemoryFootprintVisitor
+    : boost::static_visitor<std::size_t>
+    {
+      template<typename JointType>
+      std::size_t operator()(const JointType & joint) const
+      { return dynamicMemoryFootprint(joint); }
+      
+      // The composite joints are stored on the heap by the variants (see boost::recursive_wrapper).
+      template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+      std::size_t operator()(const JointDataCompositeTpl<Scalar,Options,JointCollectionTpl> & jdata) const
+      { return sizeof(jdata) + dynamicMemoryFootprint(jdata); }
+      
+      template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+      std::size_t operator()(const JointModelCompositeTpl<Scalar,Options,JointCollectionTpl> & jmodel) const
+      { return sizeof(jmodel) + dynamicMemoryFootprint(jmodel); }
+    };
+    
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    struct DynamicMemoryFootprint< JointDataTpl<Scalar,Options,JointCollectionTpl> >
+    {
+      static std::size_t run(const JointDataTpl<Scalar,Options,JointCollectionTpl> & jdata)
+      { return boost::apply_visitor(JointMemoryFootprintVisitor(),jdata.toVariant()); }
+    };
+    
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    struct DynamicMemoryFootprint< JointModelTpl<Scalar,Options,JointCollectionTpl> >
+    {
+      static std::size_t run(const JointModelTpl<Scalar,Options,JointCollectionTpl> & jmodel)
+      { return boost::apply_visitor(JointMemoryFootprintVisitor(),jmodel.toVariant()); }
+    };
+  } // namespace internal
 
 } // namespace pinocchio
 
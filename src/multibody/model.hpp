@@ -557,6 +557,11 @@ namespace pinocchio
     /// \return true if the data is valid, false otherwise.
     ///
     inline bool check(const Data & data) const;
+    
+    ///
+    /// \returns the memory footprint of the model, detailed field by field.
+    ///
+    MemoryFootprint memoryFootprint() const;
 
   protected:
     
@@ -289,6 +289,38 @@ namespace pinocchio
     return FrameIndex(nframes - 1);
   }
   
+  template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+  inline MemoryFootprint ModelTpl<Scalar,Options,JointCollectionTpl>::
+  memoryFootprint() const
+  {
+    MemoryFootprint footprint(sizeof(*this));
+    
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,inertias);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,jointPlacements);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,joints);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,idx_qs);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,nqs);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,idx_vs);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,nvs);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,parents);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,names);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,referenceConfigurations);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,rotorInertia);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,rotorGearRatio);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,friction);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,damping);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,effortLimit);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,velocityLimit);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,lowerPositionLimit);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,upperPositionLimit);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,frames);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,supports);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,subtrees);
+    PINOCCHIO_ADD_MEMORY_FOOTPRINT(footprint,*this,name);
+    
+    return footprint;
+  }
+  
   template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
   inline void ModelTpl<Scalar,Options,JointCollectionTpl>::
   addJointIndexToParentSubtrees(const JointIndex joint_id)
@@ -0,0 +1,23 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_multibody_pool_fwd_hpp__
+#define __pinocchio_multibody_pool_fwd_hpp__
+
+#include "pinocchio/multibody/fwd.hpp"
+
+namespace pinocchio
+{
+  
+  template<typename Scalar, int Options = 0, template<typename S, int O> class JointCollectionTpl = JointCollectionDefaultTpl>
+  class ModelPoolTpl;
+  typedef ModelPoolTpl<double> ModelPool;
+  
+  template<typename Scalar, int Options = 0, template<typename S, int O> class JointCollectionTpl = JointCollectionDefaultTpl>
+  class GeometryPoolTpl;
+  typedef GeometryPoolTpl<double> GeometryPool;
+  
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_multibody_pool_fwd_hpp__
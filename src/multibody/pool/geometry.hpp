@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_multibody_pool_geometry_hpp__
+#define __pinocchio_multibody_pool_geometry_hpp__
+
+#include "pinocchio/multibody/pool/model.hpp"
+#include "pinocchio/multibody/geometry.hpp"
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Pool of Data and GeometryData objects sharing a common Model and a common GeometryModel.
+  ///        The collision geometries are shared between the GeometryData of the pool, such that only the placements and the collision/distance results are duplicated.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  ///
+  template<typename _Scalar, int _Options, template<typename,int> class JointCollectionTpl>
+  class GeometryPoolTpl
+  : public ModelPoolTpl<_Scalar,_Options,JointCollectionTpl>
+  {
+  public:
+    
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    
+    typedef ModelPoolTpl<_Scalar,_Options,JointCollectionTpl> Base;
+    typedef _Scalar Scalar;
+    enum { Options = _Options };
+    
+    typedef typename Base::Model Model;
+    typedef typename Base::Data Data;
+    typedef typename Base::DataVector DataVector;
+    typedef ::pinocchio::GeometryModel GeometryModel;
+    typedef ::pinocchio::GeometryData GeometryData;
+    
+    typedef PINOCCHIO_ALIGNED_STD_VECTOR(GeometryData) GeometryDataVector;
+    
+    using Base::update;
+    using Base::size;
+    
+    ///
+    /// \brief Default constructor from a model, a geometry model and a pool size.
+    ///
+    /// \param[in] model The input model.
+    /// \param[in] geometry_model The input geometry model.
+    /// \param[in] pool_size The number of Data and GeometryData contained in the pool (default: value of OMP_NUM_THREADS).
+    ///
+    GeometryPoolTpl(const Model & model,
+                    const GeometryModel & geometry_model,
+                    const size_t pool_size = (size_t)getOpenMPNumThreadsEnv())
+    : Base(model,pool_size)
+    , m_geometry_model(geometry_model)
+    , m_geometry_datas(pool_size, GeometryData(geometry_model))
+    {}
+    
+    virtual ~GeometryPoolTpl() {}
+    
+    /// \brief Returns the geometry model stored within the pool.
+    const GeometryModel & geometry_model() const { return m_geometry_model; }
+    
+    /// \brief Returns the vector of GeometryData.
+    const GeometryDataVector & geometry_datas() const { return m_geometry_datas; }
+    
+    /// \brief Returns the vector of GeometryData.
+    GeometryDataVector & geometry_datas() { return m_geometry_datas; }
+    
+    /// \brief Returns the GeometryData at index index.
+    const GeometryData & geometry_data(const size_t index) const
+    {
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(index < m_geometry_datas.size(),
+                                     "Index greater than the size of the pool.");
+      return m_geometry_datas[index];
+    }
+    
+    /// \brief Returns the GeometryData at index index.
+    GeometryData & geometry_data(const size_t index)
+    {
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(index < m_geometry_datas.size(),
+                                     "Index greater than the size of the pool.");
+      return m_geometry_datas[index];
+    }
+    
+    ///
+    /// \brief Update the geometry model stored within the pool.
+    ///        All the GeometryData of the pool are re-allocated from the new geometry model.
+    ///
+    /// \param[in] geometry_model The new geometry model.
+    ///
+    void update(const GeometryModel & geometry_model)
+    {
+      m_geometry_model = geometry_model;
+      m_geometry_datas.assign(m_geometry_datas.size(), GeometryData(m_geometry_model));
+    }
+    
+    ///
+    /// \brief Copy the input geometry data into all the GeometryData of the pool.
+    ///
+    /// \param[in] geometry_data The new geometry data value.
+    ///
+    void update(const GeometryData & geometry_data)
+    {
+      std::fill(m_geometry_datas.begin(), m_geometry_datas.end(), geometry_data);
+    }
+    
+    ///
+    /// \brief Update the geometry model stored within the pool and set all the GeometryData of the pool to the input geometry data.
+    ///
+    /// \param[in] geometry_model The new geometry model.
+    /// \param[in] geometry_data The new geometry data value (it should be consistent with geometry_model).
+    ///
+    void update(const GeometryModel & geometry_model,
+                const GeometryData & geometry_data)
+    {
+      m_geometry_model = geometry_model;
+      update(geometry_data);
+    }
+    
+  protected:
+    
+    /// \brief Resize the vector of GeometryData.
+    virtual void doResize(const size_t new_size)
+    {
+      if(new_size > m_geometry_datas.size())
+        m_geometry_datas.resize(new_size, GeometryData(m_geometry_model));
+      else
+        m_geometry_datas.erase(m_geometry_datas.begin() + (std::ptrdiff_t)new_size, m_geometry_datas.end());
+    }
+    
+    /// \brief Geometry model stored within the pool and shared by all the GeometryData.
+    GeometryModel m_geometry_model;
+    
+    /// \brief Vector of GeometryData, one per working thread.
+    GeometryDataVector m_geometry_datas;
+    
+  }; // class GeometryPoolTpl
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_multibody_pool_geometry_hpp__
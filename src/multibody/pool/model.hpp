@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_multibody_pool_model_hpp__
+#define __pinocchio_multibody_pool_model_hpp__
+
+#include "pinocchio/multibody/pool/fwd.hpp"
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+#include "pinocchio/container/aligned-vector.hpp"
+#include "pinocchio/utils/openmp.hpp"
+
+#include <algorithm>
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Pool of Data objects sharing a common Model.
+  ///        It is the entry point of the parallel algorithms, which assign one Data of the pool to each working thread.
+  ///        The Data are allocated once at construction (or when resizing the pool), such that no allocation occurs when evaluating the algorithms.
+  ///
+  /// \tparam JointCollection Collection of Joint types.
+  ///
+  template<typename _Scalar, int _Options, template<typename,int> class JointCollectionTpl>
+  class ModelPoolTpl
+  {
+  public:
+    
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    
+    typedef _Scalar Scalar;
+    enum { Options = _Options };
+    
+    typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+    typedef DataTpl<Scalar,Options,JointCollectionTpl> Data;
+    
+    typedef PINOCCHIO_ALIGNED_STD_VECTOR(Data) DataVector;
+    
+    ///
+    /// \brief Default constructor from a model and a pool size.
+    ///
+    /// \param[in] model The input model.
+    /// \param[in] pool_size The number of Data contained in the pool (default: value of OMP_NUM_THREADS).
+    ///
+    explicit ModelPoolTpl(const Model & model,
+                          const size_t pool_size = (size_t)getOpenMPNumThreadsEnv())
+    : m_model(model)
+    , m_datas(pool_size, Data(model))
+    {}
+    
+    virtual ~ModelPoolTpl() {}
+    
+    /// \brief Returns the model stored within the pool.
+    const Model & model() const { return m_model; }
+    
+    ///
+    /// \brief Update the model stored within the pool.
+    ///        All the Data of the pool are re-allocated from the new model.
+    ///
+    /// \param[in] model The new model.
+    ///
+    void update(const Model & model)
+    {
+      m_model = model;
+      m_datas.assign(m_datas.size(), Data(m_model));
+    }
+    
+    ///
+    /// \brief Copy the input data into all the Data of the pool.
+    ///
+    /// \param[in] data The new data value.
+    ///
+    void update(const Data & data)
+    {
+      std::fill(m_datas.begin(), m_datas.end(), data);
+    }
+    
+    ///
+    /// \brief Update the model stored within the pool and set all the Data of the pool to the input data.
+    ///
+    /// \param[in] model The new model.
+    /// \param[in] data The new data value (it should be consistent with model).
+    ///
+    void update(const Model & model, const Data & data)
+    {
+      m_model = model;
+      update(data);
+    }
+    
+    /// \brief Returns the number of Data contained in the pool.
+    size_t size() const { return m_datas.size(); }
+    
+    ///
+    /// \brief Resize the pool. New Data are allocated from the model stored in the pool.
+    ///
+    /// \param[in] new_size The new size of the pool.
+    ///
+    void resize(const size_t new_size)
+    {
+      if(new_size > m_datas.size())
+        m_datas.resize(new_size, Data(m_model));
+      else
+        m_datas.resize(new_size);
+      
+      doResize(new_size);
+    }
+    
+    /// \brief Returns the vector of Data.
+    const DataVector & datas() const { return m_datas; }
+    
+    /// \brief Returns the vector of Data.
+    DataVector & datas() { return m_datas; }
+    
+    /// \brief Returns the Data at index index.
+    const Data & data(const size_t index) const
+    {
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(index < m_datas.size(),
+                                     "Index greater than the size of the pool.");
+      return m_datas[index];
+    }
+    
+    /// \brief Returns the Data at index index.
+    Data & data(const size_t index)
+    {
+      PINOCCHIO_CHECK_INPUT_ARGUMENT(index < m_datas.size(),
+                                     "Index greater than the size of the pool.");
+      return m_datas[index];
+    }
+    
+  protected:
+    
+    /// \brief Method to implement in the derived classes to resize the additional quantities stored within the pool.
+    virtual void doResize(const size_t new_size)
+    {
+      PINOCCHIO_UNUSED_VARIABLE(new_size);
+    }
+    
+    /// \brief Model stored within the pool and shared by all the Data.
+    Model m_model;
+    
+    /// \brief Vector of Data, one per working thread.
+    DataVector m_datas;
+    
+  }; // class ModelPoolTpl
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_multibody_pool_model_hpp__
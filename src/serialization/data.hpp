@@ -7,6 +7,7 @@
 
 #include <boost/serialization/variant.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "pinocchio/serialization/aligned-vector.hpp"
 #include "pinocchio/serialization/spatial.hpp"
@@ -24,7 +25,7 @@ namespace boost
     template<class Archive, typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
     void serialize(Archive & ar,
                    pinocchio::DataTpl<Scalar,Options,JointCollectionTpl> & data,
-                   const unsigned int /*version*/)
+                   const unsigned int version)
     {
       PINOCCHIO_MAKE_DATA_NVP(ar,data,joints);
       PINOCCHIO_MAKE_DATA_NVP(ar,data,a);
@@ -105,7 +106,20 @@ namespace boost
       PINOCCHIO_MAKE_DATA_NVP(ar,data,bodyRegressor);
       PINOCCHIO_MAKE_DATA_NVP(ar,data,jointTorqueRegressor);
       PINOCCHIO_MAKE_DATA_NVP(ar,data,kinematic_hessians);
+      // The archives of version 0 have been written before the optional buffers could be left unallocated.
+      if(version >= 1)
+        PINOCCHIO_MAKE_DATA_NVP(ar,data,allocation);
+      else
+        data.allocation = pinocchio::ALLOCATE_ALL;
     }
+
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    struct version< pinocchio::DataTpl<Scalar,Options,JointCollectionTpl> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
     
   } // namespace serialization
 } // namespace boost
@@ -0,0 +1,1011 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_serialization_flat_binary_hpp__
+#define __pinocchio_serialization_flat_binary_hpp__
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/geometry.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/size.hpp>
+#include <boost/mpl/identity.hpp>
+#include <boost/mpl/placeholders.hpp>
+#include <boost/variant.hpp>
+
+#ifndef WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace pinocchio
+{
+  namespace serialization
+  {
+
+    ///
+    /// \brief Layout of the flat binary format.
+    ///
+    /// A file starts with a header (magic string, format version, kind of object, size of the scalar type and endianness marker),
+    /// followed by the content of the object as a sequence of raw arrays, each one aligned on FLAT_BINARY_ALIGNMENT bytes.
+    /// Loading a file amounts to copying these arrays into the object: there is nothing to parse.
+    /// The joint models are stored as records of fixed size (see details::FlatBinaryJointArrays).
+    ///
+    struct FlatBinaryFormat
+    {
+      enum { VERSION = 1 };
+      enum { ALIGNMENT = 16 };
+      enum Kind { MODEL = 1, GEOMETRY_MODEL = 2 };
+
+      static const char * magic() { return "PINFLAT"; } // 8 bytes with the trailing '\0'
+      static boost::uint32_t endiannessMarker() { return 0x01020304; }
+    };
+
+    namespace details
+    {
+      /// \brief Writes the content of an object into a flat binary buffer.
+      class FlatBinaryWriter
+      {
+      public:
+
+        explicit FlatBinaryWriter(std::string & buffer)
+        : buffer(buffer)
+        {}
+
+        void writeHeader(const FlatBinaryFormat::Kind kind, const boost::uint32_t scalar_size)
+        {
+          buffer.append(FlatBinaryFormat::magic(),8);
+          write<boost::uint32_t>(FlatBinaryFormat::VERSION);
+          write<boost::uint32_t>((boost::uint32_t)kind);
+          write<boost::uint32_t>(scalar_size);
+          write<boost::uint32_t>(FlatBinaryFormat::endiannessMarker());
+        }
+
+        template<typename T>
+        void write(const T & value)
+        {
+          buffer.append(reinterpret_cast<const char *>(&value),sizeof(T));
+        }
+
+        /// \brief Write the number of elements, then the elements at the next aligned offset.
+        template<typename T>
+        void writeArray(const T * data, const std::size_t size)
+        {
+          PINOCCHIO_STATIC_ASSERT(boost::is_arithmetic<T>::value,FLAT_BINARY_ARRAYS_ONLY_STORE_ARITHMETIC_TYPES);
+          write<boost::uint64_t>(size);
+          buffer.append((FlatBinaryFormat::ALIGNMENT - buffer.size() % FlatBinaryFormat::ALIGNMENT) % FlatBinaryFormat::ALIGNMENT,'\0');
+          if(size > 0)
+            buffer.append(reinterpret_cast<const char *>(data),size * sizeof(T));
+        }
+
+        template<typename T>
+        void writeVector(const std::vector<T> & vec)
+        {
+          writeArray(vec.empty() ? NULL : &vec[0],vec.size());
+        }
+
+        template<typename VectorLike>
+        void writeEigen(const Eigen::MatrixBase<VectorLike> & vec)
+        {
+          typedef typename VectorLike::Scalar Scalar;
+          const Eigen::Matrix<Scalar,Eigen::Dynamic,1> vec_(vec);
+          writeArray(vec_.data(),(std::size_t)vec_.size());
+        }
+
+        void writeString(const std::string & str)
+        {
+          writeArray(str.data(),str.size());
+        }
+
+        void writeStrings(const std::vector<std::string> & strings)
+        {
+          write<boost::uint64_t>(strings.size());
+          for(std::size_t k = 0; k < strings.size(); ++k)
+            writeString(strings[k]);
+        }
+
+        /// \brief Write a list of index vectors as their sizes followed by their concatenation.
+        template<typename IndexVector>
+        void writeIndexVectors(const std::vector<IndexVector> & vectors)
+        {
+          std::vector<boost::uint64_t> sizes, indexes;
+          for(std::size_t k = 0; k < vectors.size(); ++k)
+          {
+            sizes.push_back(vectors[k].size());
+            indexes.insert(indexes.end(),vectors[k].begin(),vectors[k].end());
+          }
+          writeVector(sizes);
+          writeVector(indexes);
+        }
+
+        template<typename SE3Vector>
+        void writePlacements(const SE3Vector & placements)
+        {
+          typedef typename SE3Vector::value_type::Scalar Scalar;
+          std::vector<Scalar> values;
+          values.reserve(12 * placements.size());
+          for(std::size_t k = 0; k < placements.size(); ++k)
+          {
+            const typename SE3Vector::value_type & M = placements[k];
+            values.insert(values.end(),M.rotation().data(),M.rotation().data() + 9);
+            values.insert(values.end(),M.translation().data(),M.translation().data() + 3);
+          }
+          writeVector(values);
+        }
+
+      protected:
+
+        std::string & buffer;
+      };
+
+      /// \brief Reads the content of an object from a flat binary buffer, checking that each read stays in the buffer.
+      class FlatBinaryReader
+      {
+      public:
+
+        FlatBinaryReader(const char * data, const std::size_t size)
+        : data(data), size(size), pos(0)
+        {}
+
+        void readHeader(const FlatBinaryFormat::Kind kind, const boost::uint32_t scalar_size)
+        {
+          check(8);
+          if(std::memcmp(data,FlatBinaryFormat::magic(),8) != 0)
+            throw std::invalid_argument("The buffer does not contain an object in the flat binary format.");
+          pos += 8;
+          if(read<boost::uint32_t>() != FlatBinaryFormat::VERSION)
+            throw std::invalid_argument("The version of the flat binary format is not supported.");
+          if(read<boost::uint32_t>() != (boost::uint32_t)kind)
+            throw std::invalid_argument("The buffer does not contain an object of the requested type.");
+          if(read<boost::uint32_t>() != scalar_size)
+            throw std::invalid_argument("The buffer has been written with another scalar type.");
+          if(read<boost::uint32_t>() != FlatBinaryFormat::endiannessMarker())
+            throw std::invalid_argument("The buffer has been written on a platform with another endianness.");
+        }
+
+        template<typename T>
+        T read()
+        {
+          check(sizeof(T));
+          T value;
+          std::memcpy(&value,data + pos,sizeof(T));
+          pos += sizeof(T);
+          return value;
+        }
+
+        ///
+        /// \brief Read the number of elements of an array and skip to its first element.
+        ///
+        /// \returns a pointer to the first element, inside the buffer.
+        ///
+        template<typename T>
+        const char * readArray(std::size_t & num_elements)
+        {
+          PINOCCHIO_STATIC_ASSERT(boost::is_arithmetic<T>::value,FLAT_BINARY_ARRAYS_ONLY_STORE_ARITHMETIC_TYPES);
+          num_elements = (std::size_t)read<boost::uint64_t>();
+          pos += (FlatBinaryFormat::ALIGNMENT - pos % FlatBinaryFormat::ALIGNMENT) % FlatBinaryFormat::ALIGNMENT;
+          if(num_elements > (size - std::min(pos,size)) / sizeof(T))
+            throw std::invalid_argument("The flat binary buffer is truncated.");
+          const char * res = data + pos;
+          pos += num_elements * sizeof(T);
+          return res;
+        }
+
+        template<typename T, typename Allocator>
+        void readVector(std::vector<T,Allocator> & vec)
+        {
+          std::size_t num_elements;
+          const char * src = readArray<T>(num_elements);
+          vec.resize(num_elements);
+          if(num_elements > 0)
+            std::memcpy(&vec[0],src,num_elements * sizeof(T));
+        }
+
+        /// \brief Read an array of indexes and convert them to Index.
+        template<typename Index>
+        void readIndexes(std::vector<Index> & vec)
+        {
+          std::vector<boost::uint64_t> indexes;
+          readVector(indexes);
+          vec.assign(indexes.begin(),indexes.end());
+        }
+
+        template<typename Scalar, int Options>
+        void readEigen(Eigen::Matrix<Scalar,Eigen::Dynamic,1,Options> & vec)
+        {
+          std::size_t num_elements;
+          const char * src = readArray<Scalar>(num_elements);
+          vec.resize((Eigen::DenseIndex)num_elements);
+          if(num_elements > 0)
+            std::memcpy(vec.data(),src,num_elements * sizeof(Scalar));
+        }
+
+        std::string readString()
+        {
+          std::size_t num_elements;
+          const char * src = readArray<char>(num_elements);
+          return std::string(src,num_elements);
+        }
+
+        void readStrings(std::vector<std::string> & strings)
+        {
+          const std::size_t num_strings = (std::size_t)read<boost::uint64_t>();
+          // each string takes at least the 8 bytes of its size
+          if(num_strings > (size - std::min(pos,size)) / sizeof(boost::uint64_t))
+            throw std::invalid_argument("The flat binary buffer is truncated.");
+          strings.resize(num_strings);
+          for(std::size_t k = 0; k < num_strings; ++k)
+            strings[k] = readString();
+        }
+
+        template<typename IndexVector>
+        void readIndexVectors(std::vector<IndexVector> & vectors)
+        {
+          std::vector<boost::uint64_t> sizes, indexes;
+          readVector(sizes);
+          readVector(indexes);
+          vectors.resize(sizes.size());
+          std::size_t it = 0;
+          for(std::size_t k = 0; k < sizes.size(); ++k)
+          {
+            if(sizes[k] > indexes.size() - it)
+              throw std::invalid_argument("The flat binary buffer is corrupted.");
+            vectors[k].assign(indexes.begin() + (std::ptrdiff_t)it,indexes.begin() + (std::ptrdiff_t)(it + sizes[k]));
+            it += sizes[k];
+          }
+        }
+
+        template<typename SE3Vector>
+        void readPlacements(SE3Vector & placements)
+        {
+          typedef typename SE3Vector::value_type SE3;
+          typedef typename SE3::Scalar Scalar;
+          std::vector<Scalar> values;
+          readVector(values);
+          if(values.size() % 12 != 0)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+          placements.resize(values.size() / 12);
+          for(std::size_t k = 0; k < placements.size(); ++k)
+          {
+            placements[k].rotation() = Eigen::Map<const typename SE3::Matrix3>(&values[12*k]);
+            placements[k].translation() = Eigen::Map<const typename SE3::Vector3>(&values[12*k+9]);
+          }
+        }
+
+      protected:
+
+        void check(const std::size_t num_bytes) const
+        {
+          if(pos > size || num_bytes > size - pos)
+            throw std::invalid_argument("The flat binary buffer is truncated.");
+        }
+
+        const char * data;
+        const std::size_t size;
+        std::size_t pos;
+      };
+
+      ///
+      /// \brief Read-only mapping of a file in memory.
+      ///        Falls back to reading the file in a buffer on platforms without mmap.
+      ///
+      class MappedFile
+      {
+      public:
+
+        explicit MappedFile(const std::string & filename)
+        : mapped_data(NULL), mapped_size(0)
+        {
+#ifndef WIN32
+          const int fd = ::open(filename.c_str(),O_RDONLY);
+          if(fd < 0)
+            throw std::invalid_argument(filename + " does not seem to be a valid file.");
+          struct stat st;
+          if(::fstat(fd,&st) == 0 && st.st_size > 0)
+          {
+            void * ptr = ::mmap(NULL,(std::size_t)st.st_size,PROT_READ,MAP_SHARED,fd,0);
+            if(ptr != MAP_FAILED)
+            {
+              mapped_data = static_cast<const char *>(ptr);
+              mapped_size = (std::size_t)st.st_size;
+            }
+          }
+          ::close(fd);
+          if(mapped_data != NULL)
+            return;
+#endif
+          std::ifstream ifs(filename.c_str(),std::ios::binary);
+          if(!ifs)
+            throw std::invalid_argument(filename + " does not seem to be a valid file.");
+          std::ostringstream oss;
+          oss << ifs.rdbuf();
+          buffer = oss.str();
+        }
+
+        ~MappedFile()
+        {
+#ifndef WIN32
+          if(mapped_data != NULL)
+            ::munmap(const_cast<char *>(mapped_data),mapped_size);
+#endif
+        }
+
+        const char * data() const { return mapped_data != NULL ? mapped_data : buffer.data(); }
+        std::size_t size() const { return mapped_data != NULL ? mapped_size : buffer.size(); }
+
+      private:
+
+        MappedFile(const MappedFile &);
+        MappedFile & operator=(const MappedFile &);
+
+        const char * mapped_data;
+        std::size_t mapped_size;
+        std::string buffer;
+      };
+
+      ///
+      /// \brief Joint models stored as flat arrays.
+      ///        Each joint, including the joints nested in a composite or a mimic joint, is a record made of its type (index in the joint variant),
+      ///        its indexes (id, idx_q, idx_v), NUM_PARAMETERS scalar parameters (the axis of the unaligned joints, the scaling and the offset of the mimic joints)
+      ///        and its number of nested joints. The records are stored in pre-order, the nested joints following their parent.
+      ///        The placements of the joints nested in the composite joints are stored in the same order.
+      ///
+      template<typename Scalar, int Options>
+      struct FlatBinaryJointArrays
+      {
+        typedef SE3Tpl<Scalar,Options> SE3;
+        enum { NUM_PARAMETERS = 3 };
+
+        std::vector<boost::int32_t> types;
+        std::vector<boost::int64_t> indexes;
+        std::vector<Scalar> parameters;
+        std::vector<boost::uint64_t> num_children;
+        PINOCCHIO_ALIGNED_STD_VECTOR(SE3) placements;
+
+        void write(FlatBinaryWriter & writer) const
+        {
+          writer.writeVector(types);
+          writer.writeVector(indexes);
+          writer.writeVector(parameters);
+          writer.writeVector(num_children);
+          writer.writePlacements(placements);
+        }
+
+        void read(FlatBinaryReader & reader)
+        {
+          reader.readVector(types);
+          reader.readVector(indexes);
+          reader.readVector(parameters);
+          reader.readVector(num_children);
+          reader.readPlacements(placements);
+          if(indexes.size() != 3*types.size() || parameters.size() != NUM_PARAMETERS*types.size()
+             || num_children.size() != types.size())
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+        }
+      };
+
+      /// \brief Appends the records of a joint and of its nested joints to FlatBinaryJointArrays.
+      template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+      struct FlatBinaryJointEncoder : boost::static_visitor<void>
+      {
+        typedef JointModelTpl<Scalar,Options,JointCollectionTpl> JointModel;
+        typedef FlatBinaryJointArrays<Scalar,Options> Arrays;
+
+        explicit FlatBinaryJointEncoder(Arrays & arrays)
+        : arrays(arrays)
+        {}
+
+        static void run(const JointModel & jmodel, Arrays & arrays)
+        {
+          arrays.types.push_back((boost::int32_t)jmodel.toVariant().which());
+          arrays.indexes.push_back((boost::int64_t)jmodel.id());
+          arrays.indexes.push_back((boost::int64_t)jmodel.idx_q());
+          arrays.indexes.push_back((boost::int64_t)jmodel.idx_v());
+          boost::apply_visitor(FlatBinaryJointEncoder(arrays),jmodel.toVariant());
+        }
+
+        template<typename JointModelDerived>
+        void operator()(const JointModelBase<JointModelDerived> &) const
+        { addRecord(Scalar(0),Scalar(0),Scalar(0),0); }
+
+        void operator()(const JointModelRevoluteUnalignedTpl<Scalar,Options> & jmodel) const
+        { addRecord(jmodel.axis[0],jmodel.axis[1],jmodel.axis[2],0); }
+
+        void operator()(const JointModelRevoluteUnboundedUnalignedTpl<Scalar,Options> & jmodel) const
+        { addRecord(jmodel.axis[0],jmodel.axis[1],jmodel.axis[2],0); }
+
+        void operator()(const JointModelPrismaticUnalignedTpl<Scalar,Options> & jmodel) const
+        { addRecord(jmodel.axis[0],jmodel.axis[1],jmodel.axis[2],0); }
+
+        template<typename ReferenceJointModel>
+        void operator()(const JointModelMimic<ReferenceJointModel> & jmodel) const
+        {
+          addRecord(jmodel.scaling(),jmodel.offset(),Scalar(0),1);
+          run(JointModel(jmodel.jmodel()),arrays);
+        }
+
+        void operator()(const JointModelCompositeTpl<Scalar,Options,JointCollectionTpl> & jmodel) const
+        {
+          addRecord(Scalar(0),Scalar(0),Scalar(0),jmodel.joints.size());
+          for(std::size_t k = 0; k < jmodel.joints.size(); ++k)
+          {
+            run(jmodel.joints[k],arrays);
+            arrays.placements.push_back(jmodel.jointPlacements[k]);
+          }
+        }
+
+      protected:
+
+        void addRecord(const Scalar & p0, const Scalar & p1, const Scalar & p2, const std::size_t num_children) const
+        {
+          arrays.parameters.push_back(p0);
+          arrays.parameters.push_back(p1);
+          arrays.parameters.push_back(p2);
+          arrays.num_children.push_back(num_children);
+        }
+
+        Arrays & arrays;
+      };
+
+      /// \brief Rebuilds the joint models from FlatBinaryJointArrays, checking the type and the number of nested joints of each record.
+      template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+      class FlatBinaryJointDecoder
+      {
+      public:
+
+        typedef JointModelTpl<Scalar,Options,JointCollectionTpl> JointModel;
+        typedef FlatBinaryJointArrays<Scalar,Options> Arrays;
+        typedef typename JointCollectionTpl<Scalar,Options>::JointModelVariant JointModelVariant;
+        typedef typename JointModelVariant::types JointModelTypes;
+
+        explicit FlatBinaryJointDecoder(const Arrays & arrays)
+        : arrays(arrays), next_record(0), next_placement(0)
+        {}
+
+        /// \brief Decode the next record and its nested joints.
+        JointModel decode()
+        {
+          if(next_record >= arrays.types.size())
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+          const std::size_t record = next_record++;
+          const boost::int32_t type = arrays.types[record];
+          if(type < 0 || type >= (boost::int32_t)boost::mpl::size<JointModelTypes>::value)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+
+          JointModel jmodel;
+          boost::mpl::for_each<JointModelTypes, boost::mpl::make_identity<boost::mpl::_1> >(TypeDispatcher(*this,record,jmodel));
+          return jmodel;
+        }
+
+        /// \returns true if all the records and placements have been decoded.
+        bool finished() const
+        { return next_record == arrays.types.size() && next_placement == arrays.placements.size(); }
+
+      protected:
+
+        /// \brief Builds the joint of the type of the record, among the types of the joint variant.
+        struct TypeDispatcher
+        {
+          TypeDispatcher(FlatBinaryJointDecoder & decoder, const std::size_t record, JointModel & jmodel)
+          : decoder(decoder), record(record), jmodel(jmodel), type(0)
+          {}
+
+          template<typename JointModelDerived>
+          void operator()(boost::mpl::identity<JointModelDerived>)
+          {
+            if(type++ != arrays().types[record])
+              return;
+            JointModelDerived joint;
+            decoder.init(joint,record);
+            const boost::int64_t * indexes = &arrays().indexes[3*record];
+            joint.setIndexes((JointIndex)indexes[0],(int)indexes[1],(int)indexes[2]);
+            jmodel = JointModel(joint);
+          }
+
+          const Arrays & arrays() const { return decoder.arrays; }
+
+          FlatBinaryJointDecoder & decoder;
+          const std::size_t record;
+          JointModel & jmodel;
+          boost::int32_t type;
+        };
+
+        template<typename JointModelDerived>
+        void init(JointModelBase<JointModelDerived> &, const std::size_t record)
+        { checkNumChildren(record,0); }
+
+        void init(JointModelRevoluteUnalignedTpl<Scalar,Options> & jmodel, const std::size_t record)
+        { checkNumChildren(record,0); jmodel.axis = axis(record); }
+
+        void init(JointModelRevoluteUnboundedUnalignedTpl<Scalar,Options> & jmodel, const std::size_t record)
+        { checkNumChildren(record,0); jmodel.axis = axis(record); }
+
+        void init(JointModelPrismaticUnalignedTpl<Scalar,Options> & jmodel, const std::size_t record)
+        { checkNumChildren(record,0); jmodel.axis = axis(record); }
+
+        template<typename ReferenceJointModel>
+        void init(JointModelMimic<ReferenceJointModel> & jmodel, const std::size_t record)
+        {
+          checkNumChildren(record,1);
+          const JointModel reference = decode();
+          const ReferenceJointModel * reference_ptr = boost::get<ReferenceJointModel>(&reference.toVariant());
+          if(reference_ptr == NULL)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+          const Scalar * parameters = &arrays.parameters[Arrays::NUM_PARAMETERS*record];
+          jmodel = JointModelMimic<ReferenceJointModel>(*reference_ptr,parameters[0],parameters[1]);
+        }
+
+        void init(JointModelCompositeTpl<Scalar,Options,JointCollectionTpl> & jmodel, const std::size_t record)
+        {
+          // each nested joint takes at least one record
+          const boost::uint64_t num_children = arrays.num_children[record];
+          if(num_children > arrays.types.size() - next_record)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+          for(boost::uint64_t k = 0; k < num_children; ++k)
+          {
+            const JointModel child = decode();
+            if(next_placement >= arrays.placements.size())
+              throw std::invalid_argument("The flat binary buffer is corrupted.");
+            jmodel.addJoint(child,arrays.placements[next_placement++]);
+          }
+        }
+
+        void checkNumChildren(const std::size_t record, const boost::uint64_t num_children) const
+        {
+          if(arrays.num_children[record] != num_children)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+        }
+
+        Eigen::Matrix<Scalar,3,1,Options> axis(const std::size_t record) const
+        { return Eigen::Map<const Eigen::Matrix<Scalar,3,1> >(&arrays.parameters[Arrays::NUM_PARAMETERS*record]); }
+
+        const Arrays & arrays;
+        std::size_t next_record, next_placement;
+      };
+
+      inline void saveBufferToFile(const std::string & buffer, const std::string & filename)
+      {
+        std::ofstream ofs(filename.c_str(),std::ios::binary);
+        if(!ofs)
+          throw std::invalid_argument(filename + " does not seem to be a valid file.");
+        ofs.write(buffer.data(),(std::streamsize)buffer.size());
+      }
+    } // namespace details
+
+    ///
+    /// \brief Saves a model into a buffer in the flat binary format.
+    ///
+    /// \param[in]  model The model to save.
+    /// \param[out] buffer The buffer containing the serialized model.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    void saveToFlatBinaryBuffer(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                std::string & buffer)
+    {
+      typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+
+      buffer.clear();
+      details::FlatBinaryWriter writer(buffer);
+      writer.writeHeader(FlatBinaryFormat::MODEL,(boost::uint32_t)sizeof(Scalar));
+
+      writer.write<boost::int32_t>(model.nq);
+      writer.write<boost::int32_t>(model.nv);
+      writer.write<boost::int32_t>(model.njoints);
+      writer.write<boost::int32_t>(model.nbodies);
+      writer.write<boost::int32_t>(model.nframes);
+      writer.writeString(model.name);
+
+      writer.writeVector(model.idx_qs);
+      writer.writeVector(model.nqs);
+      writer.writeVector(model.idx_vs);
+      writer.writeVector(model.nvs);
+      writer.writeVector(std::vector<boost::uint64_t>(model.parents.begin(),model.parents.end()));
+      writer.writeStrings(model.names);
+      writer.writeIndexVectors(model.supports);
+      writer.writeIndexVectors(model.subtrees);
+      writer.writeEigen(model.gravity.toVector());
+
+      writer.write<boost::uint64_t>(model.referenceConfigurations.size());
+      for(typename Model::ConfigVectorMap::const_iterator it = model.referenceConfigurations.begin();
+          it != model.referenceConfigurations.end(); ++it)
+      {
+        writer.writeString(it->first);
+        writer.writeEigen(it->second);
+      }
+
+      writer.writeEigen(model.rotorInertia);
+      writer.writeEigen(model.rotorGearRatio);
+      writer.writeEigen(model.friction);
+      writer.writeEigen(model.damping);
+      writer.writeEigen(model.effortLimit);
+      writer.writeEigen(model.velocityLimit);
+      writer.writeEigen(model.lowerPositionLimit);
+      writer.writeEigen(model.upperPositionLimit);
+
+      // inertias: mass, lever, then the 6 coefficients of the rotational inertia
+      std::vector<Scalar> inertias;
+      inertias.reserve(10 * model.inertias.size());
+      for(std::size_t k = 0; k < model.inertias.size(); ++k)
+      {
+        const typename Model::Inertia & I = model.inertias[k];
+        inertias.push_back(I.mass());
+        inertias.insert(inertias.end(),I.lever().data(),I.lever().data() + 3);
+        inertias.insert(inertias.end(),I.inertia().data().data(),I.inertia().data().data() + 6);
+      }
+      writer.writeVector(inertias);
+      writer.writePlacements(model.jointPlacements);
+
+      {
+        details::FlatBinaryJointArrays<Scalar,Options> joints;
+        for(std::size_t k = 0; k < model.joints.size(); ++k)
+          details::FlatBinaryJointEncoder<Scalar,Options,JointCollectionTpl>::run(model.joints[k],joints);
+        joints.write(writer);
+      }
+
+      std::vector<std::string> frame_names;
+      std::vector<boost::uint64_t> frame_parents, frame_previous_frames;
+      std::vector<boost::int32_t> frame_types;
+      PINOCCHIO_ALIGNED_STD_VECTOR(typename Model::SE3) frame_placements;
+      for(std::size_t k = 0; k < model.frames.size(); ++k)
+      {
+        const typename Model::Frame & frame = model.frames[k];
+        frame_names.push_back(frame.name);
+        frame_parents.push_back(frame.parent);
+        frame_previous_frames.push_back(frame.previousFrame);
+        frame_types.push_back((boost::int32_t)frame.type);
+        frame_placements.push_back(frame.placement);
+      }
+      writer.writeStrings(frame_names);
+      writer.writeVector(frame_parents);
+      writer.writeVector(frame_previous_frames);
+      writer.writeVector(frame_types);
+      writer.writePlacements(frame_placements);
+    }
+
+    ///
+    /// \brief Loads a model from a buffer in the flat binary format.
+    ///
+    /// \param[out] model The loaded model, left unchanged if the buffer is rejected.
+    /// \param[in]  data Beginning of the buffer, e.g. a memory-mapped file or a shared memory segment.
+    /// \param[in]  size Size of the buffer in bytes.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    void loadFromFlatBinaryBuffer(ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                                  const char * data, const std::size_t size)
+    {
+      typedef ModelTpl<Scalar,Options,JointCollectionTpl> Model;
+
+      Model loaded;
+
+      details::FlatBinaryReader reader(data,size);
+      reader.readHeader(FlatBinaryFormat::MODEL,(boost::uint32_t)sizeof(Scalar));
+
+      loaded.nq = reader.read<boost::int32_t>();
+      loaded.nv = reader.read<boost::int32_t>();
+      loaded.njoints = reader.read<boost::int32_t>();
+      loaded.nbodies = reader.read<boost::int32_t>();
+      loaded.nframes = reader.read<boost::int32_t>();
+      loaded.name = reader.readString();
+
+      reader.readVector(loaded.idx_qs);
+      reader.readVector(loaded.nqs);
+      reader.readVector(loaded.idx_vs);
+      reader.readVector(loaded.nvs);
+      reader.readIndexes(loaded.parents);
+      reader.readStrings(loaded.names);
+      reader.readIndexVectors(loaded.supports);
+      reader.readIndexVectors(loaded.subtrees);
+      {
+        typename Model::VectorXs gravity;
+        reader.readEigen(gravity);
+        PINOCCHIO_CHECK_ARGUMENT_SIZE(gravity.size(),6);
+        loaded.gravity.toVector() = gravity;
+      }
+
+      loaded.referenceConfigurations.clear();
+      const std::size_t num_configurations = (std::size_t)reader.read<boost::uint64_t>();
+      for(std::size_t k = 0; k < num_configurations; ++k)
+      {
+        const std::string name = reader.readString();
+        typename Model::ConfigVectorType q;
+        reader.readEigen(q);
+        loaded.referenceConfigurations.insert(std::make_pair(name,q));
+      }
+
+      reader.readEigen(loaded.rotorInertia);
+      reader.readEigen(loaded.rotorGearRatio);
+      reader.readEigen(loaded.friction);
+      reader.readEigen(loaded.damping);
+      reader.readEigen(loaded.effortLimit);
+      reader.readEigen(loaded.velocityLimit);
+      reader.readEigen(loaded.lowerPositionLimit);
+      reader.readEigen(loaded.upperPositionLimit);
+
+      {
+        std::vector<Scalar> inertias;
+        reader.readVector(inertias);
+        if(inertias.size() % 10 != 0)
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+        loaded.inertias.resize(inertias.size() / 10);
+        for(std::size_t k = 0; k < loaded.inertias.size(); ++k)
+        {
+          const Scalar * I = &inertias[10*k];
+          loaded.inertias[k] = typename Model::Inertia(I[0],
+                                                       Eigen::Map<const typename Model::Vector3>(I+1),
+                                                       typename Model::Inertia::Symmetric3(Eigen::Map<const typename Model::Inertia::Vector6>(I+4)));
+        }
+      }
+      reader.readPlacements(loaded.jointPlacements);
+
+      const std::size_t njoints = (std::size_t)loaded.njoints;
+      {
+        details::FlatBinaryJointArrays<Scalar,Options> joints;
+        joints.read(reader);
+        details::FlatBinaryJointDecoder<Scalar,Options,JointCollectionTpl> decoder(joints);
+        loaded.joints.clear();
+        // each joint takes at least one record
+        if(loaded.njoints < 1 || njoints > joints.types.size())
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+        for(std::size_t k = 0; k < njoints; ++k)
+          loaded.joints.push_back(decoder.decode());
+        if(!decoder.finished())
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+      }
+
+      // The sizes are checked against the dimensions of the model, which Data and the algorithms rely on.
+      if(loaded.nq < 0 || loaded.nv < 0 || loaded.njoints < 1 || loaded.nbodies < 1 || loaded.nframes < 0
+         || loaded.idx_qs.size() != njoints || loaded.nqs.size() != njoints
+         || loaded.idx_vs.size() != njoints || loaded.nvs.size() != njoints
+         || loaded.parents.size() != njoints || loaded.names.size() != njoints
+         || loaded.supports.size() != njoints || loaded.subtrees.size() != njoints
+         || loaded.inertias.size() != njoints || loaded.jointPlacements.size() != njoints
+         || loaded.joints.size() != njoints)
+        throw std::invalid_argument("The flat binary buffer is corrupted.");
+      if(loaded.rotorInertia.size() != loaded.nv || loaded.rotorGearRatio.size() != loaded.nv
+         || loaded.friction.size() != loaded.nv || loaded.damping.size() != loaded.nv
+         || loaded.effortLimit.size() != loaded.nv || loaded.velocityLimit.size() != loaded.nv
+         || loaded.lowerPositionLimit.size() != loaded.nq || loaded.upperPositionLimit.size() != loaded.nq)
+        throw std::invalid_argument("The flat binary buffer is corrupted.");
+      for(typename Model::ConfigVectorMap::const_iterator it = loaded.referenceConfigurations.begin();
+          it != loaded.referenceConfigurations.end(); ++it)
+      {
+        if(it->second.size() != loaded.nq)
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+      }
+      for(std::size_t k = 0; k < njoints; ++k)
+      {
+        if(loaded.parents[k] >= njoints
+           || loaded.idx_qs[k] < 0 || loaded.nqs[k] < 0 || loaded.idx_qs[k] > loaded.nq - loaded.nqs[k]
+           || loaded.idx_vs[k] < 0 || loaded.nvs[k] < 0 || loaded.idx_vs[k] > loaded.nv - loaded.nvs[k])
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+        // the universe (k = 0) has no indexes
+        if(k > 0 && (loaded.joints[k].id() != k
+                     || loaded.joints[k].idx_q() != loaded.idx_qs[k] || loaded.joints[k].nq() != loaded.nqs[k]
+                     || loaded.joints[k].idx_v() != loaded.idx_vs[k] || loaded.joints[k].nv() != loaded.nvs[k]))
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+        for(std::size_t i = 0; i < loaded.supports[k].size(); ++i)
+          if(loaded.supports[k][i] >= njoints)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+        for(std::size_t i = 0; i < loaded.subtrees[k].size(); ++i)
+          if(loaded.subtrees[k][i] >= njoints)
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+      }
+
+      std::vector<std::string> frame_names;
+      std::vector<boost::uint64_t> frame_parents, frame_previous_frames;
+      std::vector<boost::int32_t> frame_types;
+      PINOCCHIO_ALIGNED_STD_VECTOR(typename Model::SE3) frame_placements;
+      reader.readStrings(frame_names);
+      reader.readVector(frame_parents);
+      reader.readVector(frame_previous_frames);
+      reader.readVector(frame_types);
+      reader.readPlacements(frame_placements);
+      const std::size_t nframes = (std::size_t)loaded.nframes;
+      if(frame_names.size() != nframes || frame_parents.size() != nframes || frame_previous_frames.size() != nframes
+         || frame_types.size() != nframes || frame_placements.size() != nframes)
+        throw std::invalid_argument("The flat binary buffer is corrupted.");
+      for(std::size_t k = 0; k < nframes; ++k)
+      {
+        if(frame_parents[k] >= njoints || frame_previous_frames[k] >= nframes)
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+        switch(frame_types[k])
+        {
+          case OP_FRAME: case JOINT: case FIXED_JOINT: case BODY: case SENSOR:
+            break;
+          default:
+            throw std::invalid_argument("The flat binary buffer is corrupted.");
+        }
+      }
+
+      loaded.frames.clear();
+      loaded.frames.reserve(frame_names.size());
+      for(std::size_t k = 0; k < frame_names.size(); ++k)
+        loaded.frames.push_back(typename Model::Frame(frame_names[k],
+                                                      (JointIndex)frame_parents[k],
+                                                      (FrameIndex)frame_previous_frames[k],
+                                                      frame_placements[k],
+                                                      (FrameType)frame_types[k]));
+
+      // The model is only modified once the whole buffer has been decoded and checked.
+      std::swap(model,loaded);
+    }
+
+    ///
+    /// \brief Saves a model into a file in the flat binary format.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    void saveToFlatBinary(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                          const std::string & filename)
+    {
+      std::string buffer;
+      saveToFlatBinaryBuffer(model,buffer);
+      details::saveBufferToFile(buffer,filename);
+    }
+
+    ///
+    /// \brief Loads a model from a file in the flat binary format. The file is memory-mapped and its arrays copied into the model.
+    ///
+    template<typename Scalar, int Options, template<typename,int> class JointCollectionTpl>
+    void loadFromFlatBinary(ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                            const std::string & filename)
+    {
+      const details::MappedFile file(filename);
+      loadFromFlatBinaryBuffer(model,file.data(),file.size());
+    }
+
+    ///
+    /// \brief Saves a geometry model into a buffer in the flat binary format.
+    ///        The collision geometries (meshes and shapes) are not saved: only their description (name, parents, placement, mesh path, scale, color...).
+    ///
+    inline void saveToFlatBinaryBuffer(const GeometryModel & geom_model,
+                                       std::string & buffer)
+    {
+      typedef GeometryModel::Scalar Scalar;
+
+      buffer.clear();
+      details::FlatBinaryWriter writer(buffer);
+      writer.writeHeader(FlatBinaryFormat::GEOMETRY_MODEL,(boost::uint32_t)sizeof(Scalar));
+
+      std::vector<std::string> names, mesh_paths, mesh_texture_paths;
+      std::vector<boost::uint64_t> parent_frames, parent_joints;
+      std::vector<boost::uint8_t> override_materials;
+      std::vector<Scalar> mesh_scales, mesh_colors;
+      PINOCCHIO_ALIGNED_STD_VECTOR(GeometryModel::SE3) placements;
+      for(std::size_t k = 0; k < geom_model.geometryObjects.size(); ++k)
+      {
+        const GeometryObject & object = geom_model.geometryObjects[k];
+        names.push_back(object.name);
+        parent_frames.push_back(object.parentFrame);
+        parent_joints.push_back(object.parentJoint);
+        placements.push_back(object.placement);
+        mesh_paths.push_back(object.meshPath);
+        mesh_scales.insert(mesh_scales.end(),object.meshScale.data(),object.meshScale.data() + 3);
+        override_materials.push_back(object.overrideMaterial ? 1 : 0);
+        mesh_colors.insert(mesh_colors.end(),object.meshColor.data(),object.meshColor.data() + 4);
+        mesh_texture_paths.push_back(object.meshTexturePath);
+      }
+
+      writer.write<boost::uint64_t>(geom_model.ngeoms);
+      writer.writeStrings(names);
+      writer.writeVector(parent_frames);
+      writer.writeVector(parent_joints);
+      writer.writePlacements(placements);
+      writer.writeStrings(mesh_paths);
+      writer.writeVector(mesh_scales);
+      writer.writeVector(override_materials);
+      writer.writeVector(mesh_colors);
+      writer.writeStrings(mesh_texture_paths);
+
+      std::vector<boost::uint64_t> collision_pairs;
+      for(std::size_t k = 0; k < geom_model.collisionPairs.size(); ++k)
+      {
+        collision_pairs.push_back(geom_model.collisionPairs[k].first);
+        collision_pairs.push_back(geom_model.collisionPairs[k].second);
+      }
+      writer.writeVector(collision_pairs);
+    }
+
+    ///
+    /// \brief Loads a geometry model from a buffer in the flat binary format.
+    ///        The collision geometries of the loaded objects are empty and must be attached by the user if needed.
+    ///        The geometry model is left unchanged if the buffer is rejected.
+    ///
+    inline void loadFromFlatBinaryBuffer(GeometryModel & geom_model,
+                                         const char * data, const std::size_t size)
+    {
+      typedef GeometryModel::Scalar Scalar;
+
+      details::FlatBinaryReader reader(data,size);
+      reader.readHeader(FlatBinaryFormat::GEOMETRY_MODEL,(boost::uint32_t)sizeof(Scalar));
+
+      std::vector<std::string> names, mesh_paths, mesh_texture_paths;
+      std::vector<boost::uint64_t> parent_frames, parent_joints;
+      std::vector<boost::uint8_t> override_materials;
+      std::vector<Scalar> mesh_scales, mesh_colors;
+      PINOCCHIO_ALIGNED_STD_VECTOR(GeometryModel::SE3) placements;
+
+      const std::size_t ngeoms = (std::size_t)reader.read<boost::uint64_t>();
+      reader.readStrings(names);
+      reader.readVector(parent_frames);
+      reader.readVector(parent_joints);
+      reader.readPlacements(placements);
+      reader.readStrings(mesh_paths);
+      reader.readVector(mesh_scales);
+      reader.readVector(override_materials);
+      reader.readVector(mesh_colors);
+      reader.readStrings(mesh_texture_paths);
+      if(names.size() != ngeoms || parent_frames.size() != ngeoms || parent_joints.size() != ngeoms
+         || placements.size() != ngeoms || mesh_paths.size() != ngeoms || mesh_scales.size() != 3*ngeoms
+         || override_materials.size() != ngeoms || mesh_colors.size() != 4*ngeoms || mesh_texture_paths.size() != ngeoms)
+        throw std::invalid_argument("The flat binary buffer is corrupted.");
+
+      std::vector<boost::uint64_t> collision_pairs;
+      reader.readVector(collision_pairs);
+      if(collision_pairs.size() % 2 != 0)
+        throw std::invalid_argument("The flat binary buffer is corrupted.");
+      for(std::size_t k = 0; k < collision_pairs.size(); ++k)
+      {
+        if(collision_pairs[k] >= ngeoms)
+          throw std::invalid_argument("The flat binary buffer is corrupted.");
+      }
+
+      GeometryModel loaded;
+      loaded.ngeoms = ngeoms;
+      loaded.geometryObjects.reserve(ngeoms);
+      for(std::size_t k = 0; k < ngeoms; ++k)
+      {
+        loaded.geometryObjects.push_back(GeometryObject(names[k],
+                                                        (FrameIndex)parent_frames[k],
+                                                        (JointIndex)parent_joints[k],
+                                                        GeometryObject::CollisionGeometryPtr(),
+                                                        placements[k],
+                                                        mesh_paths[k],
+                                                        Eigen::Map<const Eigen::Vector3d>(&mesh_scales[3*k]),
+                                                        override_materials[k] != 0,
+                                                        Eigen::Map<const Eigen::Vector4d>(&mesh_colors[4*k]),
+                                                        mesh_texture_paths[k]));
+      }
+
+      for(std::size_t k = 0; k < collision_pairs.size(); k += 2)
+        loaded.collisionPairs.push_back(CollisionPair((GeomIndex)collision_pairs[k],(GeomIndex)collision_pairs[k+1]));
+
+      // The geometry model is only modified once the whole buffer has been decoded and checked.
+      std::swap(geom_model,loaded);
+    }
+
+    ///
+    /// \brief Saves a geometry model, without its collision geometries, into a file in the flat binary format.
+    ///
+    inline void saveToFlatBinary(const GeometryModel & geom_model,
+                                 const std::string & filename)
+    {
+      std::string buffer;
+      saveToFlatBinaryBuffer(geom_model,buffer);
+      details::saveBufferToFile(buffer,filename);
+    }
+
+    ///
+    /// \brief Loads a geometry model from a file in the flat binary format. The file is memory-mapped.
+    ///
+    inline void loadFromFlatBinary(GeometryModel & geom_model,
+                                   const std::string & filename)
+    {
+      const details::MappedFile file(filename);
+      loadFromFlatBinaryBuffer(geom_model,file.data(),file.size());
+    }
+
+  } // namespace serialization
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_serialization_flat_binary_hpp__
@@ -0,0 +1,685 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_serialization_trajectory_log_hpp__
+#define __pinocchio_serialization_trajectory_log_hpp__
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+
+#ifdef PINOCCHIO_WITH_ZLIB
+  #include <boost/iostreams/filtering_stream.hpp>
+  #include <boost/iostreams/filter/zlib.hpp>
+  #include <boost/iostreams/device/array.hpp>
+  #include <boost/iostreams/device/back_inserter.hpp>
+#endif
+
+namespace pinocchio
+{
+  namespace serialization
+  {
+
+    ///
+    /// \brief Fields which can be recorded in a trajectory log. They are combined as a bit mask.
+    ///
+    struct TrajectoryLogField
+    {
+      enum Type
+      {
+        Q         = 1 << 0, ///< configuration vector, of size nq.
+        V         = 1 << 1, ///< velocity vector, of size nv.
+        TAU       = 1 << 2, ///< data.tau, of size nv.
+        DDQ       = 1 << 3, ///< data.ddq, of size nv.
+        OMI       = 1 << 4, ///< data.oMi, 12 scalars per joint (rotation column major, then translation).
+        OMF       = 1 << 5, ///< data.oMf, 12 scalars per frame (rotation column major, then translation).
+        LAMBDA_C  = 1 << 6  ///< data.lambda_c, of the contact dimension given to the writer.
+      };
+    };
+
+    ///
+    /// \brief Layout of a trajectory log.
+    ///
+    /// A log is made of a header, a sequence of chunks and an index of the chunks.
+    /// The header starts with a magic string and an endianness marker: the values are written with the byte order
+    /// of the writing machine, and a log is only read back on a machine with the same byte order.
+    /// The header then describes the recorded fields and their sizes, so that all the samples have the same size.
+    /// Each chunk starts with its compression method, its number of samples, its size in bytes in the file and the time of its first sample,
+    /// followed by the samples, each one being the time followed by the recorded fields in the order of TrajectoryLogField.
+    /// With TrajectoryLogFormat::ZLIB, the samples of the chunk are compressed as a whole with zlib.
+    /// The index, written when the log is closed, stores the position, the first sample and the first time of each chunk.
+    /// A log which has not been closed (e.g. after a crash) has no index: the reader rebuilds it by scanning the headers of the chunks.
+    ///
+    struct TrajectoryLogFormat
+    {
+      enum { VERSION = 1 };
+      enum Compression
+      {
+        NONE = 0,
+        ZLIB = 1 ///< requires Pinocchio to be built with BUILD_WITH_ZLIB_SUPPORT.
+      };
+
+      static const char * magic() { return "PINTLOG"; } // 8 bytes with the trailing '\0'
+      static boost::uint32_t endiannessMarker() { return 0x01020304; }
+
+      /// \brief Size of the header, in bytes.
+      enum { HEADER_SIZE = 8 + 4 + 4 * 4 + 5 * 4 + 8 };
+
+      /// \brief Position of the index position in the header, in bytes.
+      enum { INDEX_POSITION_OFFSET = HEADER_SIZE - 8 };
+
+      /// \brief Size of the header of a chunk, in bytes, for a log of the given scalar type.
+      template<typename Scalar>
+      static std::size_t chunkHeaderSize() { return 4 + 4 + 8 + sizeof(Scalar); }
+    };
+
+    namespace details
+    {
+      /// \brief Sizes of the fields of a trajectory log.
+      struct TrajectoryLogLayout
+      {
+        TrajectoryLogLayout()
+        : fields(0), nq(0), nv(0), njoints(0), nframes(0), contact_dim(0)
+        {}
+
+        /// \returns the number of scalars of a sample, including the time.
+        std::size_t sampleSize() const
+        {
+          std::size_t res = 1;
+          if(fields & TrajectoryLogField::Q) res += (std::size_t)nq;
+          if(fields & TrajectoryLogField::V) res += (std::size_t)nv;
+          if(fields & TrajectoryLogField::TAU) res += (std::size_t)nv;
+          if(fields & TrajectoryLogField::DDQ) res += (std::size_t)nv;
+          if(fields & TrajectoryLogField::OMI) res += 12 * (std::size_t)njoints;
+          if(fields & TrajectoryLogField::OMF) res += 12 * (std::size_t)nframes;
+          if(fields & TrajectoryLogField::LAMBDA_C) res += (std::size_t)contact_dim;
+          return res;
+        }
+
+        boost::uint32_t fields;
+        boost::int32_t nq, nv, njoints, nframes, contact_dim;
+      };
+
+      template<typename T>
+      void writePOD(std::ostream & os, const T & value)
+      { os.write(reinterpret_cast<const char *>(&value),sizeof(T)); }
+
+      template<typename T>
+      T readPOD(std::istream & is)
+      {
+        T value;
+        is.read(reinterpret_cast<char *>(&value),sizeof(T));
+        if(!is)
+          throw std::invalid_argument("The trajectory log is truncated.");
+        return value;
+      }
+
+      template<typename Scalar, typename SE3Vector>
+      Scalar * packPlacements(Scalar * dst, const SE3Vector & placements)
+      {
+        for(std::size_t k = 0; k < placements.size(); ++k)
+        {
+          dst = std::copy(placements[k].rotation().data(),placements[k].rotation().data() + 9,dst);
+          dst = std::copy(placements[k].translation().data(),placements[k].translation().data() + 3,dst);
+        }
+        return dst;
+      }
+
+      template<typename Scalar, typename SE3Vector>
+      const Scalar * unpackPlacements(const Scalar * src, SE3Vector & placements)
+      {
+        typedef typename SE3Vector::value_type SE3;
+        for(std::size_t k = 0; k < placements.size(); ++k, src += 12)
+        {
+          placements[k].rotation() = Eigen::Map<const typename SE3::Matrix3>(src);
+          placements[k].translation() = Eigen::Map<const typename SE3::Vector3>(src + 9);
+        }
+        return src;
+      }
+
+#ifdef PINOCCHIO_WITH_ZLIB
+      /// \brief Compress size bytes of src into dst, whose capacity is reused.
+      inline void zlibCompress(const char * src, const std::size_t size, std::vector<char> & dst)
+      {
+        namespace io = boost::iostreams;
+        dst.clear();
+        io::filtering_ostream os;
+        os.push(io::zlib_compressor(io::zlib_params(io::zlib::best_speed)));
+        os.push(io::back_inserter(dst));
+        os.write(src,(std::streamsize)size);
+        os.reset(); // flush the compressor
+      }
+
+      /// \returns true if src decompresses into exactly dst_size bytes.
+      inline bool zlibDecompress(const char * src, const std::size_t size, char * dst, const std::size_t dst_size)
+      {
+        namespace io = boost::iostreams;
+        try
+        {
+          io::filtering_istream is;
+          is.push(io::zlib_decompressor());
+          is.push(io::array_source(src,size));
+          is.read(dst,(std::streamsize)dst_size);
+          return is.gcount() == (std::streamsize)dst_size && is.peek() == std::char_traits<char>::eof() && !is.bad();
+        }
+        catch(const std::exception &)
+        {
+          return false;
+        }
+      }
+#endif
+    } // namespace details
+
+    ///
+    /// \brief Writer of a trajectory log.
+    ///        The samples are copied into a pre-allocated chunk, which is written to the file in a single write once full:
+    ///        appending a sample costs at most one write of a chunk (and its compression), whatever the length of the log.
+    ///
+    template<typename _Scalar, int _Options = 0>
+    class TrajectoryLogWriterTpl
+    {
+    public:
+
+      typedef _Scalar Scalar;
+      enum { Options = _Options };
+
+      ///
+      /// \brief Create a trajectory log, replacing any existing file.
+      ///
+      /// \param[in] model The model whose data are recorded.
+      /// \param[in] filename Path of the log.
+      /// \param[in] fields The recorded fields, as a bit mask of TrajectoryLogField.
+      /// \param[in] contact_dim Size of data.lambda_c, if TrajectoryLogField::LAMBDA_C is recorded.
+      /// \param[in] samples_per_chunk Number of samples in a chunk.
+      /// \param[in] compression Compression of the chunks.
+      ///
+      template<template<typename,int> class JointCollectionTpl>
+      TrajectoryLogWriterTpl(const ModelTpl<Scalar,Options,JointCollectionTpl> & model,
+                             const std::string & filename,
+                             const int fields,
+                             const int contact_dim = 0,
+                             const std::size_t samples_per_chunk = 1000,
+                             const TrajectoryLogFormat::Compression compression = TrajectoryLogFormat::NONE)
+      : samples_per_chunk(samples_per_chunk)
+      , compression(compression)
+      , num_samples_in_chunk(0)
+      , num_samples(0)
+      {
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(samples_per_chunk > 0, "The number of samples per chunk must be positive.");
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(contact_dim >= 0, "The contact dimension must be non negative.");
+#ifdef PINOCCHIO_WITH_ZLIB
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(compression == TrajectoryLogFormat::NONE || compression == TrajectoryLogFormat::ZLIB,
+                                       "Unknown compression of the trajectory log.");
+#else
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(compression == TrajectoryLogFormat::NONE,
+                                       "The compression of the trajectory log requires Pinocchio to be built with BUILD_WITH_ZLIB_SUPPORT.");
+#endif
+
+        layout.fields = (boost::uint32_t)fields;
+        layout.nq = model.nq;
+        layout.nv = model.nv;
+        layout.njoints = model.njoints;
+        layout.nframes = model.nframes;
+        layout.contact_dim = contact_dim;
+        chunk.resize(samples_per_chunk * layout.sampleSize());
+
+        file.open(filename.c_str(),std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!file)
+          throw std::invalid_argument(filename + " does not seem to be a valid file.");
+
+        file.write(TrajectoryLogFormat::magic(),8);
+        details::writePOD<boost::uint32_t>(file,TrajectoryLogFormat::endiannessMarker());
+        details::writePOD<boost::uint32_t>(file,TrajectoryLogFormat::VERSION);
+        details::writePOD<boost::uint32_t>(file,(boost::uint32_t)sizeof(Scalar));
+        details::writePOD<boost::uint32_t>(file,layout.fields);
+        details::writePOD<boost::uint32_t>(file,(boost::uint32_t)samples_per_chunk);
+        details::writePOD<boost::int32_t>(file,layout.nq);
+        details::writePOD<boost::int32_t>(file,layout.nv);
+        details::writePOD<boost::int32_t>(file,layout.njoints);
+        details::writePOD<boost::int32_t>(file,layout.nframes);
+        details::writePOD<boost::int32_t>(file,layout.contact_dim);
+        details::writePOD<boost::uint64_t>(file,0); // position of the index, written by close()
+      }
+
+      ~TrajectoryLogWriterTpl()
+      {
+        try { close(); } catch(...) {}
+      }
+
+      ///
+      /// \brief Append a sample to the log.
+      ///
+      /// \param[in] time Time of the sample.
+      /// \param[in] q Configuration vector, recorded if TrajectoryLogField::Q is set.
+      /// \param[in] v Velocity vector, recorded if TrajectoryLogField::V is set.
+      /// \param[in] data Data containing the other recorded fields.
+      ///
+      /// \note The sample which fills the chunk also writes it to the file (see flush), so that this call is much longer than the others.
+      ///       In a time-critical loop, choose samples_per_chunk so that this write fits in the period,
+      ///       or call flush() explicitly when the loop has time to spare: the chunk is then written before being full.
+      ///
+      template<template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType>
+      void append(const Scalar & time,
+                  const Eigen::MatrixBase<ConfigVectorType> & q,
+                  const Eigen::MatrixBase<TangentVectorType> & v,
+                  const DataTpl<Scalar,Options,JointCollectionTpl> & data)
+      {
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(file.is_open(), "The trajectory log has been closed.");
+
+        // Check all the recorded fields before packing them into the fixed-size chunk.
+        if(layout.fields & TrajectoryLogField::Q)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(),layout.nq);
+        if(layout.fields & TrajectoryLogField::V)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(v.size(),layout.nv);
+        if(layout.fields & TrajectoryLogField::TAU)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(data.tau.size(),layout.nv);
+        if(layout.fields & TrajectoryLogField::DDQ)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(data.ddq.size(),layout.nv);
+        if(layout.fields & TrajectoryLogField::OMI)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE((int)data.oMi.size(),layout.njoints);
+        if(layout.fields & TrajectoryLogField::OMF)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE((int)data.oMf.size(),layout.nframes);
+        if(layout.fields & TrajectoryLogField::LAMBDA_C)
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(data.lambda_c.size(),layout.contact_dim);
+
+        Scalar * dst = &chunk[num_samples_in_chunk * layout.sampleSize()];
+        *dst++ = time;
+        if(layout.fields & TrajectoryLogField::Q)
+        {
+          Eigen::Map<Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(dst,layout.nq) = q; dst += layout.nq;
+        }
+        if(layout.fields & TrajectoryLogField::V)
+        {
+          Eigen::Map<Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(dst,layout.nv) = v; dst += layout.nv;
+        }
+        if(layout.fields & TrajectoryLogField::TAU)
+        {
+          Eigen::Map<Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(dst,layout.nv) = data.tau; dst += layout.nv;
+        }
+        if(layout.fields & TrajectoryLogField::DDQ)
+        {
+          Eigen::Map<Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(dst,layout.nv) = data.ddq; dst += layout.nv;
+        }
+        if(layout.fields & TrajectoryLogField::OMI)
+          dst = details::packPlacements(dst,data.oMi);
+        if(layout.fields & TrajectoryLogField::OMF)
+          dst = details::packPlacements(dst,data.oMf);
+        if(layout.fields & TrajectoryLogField::LAMBDA_C)
+          Eigen::Map<Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(dst,layout.contact_dim) = data.lambda_c;
+
+        if(num_samples_in_chunk == 0)
+          first_times.push_back(time);
+        ++num_samples_in_chunk;
+        ++num_samples;
+        if(num_samples_in_chunk == samples_per_chunk)
+          flush();
+      }
+
+      ///
+      /// \brief Compress and write the current chunk to the file, even if it is not full.
+      ///
+      void flush()
+      {
+        if(num_samples_in_chunk == 0)
+          return;
+
+        const char * bytes = reinterpret_cast<const char *>(&chunk[0]);
+        boost::uint64_t num_bytes = num_samples_in_chunk * layout.sampleSize() * sizeof(Scalar);
+#ifdef PINOCCHIO_WITH_ZLIB
+        if(compression == TrajectoryLogFormat::ZLIB)
+        {
+          details::zlibCompress(bytes,(std::size_t)num_bytes,compressed_chunk);
+          bytes = &compressed_chunk[0];
+          num_bytes = compressed_chunk.size();
+        }
+#endif
+        chunk_positions.push_back((boost::uint64_t)file.tellp());
+        chunk_sizes.push_back((boost::uint32_t)num_samples_in_chunk);
+        details::writePOD<boost::uint32_t>(file,(boost::uint32_t)compression);
+        details::writePOD<boost::uint32_t>(file,(boost::uint32_t)num_samples_in_chunk);
+        details::writePOD<boost::uint64_t>(file,num_bytes);
+        details::writePOD<Scalar>(file,first_times.back());
+        file.write(bytes,(std::streamsize)num_bytes);
+        file.flush();
+        num_samples_in_chunk = 0;
+      }
+
+      ///
+      /// \brief Write the pending samples and the index, then close the file.
+      ///
+      void close()
+      {
+        if(!file.is_open())
+          return;
+        flush();
+
+        const boost::uint64_t index_position = (boost::uint64_t)file.tellp();
+        details::writePOD<boost::uint64_t>(file,chunk_positions.size());
+        boost::uint64_t first_sample = 0;
+        for(std::size_t k = 0; k < chunk_positions.size(); ++k)
+        {
+          details::writePOD<boost::uint64_t>(file,chunk_positions[k]);
+          details::writePOD<boost::uint64_t>(file,first_sample);
+          details::writePOD<Scalar>(file,first_times[k]);
+          first_sample += chunk_sizes[k];
+        }
+        file.seekp(TrajectoryLogFormat::INDEX_POSITION_OFFSET);
+        details::writePOD<boost::uint64_t>(file,index_position);
+        file.close();
+      }
+
+      /// \returns the number of samples appended to the log.
+      std::size_t size() const { return num_samples; }
+
+    protected:
+
+      std::ofstream file;
+      details::TrajectoryLogLayout layout;
+      const std::size_t samples_per_chunk;
+      const TrajectoryLogFormat::Compression compression;
+
+      /// \brief Samples of the current chunk.
+      std::vector<Scalar> chunk;
+      /// \brief Compressed bytes of the current chunk, kept to reuse their memory.
+      std::vector<char> compressed_chunk;
+      std::size_t num_samples_in_chunk;
+      std::size_t num_samples;
+
+      /// \brief Index of the chunks written so far.
+      std::vector<boost::uint64_t> chunk_positions;
+      std::vector<boost::uint32_t> chunk_sizes;
+      std::vector<Scalar> first_times;
+
+    }; // class TrajectoryLogWriterTpl
+
+    ///
+    /// \brief Reader of a trajectory log, giving random access to its samples.
+    ///        Only the chunk containing the requested sample is loaded in memory.
+    ///
+    template<typename _Scalar, int _Options = 0>
+    class TrajectoryLogReaderTpl
+    {
+    public:
+
+      typedef _Scalar Scalar;
+      enum { Options = _Options };
+
+      ///
+      /// \brief Open a trajectory log and load its index.
+      ///
+      explicit TrajectoryLogReaderTpl(const std::string & filename)
+      : file_size(0)
+      , loaded_chunk((std::size_t)-1)
+      {
+        file.open(filename.c_str(),std::ios::in | std::ios::binary);
+        if(!file)
+          throw std::invalid_argument(filename + " does not seem to be a valid file.");
+
+        char magic[8];
+        file.read(magic,8);
+        if(!file || std::memcmp(magic,TrajectoryLogFormat::magic(),8) != 0)
+          throw std::invalid_argument(filename + " is not a trajectory log.");
+        const boost::uint32_t marker = details::readPOD<boost::uint32_t>(file);
+        if(marker == 0x04030201)
+          throw std::invalid_argument("The trajectory log has been written on a platform with another endianness.");
+        if(marker != TrajectoryLogFormat::endiannessMarker())
+          throw std::invalid_argument(filename + " is not a trajectory log.");
+        if(details::readPOD<boost::uint32_t>(file) != TrajectoryLogFormat::VERSION)
+          throw std::invalid_argument("The version of the trajectory log is not supported.");
+        if(details::readPOD<boost::uint32_t>(file) != sizeof(Scalar))
+          throw std::invalid_argument("The trajectory log has been written with another scalar type.");
+        layout.fields = details::readPOD<boost::uint32_t>(file);
+        details::readPOD<boost::uint32_t>(file); // number of samples per chunk
+        layout.nq = details::readPOD<boost::int32_t>(file);
+        layout.nv = details::readPOD<boost::int32_t>(file);
+        layout.njoints = details::readPOD<boost::int32_t>(file);
+        layout.nframes = details::readPOD<boost::int32_t>(file);
+        layout.contact_dim = details::readPOD<boost::int32_t>(file);
+        const boost::uint64_t index_position = details::readPOD<boost::uint64_t>(file);
+
+        file.seekg(0,std::ios::end);
+        file_size = (boost::uint64_t)file.tellg();
+
+        if(index_position != 0)
+          readIndex(index_position);
+        else
+          rebuildIndex();
+      }
+
+      /// \returns the number of samples of the log.
+      std::size_t size() const { return chunk_first_samples.empty() ? 0 : chunk_first_samples.back(); }
+
+      /// \returns the recorded fields, as a bit mask of TrajectoryLogField.
+      int getFields() const { return (int)layout.fields; }
+
+      /// \returns true if the field is recorded in the log.
+      bool hasField(const TrajectoryLogField::Type field) const { return (layout.fields & field) != 0; }
+
+      /// \returns the size of data.lambda_c in the log.
+      int getContactDimension() const { return layout.contact_dim; }
+
+      ///
+      /// \brief Read a sample of the log.
+      ///
+      /// \param[in] k Index of the sample.
+      /// \param[out] time Time of the sample.
+      /// \param[out] q Configuration vector, left unchanged if TrajectoryLogField::Q is not recorded.
+      /// \param[out] v Velocity vector, left unchanged if TrajectoryLogField::V is not recorded.
+      /// \param[out] data Data whose recorded fields are set.
+      ///
+      template<template<typename,int> class JointCollectionTpl, typename ConfigVectorType, typename TangentVectorType>
+      void read(const std::size_t k,
+                Scalar & time,
+                const Eigen::MatrixBase<ConfigVectorType> & q,
+                const Eigen::MatrixBase<TangentVectorType> & v,
+                DataTpl<Scalar,Options,JointCollectionTpl> & data)
+      {
+        const Scalar * src = sample(k);
+        time = *src++;
+        if(layout.fields & TrajectoryLogField::Q)
+        {
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(q.size(),layout.nq);
+          PINOCCHIO_EIGEN_CONST_CAST(ConfigVectorType,q) = Eigen::Map<const Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(src,layout.nq);
+          src += layout.nq;
+        }
+        if(layout.fields & TrajectoryLogField::V)
+        {
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(v.size(),layout.nv);
+          PINOCCHIO_EIGEN_CONST_CAST(TangentVectorType,v) = Eigen::Map<const Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(src,layout.nv);
+          src += layout.nv;
+        }
+        if(layout.fields & TrajectoryLogField::TAU)
+        {
+          data.tau = Eigen::Map<const Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(src,layout.nv); src += layout.nv;
+        }
+        if(layout.fields & TrajectoryLogField::DDQ)
+        {
+          data.ddq = Eigen::Map<const Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(src,layout.nv); src += layout.nv;
+        }
+        if(layout.fields & TrajectoryLogField::OMI)
+        {
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(data.oMi.size(),(std::size_t)layout.njoints);
+          src = details::unpackPlacements(src,data.oMi);
+        }
+        if(layout.fields & TrajectoryLogField::OMF)
+        {
+          PINOCCHIO_CHECK_ARGUMENT_SIZE(data.oMf.size(),(std::size_t)layout.nframes);
+          src = details::unpackPlacements(src,data.oMf);
+        }
+        if(layout.fields & TrajectoryLogField::LAMBDA_C)
+          data.lambda_c = Eigen::Map<const Eigen::Matrix<Scalar,Eigen::Dynamic,1> >(src,layout.contact_dim);
+      }
+
+      ///
+      /// \returns the index of the last sample whose time is lower or equal to the given time,
+      ///          or 0 if the time is before the first sample. The times are assumed to be increasing.
+      ///
+      std::size_t find(const Scalar & time)
+      {
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(size() > 0, "The trajectory log is empty.");
+        std::size_t chunk_id = (std::size_t)(std::upper_bound(chunk_first_times.begin(),chunk_first_times.end(),time)
+                                             - chunk_first_times.begin());
+        if(chunk_id > 0) --chunk_id;
+
+        std::size_t res = chunk_first_samples[chunk_id];
+        for(std::size_t k = res + 1; k < chunk_first_samples[chunk_id+1]; ++k)
+        {
+          if(*sample(k) > time)
+            break;
+          res = k;
+        }
+        return res;
+      }
+
+    protected:
+
+      /// \returns a pointer to the sample k, loading its chunk if needed.
+      const Scalar * sample(const std::size_t k)
+      {
+        PINOCCHIO_CHECK_INPUT_ARGUMENT(k < size(), "The index of the sample is out of range.");
+        const std::size_t chunk_id = (std::size_t)(std::upper_bound(chunk_first_samples.begin(),chunk_first_samples.end(),k)
+                                                   - chunk_first_samples.begin()) - 1;
+        if(chunk_id != loaded_chunk)
+          loadChunk(chunk_id);
+        return &chunk[(k - chunk_first_samples[chunk_id]) * layout.sampleSize()];
+      }
+
+      void loadChunk(const std::size_t chunk_id)
+      {
+        file.clear();
+        file.seekg((std::streamoff)chunk_positions[chunk_id]);
+        const boost::uint32_t compression = details::readPOD<boost::uint32_t>(file);
+#ifdef PINOCCHIO_WITH_ZLIB
+        if(compression != TrajectoryLogFormat::NONE && compression != TrajectoryLogFormat::ZLIB)
+#else
+        if(compression != TrajectoryLogFormat::NONE)
+#endif
+          throw std::invalid_argument("The compression of the trajectory log is not supported.");
+        const std::size_t num_samples = details::readPOD<boost::uint32_t>(file);
+        const boost::uint64_t num_bytes = details::readPOD<boost::uint64_t>(file);
+        details::readPOD<Scalar>(file); // time of the first sample, stored in the index
+        const boost::uint64_t num_sample_bytes = num_samples * layout.sampleSize() * sizeof(Scalar);
+        if(num_samples == 0 || num_bytes == 0
+           || num_samples != chunk_first_samples[chunk_id+1] - chunk_first_samples[chunk_id]
+           || (compression == TrajectoryLogFormat::NONE && num_bytes != num_sample_bytes)
+           || num_bytes > file_size - chunk_positions[chunk_id] - TrajectoryLogFormat::chunkHeaderSize<Scalar>())
+          throw std::invalid_argument("The trajectory log is corrupted.");
+
+        // The chunk in memory is overwritten: it must not be used anymore if the read fails.
+        loaded_chunk = (std::size_t)-1;
+        chunk.resize(num_samples * layout.sampleSize());
+        char * bytes = reinterpret_cast<char *>(&chunk[0]);
+#ifdef PINOCCHIO_WITH_ZLIB
+        if(compression == TrajectoryLogFormat::ZLIB)
+        {
+          compressed_chunk.resize((std::size_t)num_bytes);
+          bytes = &compressed_chunk[0];
+        }
+#endif
+        file.read(bytes,(std::streamsize)num_bytes);
+        if(!file)
+          throw std::invalid_argument("The trajectory log is truncated.");
+#ifdef PINOCCHIO_WITH_ZLIB
+        if(compression == TrajectoryLogFormat::ZLIB
+           && !details::zlibDecompress(bytes,(std::size_t)num_bytes,
+                                       reinterpret_cast<char *>(&chunk[0]),(std::size_t)num_sample_bytes))
+          throw std::invalid_argument("The trajectory log is corrupted.");
+#endif
+        loaded_chunk = chunk_id;
+      }
+
+      void readIndex(const boost::uint64_t index_position)
+      {
+        // The index, made of the number of chunks followed by one entry per chunk, ends the file.
+        const boost::uint64_t index_entry_size = 8 + 8 + sizeof(Scalar);
+        if(index_position < TrajectoryLogFormat::HEADER_SIZE || index_position > file_size - 8)
+          throw std::invalid_argument("The trajectory log is corrupted.");
+        file.seekg((std::streamoff)index_position);
+        const boost::uint64_t num_chunks = details::readPOD<boost::uint64_t>(file);
+        if(num_chunks > (file_size - index_position - 8) / index_entry_size)
+          throw std::invalid_argument("The trajectory log is corrupted.");
+
+        for(std::size_t k = 0; k < (std::size_t)num_chunks; ++k)
+        {
+          const boost::uint64_t position = details::readPOD<boost::uint64_t>(file);
+          const std::size_t first_sample = (std::size_t)details::readPOD<boost::uint64_t>(file);
+          if(position < TrajectoryLogFormat::HEADER_SIZE
+             || position > index_position - TrajectoryLogFormat::chunkHeaderSize<Scalar>()
+             || (k > 0 && (position <= chunk_positions.back() || first_sample <= chunk_first_samples.back()))
+             || (k == 0 && first_sample != 0))
+            throw std::invalid_argument("The trajectory log is corrupted.");
+          chunk_positions.push_back(position);
+          chunk_first_samples.push_back(first_sample);
+          chunk_first_times.push_back(details::readPOD<Scalar>(file));
+        }
+
+        // the number of samples of the last chunk is read in its header
+        std::size_t num_samples = 0;
+        if(num_chunks > 0)
+        {
+          file.seekg((std::streamoff)chunk_positions.back() + 4);
+          const std::size_t last_chunk_samples = details::readPOD<boost::uint32_t>(file);
+          if(last_chunk_samples == 0)
+            throw std::invalid_argument("The trajectory log is corrupted.");
+          num_samples = chunk_first_samples.back() + last_chunk_samples;
+        }
+        chunk_first_samples.push_back(num_samples);
+      }
+
+      /// \brief Scan the headers of the chunks of a log which has not been closed, ignoring a truncated last chunk.
+      ///        The samples themselves are not read: they may be compressed.
+      void rebuildIndex()
+      {
+        const boost::uint64_t chunk_header_size = TrajectoryLogFormat::chunkHeaderSize<Scalar>();
+        boost::uint64_t position = TrajectoryLogFormat::HEADER_SIZE;
+        std::size_t num_samples = 0;
+        while(position + chunk_header_size <= file_size)
+        {
+          file.seekg((std::streamoff)position + 4);
+          const std::size_t chunk_samples = details::readPOD<boost::uint32_t>(file);
+          const boost::uint64_t num_bytes = details::readPOD<boost::uint64_t>(file);
+          const Scalar first_time = details::readPOD<Scalar>(file);
+          if(chunk_samples == 0 || position + chunk_header_size + num_bytes > file_size)
+            break;
+
+          chunk_positions.push_back(position);
+          chunk_first_samples.push_back(num_samples);
+          chunk_first_times.push_back(first_time);
+          num_samples += chunk_samples;
+          position += chunk_header_size + num_bytes;
+        }
+        chunk_first_samples.push_back(num_samples);
+      }
+
+      std::ifstream file;
+      boost::uint64_t file_size;
+      details::TrajectoryLogLayout layout;
+
+      /// \brief Index of the chunks. chunk_first_samples has an additional element, the number of samples of the log.
+      std::vector<boost::uint64_t> chunk_positions;
+      std::vector<std::size_t> chunk_first_samples;
+      std::vector<Scalar> chunk_first_times;
+
+      /// \brief Samples of the chunk loaded in memory.
+      std::vector<Scalar> chunk;
+      std::size_t loaded_chunk;
+      /// \brief Bytes of the chunk loaded in memory, before decompression.
+      std::vector<char> compressed_chunk;
+
+    }; // class TrajectoryLogReaderTpl
+
+    typedef TrajectoryLogWriterTpl<double> TrajectoryLogWriter;
+    typedef TrajectoryLogReaderTpl<double> TrajectoryLogReader;
+
+  } // namespace serialization
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_serialization_trajectory_log_hpp__
@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_utils_hash_hpp__
+#define __pinocchio_utils_hash_hpp__
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <boost/cstdint.hpp>
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief 64-bit FNV-1a hash of a string.
+  ///        Contrary to std::hash or boost::hash, its value does not depend on the platform, the compiler or the run,
+  ///        and it can thus be used to name files stored on disk.
+  ///
+  /// \param[in] str The string to hash.
+  /// \param[in] seed Initial value of the hash. Passing the hash of a previous string chains the two strings.
+  ///
+  /// \returns the hash of the string.
+  ///
+  inline boost::uint64_t hashString(const std::string & str,
+                                    const boost::uint64_t seed = UINT64_C(14695981039346656037))
+  {
+    const boost::uint64_t prime = UINT64_C(1099511628211);
+    boost::uint64_t res = seed;
+    for(std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+    {
+      res ^= (boost::uint64_t)(unsigned char)(*it);
+      res *= prime;
+    }
+    return res;
+  }
+
+  ///
+  /// \returns the hash as a string of 16 hexadecimal digits.
+  ///
+  inline std::string hashToString(const boost::uint64_t hash)
+  {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return oss.str();
+  }
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_utils_hash_hpp__
@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_utils_memory_footprint_hpp__
+#define __pinocchio_utils_memory_footprint_hpp__
+
+#include "pinocchio/fwd.hpp"
+#include "pinocchio/container/aligned-vector.hpp"
+
+#include <vector>
+#include <map>
+#include <string>
+#include <ostream>
+#include <Eigen/Cholesky>
+
+///
+/// \brief Record in the MemoryFootprint report the memory dynamically allocated by the member field of obj.
+///
+#define PINOCCHIO_ADD_MEMORY_FOOTPRINT(report,obj,field) \
+  (report).add(#field,::pinocchio::dynamicMemoryFootprint((obj).field))
+
+namespace pinocchio
+{
+  namespace internal
+  {
+    ///
+    /// \brief Number of bytes dynamically allocated by an object of type T, not counting sizeof(T).
+    ///        By default, the object is assumed to have no dynamic memory.
+    ///
+    template<typename T>
+    struct DynamicMemoryFootprint
+    {
+      static std::size_t run(const T &) { return 0; }
+    };
+
+    template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+    struct DynamicMemoryFootprint< Eigen::Matrix<Scalar,Rows,Cols,Options,MaxRows,MaxCols> >
+    {
+      typedef Eigen::Matrix<Scalar,Rows,Cols,Options,MaxRows,MaxCols> MatrixType;
+
+      static std::size_t run(const MatrixType & mat)
+      {
+        if(MatrixType::MaxSizeAtCompileTime != Eigen::Dynamic)
+          return 0;
+        return (std::size_t)mat.size() * sizeof(Scalar);
+      }
+    };
+
+    template<typename MatrixType, int UpLo>
+    struct DynamicMemoryFootprint< Eigen::LLT<MatrixType,UpLo> >
+    {
+      static std::size_t run(const Eigen::LLT<MatrixType,UpLo> & llt)
+      {
+        // matrixLLT() cannot be accessed before the first decomposition
+        if(MatrixType::MaxSizeAtCompileTime != Eigen::Dynamic)
+          return 0;
+        return (std::size_t)(llt.rows() * llt.cols()) * sizeof(typename MatrixType::Scalar);
+      }
+    };
+
+    template<typename T, class Allocator>
+    struct DynamicMemoryFootprint< std::vector<T,Allocator> >
+    {
+      static std::size_t run(const std::vector<T,Allocator> & vec)
+      {
+        std::size_t res = vec.capacity() * sizeof(T);
+        for(typename std::vector<T,Allocator>::const_iterator it = vec.begin();
+            it != vec.end(); ++it)
+          res += DynamicMemoryFootprint<T>::run(*it);
+        return res;
+      }
+    };
+
+    template<class Allocator>
+    struct DynamicMemoryFootprint< std::vector<bool,Allocator> >
+    {
+      static std::size_t run(const std::vector<bool,Allocator> & vec)
+      {
+        // std::vector<bool> is stored as a bitset
+        return (vec.capacity() + 7) / 8;
+      }
+    };
+
+    template<typename Key, typename T, class Compare, class Allocator>
+    struct DynamicMemoryFootprint< std::map<Key,T,Compare,Allocator> >
+    {
+      typedef std::map<Key,T,Compare,Allocator> MapType;
+
+      static std::size_t run(const MapType & map)
+      {
+        // Each node of the underlying red-black tree stores the value, three pointers and a color.
+        const std::size_t node_size = sizeof(typename MapType::value_type) + 4 * sizeof(void*);
+        std::size_t res = map.size() * node_size;
+        for(typename MapType::const_iterator it = map.begin(); it != map.end(); ++it)
+          res += DynamicMemoryFootprint<Key>::run(it->first) + DynamicMemoryFootprint<T>::run(it->second);
+        return res;
+      }
+    };
+
+    template<typename T>
+    struct DynamicMemoryFootprint< std::vector<T,container::aligned_allocator<T> > >
+    {
+      typedef std::vector<T,container::aligned_allocator<T> > VectorType;
+
+      static std::size_t run(const VectorType & vec)
+      {
+        // The storage taken from an arena is accounted for by the owner of the arena.
+        const container::Arena * arena = vec.get_allocator().arena();
+        const bool in_arena = arena != NULL && !vec.empty() && arena->owns(&vec[0]);
+        std::size_t res = in_arena ? 0 : vec.capacity() * sizeof(T);
+        for(typename VectorType::const_iterator it = vec.begin(); it != vec.end(); ++it)
+          res += DynamicMemoryFootprint<T>::run(*it);
+        return res;
+      }
+    };
+
+    template<typename T>
+    struct DynamicMemoryFootprint< container::aligned_vector<T> >
+    : DynamicMemoryFootprint< typename container::aligned_vector<T>::vector_base >
+    {};
+
+    template<>
+    struct DynamicMemoryFootprint<std::string>
+    {
+      // The small string optimization is not taken into account.
+      static std::size_t run(const std::string & str) { return str.capacity(); }
+    };
+  } // namespace internal
+
+  ///
+  /// \returns the number of bytes dynamically allocated by obj, not counting sizeof(obj).
+  ///
+  template<typename T>
+  inline std::size_t dynamicMemoryFootprint(const T & obj)
+  {
+    return internal::DynamicMemoryFootprint<T>::run(obj);
+  }
+
+  ///
+  /// \brief Memory footprint of a structure, detailed field by field.
+  ///        The total footprint is the size of the structure itself plus the memory dynamically allocated by each of its fields.
+  ///
+  struct MemoryFootprint
+  {
+    typedef std::pair<std::string,std::size_t> Field;
+    typedef std::vector<Field> FieldVector;
+
+    ///
+    /// \brief Constructor.
+    ///
+    /// \param[in] base_size The size of the structure itself, i.e. sizeof(structure).
+    ///
+    explicit MemoryFootprint(const std::size_t base_size = 0)
+    : base(base_size)
+    {}
+
+    ///
+    /// \brief Record the memory dynamically allocated by a field.
+    ///
+    /// \param[in] name Name of the field.
+    /// \param[in] bytes Number of bytes dynamically allocated by the field.
+    ///
+    void add(const std::string & name, const std::size_t bytes)
+    {
+      fields.push_back(Field(name,bytes));
+    }
+
+    /// \returns the number of bytes dynamically allocated by the field name, or 0 if there is no such field.
+    std::size_t field(const std::string & name) const
+    {
+      for(FieldVector::const_iterator it = fields.begin(); it != fields.end(); ++it)
+        if(it->first == name) return it->second;
+      return 0;
+    }
+
+    /// \returns the total number of bytes: the size of the structure plus the dynamic memory of all its fields.
+    std::size_t total() const
+    {
+      std::size_t res = base;
+      for(FieldVector::const_iterator it = fields.begin(); it != fields.end(); ++it)
+        res += it->second;
+      return res;
+    }
+
+    /// \brief Size of the structure itself.
+    std::size_t base;
+
+    /// \brief Dynamic memory of each field, in declaration order.
+    FieldVector fields;
+
+  }; // struct MemoryFootprint
+
+  inline std::ostream & operator<<(std::ostream & os, const MemoryFootprint & footprint)
+  {
+    os << "total: " << footprint.total() << " bytes (base: " << footprint.base << " bytes)" << std::endl;
+    for(MemoryFootprint::FieldVector::const_iterator it = footprint.fields.begin();
+        it != footprint.fields.end(); ++it)
+      os << "  " << it->first << ": " << it->second << " bytes" << std::endl;
+    return os;
+  }
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_utils_memory_footprint_hpp__
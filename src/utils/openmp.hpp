@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#ifndef __pinocchio_utils_openmp_hpp__
+#define __pinocchio_utils_openmp_hpp__
+
+#include <cstdlib>
+#include <boost/exception_ptr.hpp>
+
+namespace pinocchio
+{
+
+  ///
+  /// \brief Returns the number of threads defined by the environment variable OMP_NUM_THREADS.
+  ///        If this variable is not defined, this simply returns the default value 1.
+  ///
+  /// \note This helper does not require the OpenMP runtime, which allows the pool structures to be used without OpenMP support.
+  ///
+  inline int getOpenMPNumThreadsEnv()
+  {
+    int num_threads = 1;
+    
+    if(const char * env_p = std::getenv("OMP_NUM_THREADS"))
+      num_threads = atoi(env_p);
+    
+    return num_threads > 0 ? num_threads : 1;
+  }
+
+  ///
+  /// \brief Keeps the first exception raised inside an OpenMP parallel region, in order to rethrow it once the region is over.
+  ///        An exception must not escape a parallel region: it would call std::terminate.
+  ///
+  /// \code
+  /// OpenMPException exception;
+  /// #pragma omp parallel for
+  /// for(i = 0; i < n; ++i)
+  /// {
+  ///   try { ... }
+  ///   catch(...) { exception.capture(); }
+  /// }
+  /// exception.rethrow();
+  /// \endcode
+  ///
+  struct OpenMPException
+  {
+    /// \brief Store the exception currently handled, unless another one has already been stored. Must be called within a catch block.
+    void capture()
+    {
+#ifdef _OPENMP
+#pragma omp critical (pinocchio_openmp_exception)
+#endif
+      {
+        if(!m_exception)
+          m_exception = boost::current_exception();
+      }
+    }
+
+    /// \brief Rethrow the stored exception, if any.
+    void rethrow() const
+    {
+      if(m_exception)
+        boost::rethrow_exception(m_exception);
+    }
+
+  protected:
+
+    boost::exception_ptr m_exception;
+
+  }; // struct OpenMPException
+
+} // namespace pinocchio
+
+#endif // ifndef __pinocchio_utils_openmp_hpp__
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/algorithm/branch-sparse-jacobian.hpp"
+#include "pinocchio/algorithm/jacobian.hpp"
+#include "pinocchio/algorithm/crba.hpp"
+#include "pinocchio/algorithm/cholesky.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
+
+BOOST_AUTO_TEST_CASE(test_branch_sparse_jacobian)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+
+  Model model; buildModels::humanoidRandom(model);
+  Data data(model);
+
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+
+  const VectorXd q = randomConfiguration(model);
+  computeJointJacobians(model,data,q);
+
+  const JointIndex rf_id = model.getJointId("rleg6_joint");
+  const JointIndex lf_id = model.getJointId("lleg6_joint");
+  const JointIndex rh_id = model.getJointId("rarm6_joint");
+
+  Data::Matrix6x J_rf(Data::Matrix6x::Zero(6,model.nv)), J_lf(Data::Matrix6x::Zero(6,model.nv)), J_rh(Data::Matrix6x::Zero(6,model.nv));
+  getJointJacobian(model,data,rf_id,LOCAL,J_rf);
+  getJointJacobian(model,data,lf_id,LOCAL,J_lf);
+  getJointJacobian(model,data,rh_id,LOCAL,J_rh);
+
+  BranchSparseJacobian J(model.nv);
+  BOOST_CHECK(J.addBlock(model,rf_id,J_rf) == 0);
+  BOOST_CHECK(J.addBlock(model,lf_id,J_lf) == 1);
+  BOOST_CHECK(J.addBlock(model,rh_id,J_rh.topRows<3>()) == 2);
+  BOOST_CHECK(J.size() == 3);
+  BOOST_CHECK(J.rows() == 15);
+  BOOST_CHECK(J.cols() == model.nv);
+  BOOST_CHECK(J.joint(1) == lf_id);
+  BOOST_CHECK(J.rowOffset(2) == 12);
+  BOOST_CHECK(J.support(0) == data.supports_fromRow[(size_t)(idx_v(model.joints[rf_id])+nv(model.joints[rf_id])-1)]);
+
+  MatrixXd J_ref(15,model.nv);
+  J_ref << J_rf, J_lf, J_rh.topRows<3>();
+
+  MatrixXd J_dense(15,model.nv);
+  J.toDense(J_dense);
+  BOOST_CHECK(J_dense.isApprox(J_ref));
+
+  // Products
+  const VectorXd x(VectorXd::Random(model.nv));
+  VectorXd Jx(15);
+  jacobianProduct(J,x,Jx);
+  BOOST_CHECK(Jx.isApprox(J_ref*x));
+
+  const VectorXd f(VectorXd::Random(15));
+  VectorXd Jtf(model.nv);
+  jacobianTransposeProduct(J,f,Jtf);
+  BOOST_CHECK(Jtf.isApprox(J_ref.transpose()*f));
+
+  // J * Minv * Jt
+  crba(model,data,q);
+  data.M.triangularView<Eigen::StrictlyLower>() = data.M.transpose().triangularView<Eigen::StrictlyLower>();
+  cholesky::decompose(model,data);
+
+  MatrixXd JMinvJt(15,15);
+  computeJMinvJt(model,data,J,JMinvJt);
+  const MatrixXd JMinvJt_ref = J_ref * data.M.inverse() * J_ref.transpose();
+  BOOST_CHECK(JMinvJt.isApprox(JMinvJt_ref));
+
+  // Wrong arguments
+  VectorXd x_wrong(model.nv-1);
+  BOOST_CHECK_THROW(jacobianProduct(J,x_wrong,Jx),std::invalid_argument);
+  MatrixXd J_wrong(6,model.nv-1);
+  BOOST_CHECK_THROW(J.addBlock(model,rf_id,J_wrong),std::invalid_argument);
+
+  J.clear();
+  BOOST_CHECK(J.size() == 0);
+  BOOST_CHECK(J.rows() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -3,6 +3,7 @@
 //
 
 #include "pinocchio/autodiff/casadi.hpp"
+#include "pinocchio/autodiff/casadi/function-cache.hpp"
 
 #include "pinocchio/algorithm/kinematics.hpp"
 #include "pinocchio/algorithm/frames.hpp"
@@ -14,8 +15,27 @@
 
 #include "pinocchio/parsers/sample-models.hpp"
 
+#include <fstream>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/utility/binary.hpp>
+#include <boost/filesystem.hpp>
+
+// Unique directory in the temporary directory of the system, removed with its content at the end of the scope.
+struct TemporaryDirectory
+{
+  TemporaryDirectory()
+  : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pinocchio-casadi-%%%%-%%%%-%%%%")).string())
+  { boost::filesystem::create_directories(path); }
+  
+  ~TemporaryDirectory()
+  {
+    boost::system::error_code error;
+    boost::filesystem::remove_all(path,error);
+  }
+  
+  const std::string path;
+};
 
 BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
 
@@ -420,4 +440,71 @@ BOOST_AUTO_TEST_CASE(test_crba)
     BOOST_CHECK(ddq_mat.isApprox(data.ddq));
   }
 
+BOOST_AUTO_TEST_CASE(test_function_cache)
+{
+  typedef pinocchio::ModelTpl<double> Model;
+  typedef Model::Data Data;
+  
+  Model model;
+  pinocchio::buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  Data data(model);
+  
+  const Eigen::VectorXd q = pinocchio::randomConfiguration(model);
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+  const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+  
+  std::vector<double> q_vec((size_t)model.nq), v_vec((size_t)model.nv), a_vec((size_t)model.nv);
+  Eigen::Map<Eigen::VectorXd>(q_vec.data(),model.nq) = q;
+  Eigen::Map<Eigen::VectorXd>(v_vec.data(),model.nv) = v;
+  Eigen::Map<Eigen::VectorXd>(a_vec.data(),model.nv) = a;
+  
+  const TemporaryDirectory cache_directory;
+  {
+    pinocchio::casadi::FunctionCache cache(model,cache_directory.path);
+    BOOST_CHECK(!cache.exists("rnea"));
+    BOOST_CHECK_THROW(cache.get("unknown"),std::invalid_argument);
+    
+    const casadi::Function & rnea_fun = cache.get("rnea");
+    BOOST_CHECK(cache.exists("rnea"));
+    
+    std::vector<double> tau_vec(static_cast< std::vector<double> >(rnea_fun(casadi::DMVector {q_vec,v_vec,a_vec})[0]));
+    BOOST_CHECK(Eigen::Map<Eigen::VectorXd>(tau_vec.data(),model.nv).isApprox(pinocchio::rnea(model,data,q,v,a)));
+  }
+  
+  // Another cache loads the saved function
+  pinocchio::casadi::FunctionCache cache(model,cache_directory.path);
+  BOOST_CHECK(cache.exists("rnea"));
+  const casadi::Function & rnea_fun = cache.get("rnea");
+  std::vector<double> tau_vec(static_cast< std::vector<double> >(rnea_fun(casadi::DMVector {q_vec,v_vec,a_vec})[0]));
+  BOOST_CHECK(Eigen::Map<Eigen::VectorXd>(tau_vec.data(),model.nv).isApprox(data.tau));
+  
+  const casadi::Function & aba_fun = cache.get("aba");
+  std::vector<double> ddq_vec(static_cast< std::vector<double> >(aba_fun(casadi::DMVector {q_vec,v_vec,tau_vec})[0]));
+  BOOST_CHECK(Eigen::Map<Eigen::VectorXd>(ddq_vec.data(),model.nv).isApprox(a));
+  
+  // A different model does not share the saved functions
+  Model other_model(model);
+  other_model.inertias[1] = pinocchio::Inertia::Random();
+  pinocchio::casadi::FunctionCache other_cache(other_model,cache_directory.path);
+  BOOST_CHECK(!other_cache.exists("rnea"));
+  BOOST_CHECK(other_cache.path("rnea") != cache.path("rnea"));
+  
+  // A new version of a builder does not share the functions saved by the previous one
+  pinocchio::casadi::FunctionCache versioned_cache(model,cache_directory.path);
+  versioned_cache.addBuilder("rnea",&pinocchio::casadi::buildRNEAFunction,"2");
+  BOOST_CHECK(versioned_cache.path("rnea") != cache.path("rnea"));
+  BOOST_CHECK(!versioned_cache.exists("rnea"));
+  
+  // A corrupted function is built again
+  {
+    std::ofstream file(versioned_cache.path("rnea").c_str());
+    file << "not a function" << std::endl;
+  }
+  const casadi::Function & rnea_fun_rebuilt = versioned_cache.get("rnea");
+  tau_vec = static_cast< std::vector<double> >(rnea_fun_rebuilt(casadi::DMVector {q_vec,v_vec,a_vec})[0]);
+  BOOST_CHECK(Eigen::Map<Eigen::VectorXd>(tau_vec.data(),model.nv).isApprox(data.tau));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -275,5 +275,108 @@ BOOST_AUTO_TEST_CASE ( test_timings )
     cholesky::computeMinv(model,data_bis);
     BOOST_CHECK(data_bis.Minv.isApprox(Minv_ref));
   }
+  
+  BOOST_AUTO_TEST_CASE(test_cholesky_multiple_rhs)
+  {
+    using namespace Eigen;
+    using namespace pinocchio;
+    
+    pinocchio::Model model;
+    pinocchio::buildModels::humanoidRandom(model,true);
+    pinocchio::Data data(model);
+    
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    VectorXd q = randomConfiguration(model);
+    crba(model,data,q);
+    cholesky::decompose(model,data);
+    data.M.triangularView<Eigen::StrictlyLower>() =
+    data.M.triangularView<Eigen::StrictlyUpper>().transpose();
+    
+    const MatrixXd & U = data.U;
+    const MatrixXd & M = data.M;
+    const MatrixXd rhs = MatrixXd::Random(model.nv,12);
+    
+    MatrixXd res = rhs; cholesky::Uv(model,data,res);
+    BOOST_CHECK(res.isApprox(U*rhs, 1e-12));
+    res = rhs; cholesky::Utv(model,data,res);
+    BOOST_CHECK(res.isApprox(U.transpose()*rhs, 1e-12));
+    res = rhs; cholesky::Uiv(model,data,res);
+    BOOST_CHECK(res.isApprox(U.inverse()*rhs, 1e-12));
+    res = rhs; cholesky::Utiv(model,data,res);
+    BOOST_CHECK(res.isApprox(U.transpose().inverse()*rhs, 1e-12));
+    res = rhs; cholesky::UDUtv(model,data,res);
+    BOOST_CHECK(res.isApprox(M*rhs, 1e-12));
+    res = rhs; cholesky::solve(model,data,res);
+    BOOST_CHECK(res.isApprox(M.inverse()*rhs, 1e-12));
+    
+    // Row major storage and blocks of a larger matrix
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMatrixXd;
+    RowMatrixXd res_row = rhs; cholesky::solve(model,data,res_row);
+    BOOST_CHECK(res_row.isApprox(M.inverse()*rhs, 1e-12));
+    
+    MatrixXd res_large(MatrixXd::Zero(model.nv+2,20));
+    res_large.block(1,3,model.nv,12) = rhs;
+    cholesky::solve(model,data,res_large.block(1,3,model.nv,12));
+    BOOST_CHECK(res_large.block(1,3,model.nv,12).isApprox(M.inverse()*rhs, 1e-12));
+    BOOST_CHECK(res_large.topRows<1>().isZero() && res_large.bottomRows<1>().isZero());
+    
+    // Compare to the solve column by column
+    for(Eigen::DenseIndex k = 0; k < rhs.cols(); ++k)
+    {
+      VectorXd col = rhs.col(k); cholesky::solve(model,data,col);
+      BOOST_CHECK(res.col(k).isApprox(col, 1e-12));
+    }
+  }
+  
+  BOOST_AUTO_TEST_CASE(test_cholesky_update_body_inertia)
+  {
+    using namespace Eigen;
+    using namespace pinocchio;
+    
+    pinocchio::Model model;
+    pinocchio::buildModels::humanoidRandom(model,true);
+    pinocchio::Data data(model);
+    
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    VectorXd q = randomConfiguration(model);
+    
+    const char * joint_names[3] = { "rarm6_joint", "chest_joint", "root_joint" };
+    for(int k = 0; k < 3; ++k)
+    {
+      const JointIndex joint_id = model.getJointId(joint_names[k]);
+      BOOST_CHECK(joint_id < (JointIndex)model.njoints);
+      
+      crba(model,data,q);
+      cholesky::decompose(model,data);
+      
+      // Add a payload
+      Model model_payload(model);
+      model_payload.inertias[joint_id] += Inertia::Random();
+      Data data_payload(model_payload);
+      crba(model_payload,data_payload,q);
+      cholesky::decompose(model_payload,data_payload);
+      
+      cholesky::updateBodyInertia(model,data,joint_id,model.inertias[joint_id],model_payload.inertias[joint_id]);
+      
+      BOOST_CHECK(data.M.triangularView<Eigen::Upper>().toDenseMatrix()
+                  .isApprox(data_payload.M.triangularView<Eigen::Upper>().toDenseMatrix()));
+      BOOST_CHECK(data.U.isApprox(data_payload.U));
+      BOOST_CHECK(data.D.isApprox(data_payload.D));
+      BOOST_CHECK(data.Dinv.isApprox(data_payload.Dinv));
+      
+      // Remove it
+      cholesky::updateBodyInertia(model,data,joint_id,model_payload.inertias[joint_id],model.inertias[joint_id]);
+      
+      Data data_ref(model);
+      crba(model,data_ref,q);
+      cholesky::decompose(model,data_ref);
+      BOOST_CHECK(data.M.triangularView<Eigen::Upper>().toDenseMatrix()
+                  .isApprox(data_ref.M.triangularView<Eigen::Upper>().toDenseMatrix()));
+      BOOST_CHECK(data.U.isApprox(data_ref.U));
+      BOOST_CHECK(data.D.isApprox(data_ref.D));
+    }
+  }
 
 BOOST_AUTO_TEST_SUITE_END ()
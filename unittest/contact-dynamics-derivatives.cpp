@@ -7,6 +7,7 @@
 #include "pinocchio/algorithm/rnea-derivatives.hpp"
 #include "pinocchio/algorithm/kinematics-derivatives.hpp"
 #include "pinocchio/algorithm/contact-dynamics.hpp"
+#include "pinocchio/algorithm/contact-dynamics-derivatives.hpp"
 #include "pinocchio/algorithm/joint-configuration.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
 
@@ -324,5 +325,184 @@ BOOST_AUTO_TEST_CASE ( test_FD_with_contact_varying_gamma )
   
 }
 
+/// \brief Stack the LOCAL Jacobians of the contact joints and the corresponding drifts.
+static void contactJacobianAndDrift(const Model & model, Data & data,
+                                    const VectorXd & q, const VectorXd & v,
+                                    const Model::IndexVector & contact_ids,
+                                    MatrixXd & J, VectorXd & gamma)
+{
+  J.setZero();
+  computeJointJacobians(model,data,q);
+  forwardKinematics(model,data,q,v,VectorXd::Zero(model.nv));
+  for(size_t k = 0; k < contact_ids.size(); ++k)
+  {
+    getJointJacobian(model,data,contact_ids[k],LOCAL,J.middleRows<6>(6*(Eigen::DenseIndex)k));
+    gamma.segment<6>(6*(Eigen::DenseIndex)k) = data.a[contact_ids[k]].toVector();
+  }
+}
+
+static void contactDynamics(const Model & model, Data & data,
+                            const VectorXd & q, const VectorXd & v, const VectorXd & tau,
+                            const Model::IndexVector & contact_ids)
+{
+  const Eigen::DenseIndex nc = 6*(Eigen::DenseIndex)contact_ids.size();
+  MatrixXd J(nc,model.nv); VectorXd gamma(nc);
+  contactJacobianAndDrift(model,data,q,v,contact_ids,J,gamma);
+  forwardDynamics(model,data,q,v,tau,J,gamma);
+}
+
+static void impulseDynamics(const Model & model, Data & data,
+                            const VectorXd & q, const VectorXd & v_before, const double r_coeff,
+                            const Model::IndexVector & contact_ids)
+{
+  const Eigen::DenseIndex nc = 6*(Eigen::DenseIndex)contact_ids.size();
+  MatrixXd J(nc,model.nv); VectorXd gamma(nc);
+  contactJacobianAndDrift(model,data,q,v_before,contact_ids,J,gamma);
+  impulseDynamics(model,data,q,v_before,J,r_coeff);
+}
+
+BOOST_AUTO_TEST_CASE ( test_contact_dynamics_derivatives )
+{
+  pinocchio::Model model;
+  pinocchio::buildModels::humanoidRandom(model,true);
+  pinocchio::Data data(model), data_fd(model);
+
+  VectorXd q = randomConfiguration(model,-VectorXd::Ones(model.nq),VectorXd::Ones(model.nq));
+  VectorXd v = VectorXd::Random(model.nv);
+  VectorXd tau = VectorXd::Random(model.nv);
+
+  Model::IndexVector contact_ids;
+  contact_ids.push_back(model.getJointId("rleg6_joint"));
+  contact_ids.push_back(model.getJointId("lleg6_joint"));
+  const Eigen::DenseIndex nc = 12;
+
+  contactDynamics(model,data,q,v,tau,contact_ids);
+  const VectorXd ddq_ref = data.ddq, lambda_ref = data.lambda_c;
+
+  MatrixXd ddq_partial_dq(model.nv,model.nv), ddq_partial_dv(model.nv,model.nv), ddq_partial_dtau(model.nv,model.nv);
+  MatrixXd lambda_partial_dq(nc,model.nv), lambda_partial_dv(nc,model.nv), lambda_partial_dtau(nc,model.nv);
+  computeContactDynamicsDerivatives(model,data,q,v,contact_ids,
+                                    ddq_partial_dq,ddq_partial_dv,ddq_partial_dtau,
+                                    lambda_partial_dq,lambda_partial_dv,lambda_partial_dtau);
+
+  MatrixXd ddq_partial_dq_fd(model.nv,model.nv), ddq_partial_dv_fd(model.nv,model.nv), ddq_partial_dtau_fd(model.nv,model.nv);
+  MatrixXd lambda_partial_dq_fd(nc,model.nv), lambda_partial_dv_fd(nc,model.nv), lambda_partial_dtau_fd(nc,model.nv);
+
+  const double eps = 1e-8;
+  VectorXd v_eps(VectorXd::Zero(model.nv));
+  for(Eigen::DenseIndex k = 0; k < model.nv; ++k)
+  {
+    v_eps[k] = eps;
+    contactDynamics(model,data_fd,integrate(model,q,v_eps),v,tau,contact_ids);
+    ddq_partial_dq_fd.col(k) = (data_fd.ddq - ddq_ref)/eps;
+    lambda_partial_dq_fd.col(k) = (data_fd.lambda_c - lambda_ref)/eps;
+
+    contactDynamics(model,data_fd,q,v + v_eps,tau,contact_ids);
+    ddq_partial_dv_fd.col(k) = (data_fd.ddq - ddq_ref)/eps;
+    lambda_partial_dv_fd.col(k) = (data_fd.lambda_c - lambda_ref)/eps;
+
+    contactDynamics(model,data_fd,q,v,tau + v_eps,contact_ids);
+    ddq_partial_dtau_fd.col(k) = (data_fd.ddq - ddq_ref)/eps;
+    lambda_partial_dtau_fd.col(k) = (data_fd.lambda_c - lambda_ref)/eps;
+    v_eps[k] = 0.;
+  }
+
+  BOOST_CHECK(ddq_partial_dq.isApprox(ddq_partial_dq_fd,sqrt(eps)));
+  BOOST_CHECK(ddq_partial_dv.isApprox(ddq_partial_dv_fd,sqrt(eps)));
+  BOOST_CHECK(ddq_partial_dtau.isApprox(ddq_partial_dtau_fd,sqrt(eps)));
+  BOOST_CHECK(lambda_partial_dq.isApprox(lambda_partial_dq_fd,sqrt(eps)));
+  BOOST_CHECK(lambda_partial_dv.isApprox(lambda_partial_dv_fd,sqrt(eps)));
+  BOOST_CHECK(lambda_partial_dtau.isApprox(lambda_partial_dtau_fd,sqrt(eps)));
+}
+
+BOOST_AUTO_TEST_CASE ( test_impulse_dynamics_derivatives )
+{
+  pinocchio::Model model;
+  pinocchio::buildModels::humanoidRandom(model,true);
+  pinocchio::Data data(model), data_fd(model);
+
+  VectorXd q = randomConfiguration(model,-VectorXd::Ones(model.nq),VectorXd::Ones(model.nq));
+  VectorXd v_before = VectorXd::Random(model.nv);
+  const double r_coeff = 0.5;
+
+  Model::IndexVector contact_ids;
+  contact_ids.push_back(model.getJointId("rleg6_joint"));
+  contact_ids.push_back(model.getJointId("lleg6_joint"));
+  const Eigen::DenseIndex nc = 12;
+
+  impulseDynamics(model,data,q,v_before,r_coeff,contact_ids);
+  const VectorXd dq_after_ref = data.dq_after, impulse_ref = data.impulse_c;
+
+  MatrixXd dq_after_partial_dq(model.nv,model.nv), dq_after_partial_dv(model.nv,model.nv);
+  MatrixXd impulse_partial_dq(nc,model.nv), impulse_partial_dv(nc,model.nv);
+  computeImpulseDynamicsDerivatives(model,data,q,v_before,contact_ids,r_coeff,
+                                    dq_after_partial_dq,dq_after_partial_dv,
+                                    impulse_partial_dq,impulse_partial_dv);
+
+  MatrixXd dq_after_partial_dq_fd(model.nv,model.nv), dq_after_partial_dv_fd(model.nv,model.nv);
+  MatrixXd impulse_partial_dq_fd(nc,model.nv), impulse_partial_dv_fd(nc,model.nv);
+
+  const double eps = 1e-8;
+  VectorXd v_eps(VectorXd::Zero(model.nv));
+  for(Eigen::DenseIndex k = 0; k < model.nv; ++k)
+  {
+    v_eps[k] = eps;
+    impulseDynamics(model,data_fd,integrate(model,q,v_eps),v_before,r_coeff,contact_ids);
+    dq_after_partial_dq_fd.col(k) = (data_fd.dq_after - dq_after_ref)/eps;
+    impulse_partial_dq_fd.col(k) = (data_fd.impulse_c - impulse_ref)/eps;
+
+    impulseDynamics(model,data_fd,q,v_before + v_eps,r_coeff,contact_ids);
+    dq_after_partial_dv_fd.col(k) = (data_fd.dq_after - dq_after_ref)/eps;
+    impulse_partial_dv_fd.col(k) = (data_fd.impulse_c - impulse_ref)/eps;
+    v_eps[k] = 0.;
+  }
+
+  BOOST_CHECK(dq_after_partial_dq.isApprox(dq_after_partial_dq_fd,sqrt(eps)));
+  BOOST_CHECK(dq_after_partial_dv.isApprox(dq_after_partial_dv_fd,sqrt(eps)));
+  BOOST_CHECK(impulse_partial_dq.isApprox(impulse_partial_dq_fd,sqrt(eps)));
+  BOOST_CHECK(impulse_partial_dv.isApprox(impulse_partial_dv_fd,sqrt(eps)));
+}
+
+BOOST_AUTO_TEST_CASE ( test_contact_dynamics_derivatives_stale_factorization )
+{
+  pinocchio::Model model;
+  pinocchio::buildModels::humanoidRandom(model,true);
+  pinocchio::Data data(model);
+
+  const VectorXd q = randomConfiguration(model,-VectorXd::Ones(model.nq),VectorXd::Ones(model.nq));
+  const VectorXd q_other = randomConfiguration(model,-VectorXd::Ones(model.nq),VectorXd::Ones(model.nq));
+  const VectorXd v = VectorXd::Random(model.nv);
+  const VectorXd tau = VectorXd::Random(model.nv);
+
+  Model::IndexVector contact_ids, other_contact_ids;
+  contact_ids.push_back(model.getJointId("rleg6_joint"));
+  contact_ids.push_back(model.getJointId("lleg6_joint"));
+  other_contact_ids.push_back(model.getJointId("rarm6_joint"));
+  other_contact_ids.push_back(model.getJointId("larm6_joint"));
+  const Eigen::DenseIndex nc = 12;
+
+  MatrixXd ddq_partial_dq(model.nv,model.nv), ddq_partial_dv(model.nv,model.nv), ddq_partial_dtau(model.nv,model.nv);
+  MatrixXd lambda_partial_dq(nc,model.nv), lambda_partial_dv(nc,model.nv), lambda_partial_dtau(nc,model.nv);
+
+  // The factorizations have been computed for another configuration.
+  contactDynamics(model,data,q_other,v,tau,contact_ids);
+  BOOST_CHECK_THROW(computeContactDynamicsDerivatives(model,data,q,v,contact_ids,
+                                                      ddq_partial_dq,ddq_partial_dv,ddq_partial_dtau,
+                                                      lambda_partial_dq,lambda_partial_dv,lambda_partial_dtau),
+                    std::invalid_argument);
+
+  // The factorizations have been computed for other contacts.
+  contactDynamics(model,data,q,v,tau,other_contact_ids);
+  BOOST_CHECK_THROW(computeContactDynamicsDerivatives(model,data,q,v,contact_ids,
+                                                      ddq_partial_dq,ddq_partial_dv,ddq_partial_dtau,
+                                                      lambda_partial_dq,lambda_partial_dv,lambda_partial_dtau),
+                    std::invalid_argument);
+
+  contactDynamics(model,data,q,v,tau,contact_ids);
+  BOOST_CHECK_NO_THROW(computeContactDynamicsDerivatives(model,data,q,v,contact_ids,
+                                                         ddq_partial_dq,ddq_partial_dv,ddq_partial_dtau,
+                                                         lambda_partial_dq,lambda_partial_dv,lambda_partial_dtau));
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
 
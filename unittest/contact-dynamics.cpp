@@ -7,6 +7,7 @@
 #include "pinocchio/multibody/data.hpp"
 #include "pinocchio/algorithm/jacobian.hpp"
 #include "pinocchio/algorithm/contact-dynamics.hpp"
+#include "pinocchio/algorithm/compute-all-terms.hpp"
 #include "pinocchio/algorithm/joint-configuration.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
 #include "pinocchio/utils/timer.hpp"
@@ -82,6 +83,119 @@ BOOST_AUTO_TEST_CASE ( test_FD )
 
 }
 
+BOOST_AUTO_TEST_CASE ( test_FD_branch_sparse )
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+  
+  pinocchio::Model model;
+  pinocchio::buildModels::humanoidRandom(model,true);
+  pinocchio::Data data(model), data_ref(model);
+  
+  VectorXd q = VectorXd::Ones(model.nq);
+  q.segment <4> (3).normalize();
+  
+  pinocchio::computeJointJacobians(model, data, q);
+  
+  VectorXd v = VectorXd::Ones(model.nv);
+  VectorXd tau = VectorXd::Random(model.nv);
+  
+  const char * contact_names[] = {"rleg6_joint","lleg6_joint","rarm6_joint","larm6_joint"};
+  
+  Eigen::MatrixXd J_ref (24, model.nv);
+  BranchSparseJacobian J(model.nv);
+  Data::Matrix6x J_contact (6, model.nv);
+  for(int k = 0; k < 4; ++k)
+  {
+    const JointIndex joint_id = model.getJointId(contact_names[k]);
+    J_contact.setZero();
+    getJointJacobian(model, data, joint_id, LOCAL, J_contact);
+    J_ref.middleRows<6>(6*k) = J_contact;
+    J.addBlock(model, joint_id, J_contact);
+  }
+  
+  Eigen::VectorXd gamma (VectorXd::Random(24));
+  
+  pinocchio::forwardDynamics(model, data_ref, q, v, tau, J_ref, gamma, 1e-12);
+  
+  computeAllTerms(model, data, q, v);
+  pinocchio::forwardDynamics(model, data, tau, J, gamma, 1e-12);
+  BOOST_CHECK(data.JMinvJt.isApprox(data_ref.JMinvJt));
+  BOOST_CHECK(data.sDUiJt.isApprox(data_ref.sDUiJt));
+  BOOST_CHECK(data.lambda_c.isApprox(data_ref.lambda_c));
+  BOOST_CHECK(data.ddq.isApprox(data_ref.ddq));
+  
+  MatrixXd KKTMatrix_inv(model.nv+24, model.nv+24), KKTMatrix_inv_ref(model.nv+24, model.nv+24);
+  getKKTContactDynamicMatrixInverse(model, data_ref, J_ref, KKTMatrix_inv_ref);
+  getKKTContactDynamicMatrixInverse(model, data, J_ref, KKTMatrix_inv);
+  BOOST_CHECK(KKTMatrix_inv.isApprox(KKTMatrix_inv_ref));
+  
+  // With the floating base, all the contacts are coupled.
+  BlockSparseLLT llt;
+  pinocchio::forwardDynamics(model, data, tau, J, gamma, llt, 1e-12);
+  BOOST_CHECK(llt.size() == 1);
+  BOOST_CHECK(data.lambda_c.isApprox(data_ref.lambda_c));
+  BOOST_CHECK(data.ddq.isApprox(data_ref.ddq));
+  
+  // data.llt_JMinvJt is not computed by the block-sparse factorization.
+  BOOST_CHECK_THROW(getKKTContactDynamicMatrixInverse(model, data, J_ref, KKTMatrix_inv), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE ( test_FD_block_sparse )
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+  
+  // Two independent arms attached to the universe.
+  pinocchio::Model model;
+  JointIndex tips[2];
+  for(int arm = 0; arm < 2; ++arm)
+  {
+    JointIndex parent = 0;
+    for(int k = 0; k < 4; ++k)
+    {
+      std::ostringstream name; name << "arm" << arm << "_joint" << k;
+      if(k%2)
+        parent = model.addJoint(parent, JointModelRY(), SE3::Random(), name.str());
+      else
+        parent = model.addJoint(parent, JointModelRX(), SE3::Random(), name.str());
+      model.appendBodyToJoint(parent, Inertia::Random(), SE3::Identity());
+    }
+    tips[arm] = parent;
+  }
+  pinocchio::Data data(model), data_ref(model);
+  
+  const VectorXd q = randomConfiguration(model, -VectorXd::Ones(model.nq), VectorXd::Ones(model.nq));
+  const VectorXd v = VectorXd::Random(model.nv);
+  const VectorXd tau = VectorXd::Random(model.nv);
+  
+  computeJointJacobians(model, data, q);
+  
+  Eigen::MatrixXd J_ref (6, model.nv);
+  BranchSparseJacobian J(model.nv);
+  Data::Matrix6x J_tip (6, model.nv);
+  for(int arm = 0; arm < 2; ++arm)
+  {
+    J_tip.setZero();
+    getJointJacobian(model, data, tips[arm], LOCAL, J_tip);
+    J_ref.middleRows<3>(3*arm) = J_tip.topRows<3>();
+    J.addBlock(model, tips[arm], J_tip.topRows<3>());
+  }
+  
+  const VectorXd gamma (VectorXd::Random(6));
+  pinocchio::forwardDynamics(model, data_ref, q, v, tau, J_ref, gamma, 0.);
+  
+  computeAllTerms(model, data, q, v);
+  BlockSparseLLT llt;
+  pinocchio::forwardDynamics(model, data, tau, J, gamma, llt, 0.);
+  
+  BOOST_CHECK(llt.size() == 2);
+  BOOST_CHECK(data.JMinvJt.topRightCorner(3,3).isZero());
+  BOOST_CHECK(data.JMinvJt.isApprox(data_ref.JMinvJt));
+  BOOST_CHECK(data.lambda_c.isApprox(data_ref.lambda_c));
+  BOOST_CHECK(data.ddq.isApprox(data_ref.ddq));
+}
+
 BOOST_AUTO_TEST_CASE(test_computeKKTMatrix)
 {
   using namespace Eigen;
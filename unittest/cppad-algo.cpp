@@ -3,6 +3,7 @@
 //
 
 #include "pinocchio/autodiff/cppad.hpp"
+#include "pinocchio/autodiff/cppad/tape.hpp"
 
 #include "pinocchio/multibody/model.hpp"
 #include "pinocchio/multibody/data.hpp"
@@ -285,4 +286,56 @@ BOOST_AUTO_TEST_CASE(test_kinematics_jacobian)
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_tape_with_model_parameters)
+{
+  typedef double Scalar;
+  typedef pinocchio::ModelTpl<Scalar> Model;
+  typedef Model::Data Data;
+  typedef pinocchio::CppADTapeTpl<Scalar> Tape;
+  
+  Model model;
+  pinocchio::buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  Data data(model);
+  
+  const Eigen::VectorXd q = pinocchio::randomConfiguration(model);
+  const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+  const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+  Eigen::VectorXd x(model.nq+2*model.nv);
+  x << q, v, a;
+  
+  Tape tape(model);
+  BOOST_CHECK(tape.getParameters().size() == Tape::numParameters(model));
+  tape.record(pinocchio::RNEATapeFunctor(),x);
+  
+  BOOST_CHECK(tape.evalFunction(x).isApprox(pinocchio::rnea(model,data,q,v,a)));
+  
+  // Change the inertias and the placements without recording the tape again
+  Model model_modified(model);
+  for(pinocchio::JointIndex i = 1; i < (pinocchio::JointIndex)model.njoints; ++i)
+  {
+    model_modified.inertias[i] = pinocchio::Inertia::Random();
+    model_modified.jointPlacements[i] = pinocchio::SE3::Random();
+  }
+  Data data_modified(model_modified);
+  tape.setModelParameters(model_modified);
+  
+  BOOST_CHECK(tape.evalFunction(x).isApprox(pinocchio::rnea(model_modified,data_modified,q,v,a)));
+  pinocchio::crba(model_modified,data_modified,q);
+  data_modified.M.triangularView<Eigen::StrictlyLower>()
+  = data_modified.M.transpose().triangularView<Eigen::StrictlyLower>();
+  BOOST_CHECK(tape.evalJacobian(x).rightCols(model.nv).isApprox(data_modified.M));
+  BOOST_CHECK(tape.getNumEvaluations() == 3);
+  
+  // The same for aba
+  Eigen::VectorXd y(model.nq+2*model.nv);
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(model.nv);
+  y << q, v, tau;
+  Tape aba_tape(model_modified);
+  aba_tape.record(pinocchio::ABATapeFunctor(),y);
+  aba_tape.setModelParameters(model);
+  BOOST_CHECK(aba_tape.evalFunction(y).isApprox(pinocchio::aba(model,data,q,v,tau)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 //
 
 #include "pinocchio/codegen/cppadcg.hpp"
+#include "pinocchio/codegen/code-generator-algo.hpp"
+#include "pinocchio/codegen/code-generator-library.hpp"
 
 #include "pinocchio/multibody/model.hpp"
 #include "pinocchio/multibody/data.hpp"
@@ -13,6 +15,9 @@
 #include "pinocchio/algorithm/rnea.hpp"
 #include "pinocchio/algorithm/aba.hpp"
 #include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/algorithm/frames.hpp"
+#include "pinocchio/algorithm/center-of-mass.hpp"
+#include "pinocchio/algorithm/centroidal.hpp"
 
 #include "pinocchio/parsers/sample-models.hpp"
 
@@ -20,6 +25,23 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/utility/binary.hpp>
+#include <boost/filesystem.hpp>
+
+// Unique directory in the temporary directory of the system, removed with its content at the end of the scope.
+struct TemporaryDirectory
+{
+  TemporaryDirectory()
+  : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pinocchio-cg-%%%%-%%%%-%%%%")).string())
+  { boost::filesystem::create_directories(path); }
+  
+  ~TemporaryDirectory()
+  {
+    boost::system::error_code error;
+    boost::filesystem::remove_all(path,error);
+  }
+  
+  const std::string path;
+};
 
 BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
 
@@ -110,4 +132,349 @@ BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
     BOOST_CHECK(M_map.isApprox(data.M));
   }
 
+  BOOST_AUTO_TEST_CASE(test_library_cache)
+  {
+    using namespace pinocchio;
+    
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    
+    CodeGenRNEA<double> rnea_code_gen(model), rnea_code_gen_same(model);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() == rnea_code_gen_same.getLibraryHash());
+    
+    // Same model name but different parameters
+    Model model_modified(model);
+    model_modified.inertias[1].mass() += 1.;
+    CodeGenRNEA<double> rnea_code_gen_modified(model_modified);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != rnea_code_gen_modified.getLibraryHash());
+    
+    // Different function
+    CodeGenABA<double> aba_code_gen(model);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != aba_code_gen.getLibraryHash());
+    
+    // Different generators with the same names and dimensions
+    CodeGenABA<double> aba_code_gen_renamed(model,"rnea","cg_rnea_eval");
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != aba_code_gen_renamed.getLibraryHash());
+    
+    // Different compile flags
+    std::vector<std::string> flags = rnea_code_gen_same.getCompileFlags();
+    flags[0] = "-O2";
+    rnea_code_gen_same.setCompileFlags(flags);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != rnea_code_gen_same.getLibraryHash());
+    
+    // Different split of the generated functions
+    CodeGenRNEA<double> rnea_code_gen_split(model);
+    rnea_code_gen_split.setMaxAssignmentsPerFunction(100);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != rnea_code_gen_split.getLibraryHash());
+    
+    // The library is compiled once, then reused from the cache
+    const TemporaryDirectory cache;
+    rnea_code_gen.setCacheDirectory(cache.path);
+    rnea_code_gen.initLib();
+    BOOST_CHECK(rnea_code_gen.getLibraryName().find(cache.path) == 0);
+    rnea_code_gen.loadLib();
+    BOOST_CHECK(rnea_code_gen.existLib());
+    
+    CodeGenRNEA<double> rnea_code_gen_cached(model);
+    rnea_code_gen_cached.setCacheDirectory(cache.path);
+    rnea_code_gen_cached.initLib();
+    BOOST_CHECK(rnea_code_gen_cached.existLib());
+    
+    rnea_code_gen_modified.setCacheDirectory(cache.path);
+    rnea_code_gen_modified.initLib();
+    BOOST_CHECK(!rnea_code_gen_modified.existLib());
+    
+    // A corrupted library found in the cache is compiled again
+    {
+      const std::string filename = rnea_code_gen_modified.getLibraryName() + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+      std::ofstream file(filename.c_str());
+      file << "not a library" << std::endl;
+    }
+    BOOST_CHECK(rnea_code_gen_modified.existLib());
+    rnea_code_gen_modified.loadLib();
+    
+    Data data_modified(model_modified);
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    rnea_code_gen_modified.evalFunction(q,v,a);
+    BOOST_CHECK(rnea_code_gen_modified.res.isApprox(rnea(model_modified,data_modified,q,v,a)));
+    
+    // Neither the temporary sources nor the temporary libraries are left in the cache
+    BOOST_CHECK(boost::filesystem::exists(rnea_code_gen_modified.getLibraryName() + "_sources"));
+    for(boost::filesystem::directory_iterator it(cache.path), end; it != end; ++it)
+      BOOST_CHECK(it->path().extension() != ".tmp");
+  }
+
+  BOOST_AUTO_TEST_CASE(test_code_generator_library)
+  {
+    using namespace pinocchio;
+    
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    Data data(model);
+    
+    CodeGenCRBA<double> crba_code_gen(model);
+    CodeGenMinv<double> minv_code_gen(model);
+    CodeGenRNEA<double> rnea_code_gen(model);
+    
+    CodeGenLibrary<double> library(model);
+    library.addFunction(crba_code_gen);
+    library.addFunction(minv_code_gen);
+    library.addFunction(rnea_code_gen);
+    BOOST_CHECK(library.size() == 3);
+    
+    // The function names must be unique and the model must be the same
+    CodeGenCRBA<double> crba_code_gen_duplicate(model);
+    BOOST_CHECK_THROW(library.addFunction(crba_code_gen_duplicate),std::invalid_argument);
+    Model other_model;
+    buildModels::humanoidRandom(other_model);
+    CodeGenABA<double> aba_code_gen_other(other_model);
+    BOOST_CHECK_THROW(library.addFunction(aba_code_gen_other),std::invalid_argument);
+    
+    const TemporaryDirectory cache;
+    library.setCacheDirectory(cache.path);
+    library.initLib();
+    library.loadLib();
+    BOOST_CHECK(library.existLib());
+    
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    
+    crba(model,data,q);
+    data.M.triangularView<Eigen::StrictlyLower>() = data.M.transpose().triangularView<Eigen::StrictlyLower>();
+    
+    crba_code_gen.evalFunction(q);
+    crba_code_gen.M.triangularView<Eigen::StrictlyLower>() = crba_code_gen.M.transpose().triangularView<Eigen::StrictlyLower>();
+    BOOST_CHECK(crba_code_gen.M.isApprox(data.M));
+    
+    minv_code_gen.evalFunction(q);
+    minv_code_gen.Minv.triangularView<Eigen::StrictlyLower>() = minv_code_gen.Minv.transpose().triangularView<Eigen::StrictlyLower>();
+    BOOST_CHECK((minv_code_gen.Minv * data.M).isIdentity());
+    
+    rnea_code_gen.evalJacobian(q,v,a);
+    BOOST_CHECK(rnea_code_gen.dtau_da.isApprox(data.M));
+  }
+
+  BOOST_AUTO_TEST_CASE(test_frames_and_centroidal_code_generation)
+  {
+    using namespace pinocchio;
+    
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    Data data(model);
+    
+    std::vector<FrameIndex> frame_ids;
+    frame_ids.push_back(model.getFrameId("rleg6_joint"));
+    frame_ids.push_back(model.getFrameId("lleg6_joint"));
+    frame_ids.push_back(model.getFrameId("rarm6_joint"));
+    
+    BOOST_CHECK_THROW(CodeGenFramePlacements<double>(model,std::vector<FrameIndex>()),std::invalid_argument);
+    
+    CodeGenFramePlacements<double> placements_code_gen(model,frame_ids);
+    CodeGenFrameJacobians<double> jacobians_code_gen(model,frame_ids,LOCAL_WORLD_ALIGNED);
+    CodeGenFrameKinematics<double> kinematics_code_gen(model,frame_ids,LOCAL);
+    CodeGenCenterOfMass<double> com_code_gen(model);
+    CodeGenCCRBA<double> ccrba_code_gen(model);
+    
+    // The frames are part of the library hash
+    std::vector<FrameIndex> other_frame_ids(frame_ids.rbegin(),frame_ids.rend());
+    BOOST_CHECK(CodeGenFramePlacements<double>(model,other_frame_ids).getLibraryHash() != placements_code_gen.getLibraryHash());
+    BOOST_CHECK(CodeGenFrameJacobians<double>(model,frame_ids,WORLD).getLibraryHash() != jacobians_code_gen.getLibraryHash());
+    
+    CodeGenLibrary<double> library(model,"cg_frames_and_centroidal");
+    library.addFunction(placements_code_gen);
+    library.addFunction(jacobians_code_gen);
+    library.addFunction(kinematics_code_gen);
+    library.addFunction(com_code_gen);
+    library.addFunction(ccrba_code_gen);
+    const TemporaryDirectory cache;
+    library.setCacheDirectory(cache.path);
+    library.initLib();
+    library.loadLib();
+    
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    
+    forwardKinematics(model,data,q,v,a);
+    updateFramePlacements(model,data);
+    computeJointJacobians(model,data,q);
+    
+    placements_code_gen.evalFunction(q);
+    jacobians_code_gen.evalFunction(q);
+    kinematics_code_gen.evalFunction(q,v,a);
+    for(std::size_t k = 0; k < frame_ids.size(); ++k)
+    {
+      BOOST_CHECK(placements_code_gen.oMf[k].isApprox(data.oMf[frame_ids[k]]));
+      
+      Data::Matrix6x J(Data::Matrix6x::Zero(6,model.nv));
+      getFrameJacobian(model,data,frame_ids[k],LOCAL_WORLD_ALIGNED,J);
+      BOOST_CHECK(jacobians_code_gen.J[k].isApprox(J));
+      
+      BOOST_CHECK(kinematics_code_gen.frame_v[k].isApprox(getFrameVelocity(model,data,frame_ids[k],LOCAL)));
+      BOOST_CHECK(kinematics_code_gen.frame_a[k].isApprox(getFrameAcceleration(model,data,frame_ids[k],LOCAL)));
+    }
+    
+    jacobianCenterOfMass(model,data,q);
+    com_code_gen.evalFunction(q);
+    BOOST_CHECK(com_code_gen.com.isApprox(data.com[0]));
+    BOOST_CHECK(com_code_gen.Jcom.isApprox(data.Jcom));
+    
+    ccrba(model,data,q,v);
+    ccrba_code_gen.evalFunction(q,v);
+    BOOST_CHECK(ccrba_code_gen.Ag.isApprox(data.Ag));
+    BOOST_CHECK(ccrba_code_gen.hg.isApprox(data.hg));
+  }
+
+  BOOST_AUTO_TEST_CASE(test_sparse_jacobian)
+  {
+    using namespace pinocchio;
+    
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    
+    CodeGenRNEA<double> rnea_code_gen(model,"rnea_sparse","cg_rnea_sparse_eval");
+    const boost::uint64_t dense_hash = rnea_code_gen.getLibraryHash();
+    rnea_code_gen.setBuildSparseJacobian(true);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != dense_hash);
+    
+    // The sparse Jacobian replaces the dense one, which is kept here as a reference.
+    const boost::uint64_t sparse_hash = rnea_code_gen.getLibraryHash();
+    rnea_code_gen.setBuildJacobian(true);
+    BOOST_CHECK(rnea_code_gen.getLibraryHash() != sparse_hash);
+    
+    const TemporaryDirectory cache;
+    rnea_code_gen.setCacheDirectory(cache.path);
+    rnea_code_gen.initLib();
+    rnea_code_gen.loadLib();
+    
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    
+    rnea_code_gen.evalJacobian(q,v,a);
+    rnea_code_gen.evalSparseJacobian(q,v,a);
+    
+    BOOST_CHECK(rnea_code_gen.sparse_dtau_dq.nonZeros() < model.nv*model.nq);
+    BOOST_CHECK(rnea_code_gen.sparse_dtau_dv.nonZeros() < model.nv*model.nv);
+    BOOST_CHECK(Eigen::MatrixXd(rnea_code_gen.sparse_dtau_dq).isApprox(rnea_code_gen.dtau_dq));
+    BOOST_CHECK(Eigen::MatrixXd(rnea_code_gen.sparse_dtau_dv).isApprox(rnea_code_gen.dtau_dv));
+    BOOST_CHECK(Eigen::MatrixXd(rnea_code_gen.sparse_dtau_da).isApprox(rnea_code_gen.dtau_da));
+    
+    // The patterns are kept between two evaluations, only the values are updated.
+    const double * dtau_dq_values = rnea_code_gen.sparse_dtau_dq.valuePtr();
+    const Eigen::VectorXd q2 = randomConfiguration(model);
+    rnea_code_gen.evalJacobian(q2,v,a);
+    rnea_code_gen.evalSparseJacobian(q2,v,a);
+    BOOST_CHECK(rnea_code_gen.sparse_dtau_dq.valuePtr() == dtau_dq_values);
+    BOOST_CHECK(Eigen::MatrixXd(rnea_code_gen.sparse_dtau_dq).isApprox(rnea_code_gen.dtau_dq));
+    BOOST_CHECK(Eigen::MatrixXd(rnea_code_gen.sparse_dtau_dv).isApprox(rnea_code_gen.dtau_dv));
+  }
+
+  BOOST_AUTO_TEST_CASE(test_batch_evaluation)
+  {
+    using namespace pinocchio;
+    
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    Data data(model);
+    
+    CodeGenRNEA<double> rnea_code_gen(model);
+    const TemporaryDirectory cache;
+    rnea_code_gen.setCacheDirectory(cache.path);
+    rnea_code_gen.initLib();
+    rnea_code_gen.loadLib();
+    
+    const Eigen::DenseIndex num_samples = 10;
+    const Eigen::DenseIndex nx = rnea_code_gen.getInputDimension();
+    Eigen::MatrixXd X(nx,num_samples);
+    for(Eigen::DenseIndex k = 0; k < num_samples; ++k)
+    {
+      X.col(k).head(model.nq) = randomConfiguration(model);
+      X.col(k).tail(2*model.nv).setRandom();
+    }
+    
+    BOOST_CHECK_THROW(rnea_code_gen.evalFunctionBatch(X,Eigen::MatrixXd(model.nv,num_samples-1)),std::invalid_argument);
+    
+    for(std::size_t num_threads = 1; num_threads <= 3; num_threads += 2)
+    {
+      Eigen::MatrixXd Y(model.nv,num_samples);
+      Eigen::MatrixXd J(model.nv*nx,num_samples);
+      rnea_code_gen.evalFunctionBatch(X,Y,num_threads);
+      rnea_code_gen.evalJacobianBatch(X,J,num_threads);
+      
+      for(Eigen::DenseIndex k = 0; k < num_samples; ++k)
+      {
+        const Eigen::VectorXd q = X.col(k).head(model.nq);
+        const Eigen::VectorXd v = X.col(k).segment(model.nq,model.nv);
+        const Eigen::VectorXd a = X.col(k).tail(model.nv);
+        BOOST_CHECK(Y.col(k).isApprox(rnea(model,data,q,v,a)));
+        
+        rnea_code_gen.evalJacobian(q,v,a);
+        typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMatrixXd;
+        const Eigen::Map<RowMatrixXd> jac(J.col(k).data(),model.nv,nx);
+        BOOST_CHECK(jac.leftCols(model.nq).isApprox(rnea_code_gen.dtau_dq));
+        BOOST_CHECK(jac.rightCols(model.nv).isApprox(rnea_code_gen.dtau_da));
+      }
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(test_parallel_compiler)
+  {
+    const TemporaryDirectory directory;
+    const boost::filesystem::path path(directory.path);
+    
+    std::vector<std::string> sources;
+    for(int k = 0; k < 4; ++k)
+    {
+      const std::string source = (path / ("parallel_compiler_f" + std::to_string(k) + ".c")).string();
+      std::ofstream file(source.c_str());
+      file << "double parallel_compiler_f" << k << "(double x) { return " << k << " * x; }" << std::endl;
+      sources.push_back(source);
+    }
+    const std::string library = (path / "parallel_compiler_lib.so").string();
+    
+    // a fresh object cache
+    pinocchio::ParallelCCompiler compiler((path / "objects").string(),2);
+    BOOST_CHECK(compiler.createDynamicLibrary(sources,library) == sources.size());
+    BOOST_CHECK(compiler.createDynamicLibrary(sources,library) == 0);
+    
+    // Only the modified source is compiled again
+    {
+      std::ofstream file(sources[1].c_str());
+      file << "double parallel_compiler_f1(double x) { return 10. * x; }" << std::endl;
+    }
+    BOOST_CHECK(compiler.createDynamicLibrary(sources,library) == 1);
+    
+    // The paths are passed as they are to the compiler, without going through a shell
+    const std::string quoted_source = (path / "parallel_compiler_'quoted' f.c").string();
+    {
+      std::ofstream file(quoted_source.c_str());
+      file << "double parallel_compiler_quoted(double x) { return x; }" << std::endl;
+    }
+    sources.push_back(quoted_source);
+    BOOST_CHECK(compiler.createDynamicLibrary(sources,library) == 1);
+    
+    {
+      std::ofstream file(sources[2].c_str());
+      file << "not a C source" << std::endl;
+    }
+    BOOST_CHECK_THROW(compiler.createDynamicLibrary(sources,library),std::runtime_error);
+    
+    pinocchio::ParallelCCompiler wrong_compiler((path / "objects").string(),2,(path / "no_compiler").string());
+    BOOST_CHECK_THROW(wrong_compiler.createDynamicLibrary(sources,library),std::runtime_error);
+  }
+
 BOOST_AUTO_TEST_SUITE_END()
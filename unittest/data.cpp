@@ -7,6 +7,15 @@
 #include "pinocchio/parsers/sample-models.hpp"
 
 #include "pinocchio/algorithm/check.hpp"
+#include "pinocchio/algorithm/aba.hpp"
+#include "pinocchio/algorithm/rnea-derivatives.hpp"
+#include "pinocchio/algorithm/aba-derivatives.hpp"
+#include "pinocchio/algorithm/kinematics-derivatives.hpp"
+#include "pinocchio/algorithm/regressor.hpp"
+#include "pinocchio/algorithm/rnea.hpp"
+#include "pinocchio/algorithm/crba.hpp"
+#include "pinocchio/algorithm/cholesky.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
 
 #include <boost/test/unit_test.hpp>
 #include <boost/utility/binary.hpp>
@@ -107,4 +116,294 @@ BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
       datas.push_back(Data(model));
   }
 
+  BOOST_AUTO_TEST_CASE(test_selective_allocation)
+  {
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+    
+    Data data(model,ALLOCATE_NONE), data_ref(model);
+    BOOST_CHECK(model.check(data));
+    BOOST_CHECK(data_ref.isAllocated(ALLOCATE_ALL));
+    BOOST_CHECK(!data.isAllocated(ALLOCATE_MINV));
+    BOOST_CHECK(data.Minv.size() == 0);
+    BOOST_CHECK(data.kinematic_hessians.size() == 0);
+    BOOST_CHECK(data.memoryFootprint().total() < data_ref.memoryFootprint().total());
+    
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    
+    // The buffers are allocated on first use
+    computeMinverse(model,data,q);
+    computeMinverse(model,data_ref,q);
+    BOOST_CHECK(data.isAllocated(ALLOCATE_MINV));
+    BOOST_CHECK(!data.isAllocated(ALLOCATE_MINV | ALLOCATE_DERIVATIVES));
+    BOOST_CHECK(data.Minv.isApprox(data_ref.Minv));
+    
+    computeRNEADerivatives(model,data,q,v,a);
+    computeRNEADerivatives(model,data_ref,q,v,a);
+    BOOST_CHECK(data.isAllocated(ALLOCATE_DERIVATIVES));
+    BOOST_CHECK(data.dtau_dq.isApprox(data_ref.dtau_dq));
+    BOOST_CHECK(data.dtau_dv.isApprox(data_ref.dtau_dv));
+    BOOST_CHECK(model.check(data));
+    
+    // Allocating twice keeps the content of the buffers
+    const Data::MatrixXs Minv = data.Minv;
+    data.allocate(model,ALLOCATE_ALL);
+    BOOST_CHECK(data.isAllocated(ALLOCATE_ALL));
+    BOOST_CHECK(data.Minv == Minv);
+    BOOST_CHECK(model.check(data));
+    BOOST_CHECK(data.memoryFootprint().total() == Data(model).memoryFootprint().total());
+    
+    data.release(ALLOCATE_DERIVATIVES | ALLOCATE_KINEMATIC_HESSIANS);
+    BOOST_CHECK(data.isAllocated(ALLOCATE_MINV));
+    BOOST_CHECK(!data.isAllocated(ALLOCATE_DERIVATIVES));
+    BOOST_CHECK(data.dtau_dq.size() == 0);
+    BOOST_CHECK(model.check(data));
+  }
+
+  BOOST_AUTO_TEST_CASE(test_equal_op_selective_allocation)
+  {
+    Model model;
+    buildModels::humanoidRandom(model);
+    
+    Data data_lazy(model,ALLOCATE_NONE), data_full(model);
+    BOOST_CHECK(data_lazy != data_full);
+    BOOST_CHECK(data_full != data_lazy);
+    BOOST_CHECK(data_lazy == Data(model,ALLOCATE_NONE));
+    
+    // Only the allocated buffers are compared
+    Data data_minv(model,ALLOCATE_MINV);
+    data_lazy.allocate(model,ALLOCATE_MINV);
+    BOOST_CHECK(data_lazy == data_minv);
+    data_minv.Minv.setIdentity();
+    BOOST_CHECK(data_lazy != data_minv);
+    
+    data_lazy.allocate(model,ALLOCATE_ALL);
+    BOOST_CHECK(data_lazy == data_full);
+  }
+
+  BOOST_AUTO_TEST_CASE(test_lazy_allocation_entry_points)
+  {
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd tau = Eigen::VectorXd::Random(model.nv);
+    const PINOCCHIO_ALIGNED_STD_VECTOR(Force) fext((size_t)model.njoints,Force::Random());
+
+    Data data_ref(model);
+
+    // Each entry point writing into a lazily allocated buffer of data must allocate it first.
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeMinverse(model,data,q);
+      computeMinverse(model,data_ref,q);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_MINV));
+      BOOST_CHECK(data.Minv.isApprox(data_ref.Minv));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      crba(model,data,q);
+      cholesky::decompose(model,data);
+      cholesky::computeMinv(model,data);
+      crba(model,data_ref,q);
+      cholesky::decompose(model,data_ref);
+      cholesky::computeMinv(model,data_ref);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_MINV));
+      BOOST_CHECK(data.Minv.isApprox(data_ref.Minv));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeCoriolisMatrix(model,data,q,v);
+      computeCoriolisMatrix(model,data_ref,q,v);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_CORIOLIS));
+      BOOST_CHECK(data.C.isApprox(data_ref.C));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeRNEADerivatives(model,data,q,v,a);
+      getCoriolisMatrix(model,data);
+      computeRNEADerivatives(model,data_ref,q,v,a);
+      getCoriolisMatrix(model,data_ref);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_CORIOLIS | ALLOCATE_DERIVATIVES));
+      BOOST_CHECK(data.C.isApprox(data_ref.C));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeRNEADerivatives(model,data,q,v,a);
+      computeRNEADerivatives(model,data_ref,q,v,a);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_DERIVATIVES));
+      BOOST_CHECK(data.dtau_dq.isApprox(data_ref.dtau_dq));
+      BOOST_CHECK(data.dtau_dv.isApprox(data_ref.dtau_dv));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeRNEADerivatives(model,data,q,v,a,fext);
+      computeRNEADerivatives(model,data_ref,q,v,a,fext);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_DERIVATIVES));
+      BOOST_CHECK(data.dtau_dq.isApprox(data_ref.dtau_dq));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeABADerivatives(model,data,q,v,tau);
+      computeABADerivatives(model,data_ref,q,v,tau);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_MINV | ALLOCATE_DERIVATIVES));
+      BOOST_CHECK(data.ddq_dq.isApprox(data_ref.ddq_dq));
+      BOOST_CHECK(data.Minv.isApprox(data_ref.Minv));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeABADerivatives(model,data,q,v,tau,fext);
+      computeABADerivatives(model,data_ref,q,v,tau,fext);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_MINV | ALLOCATE_DERIVATIVES));
+      BOOST_CHECK(data.ddq_dv.isApprox(data_ref.ddq_dv));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeJointKinematicHessians(model,data,q);
+      computeJointKinematicHessians(model,data_ref,q);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_KINEMATIC_HESSIANS));
+      Data::Tensor3x diff = data.kinematic_hessians - data_ref.kinematic_hessians;
+      const Data::Tensor3x::Index size = diff.size();
+      BOOST_CHECK(Eigen::Map<Eigen::VectorXd>(diff.data(),size).isZero());
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeStaticRegressor(model,data,q);
+      computeStaticRegressor(model,data_ref,q);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_REGRESSORS));
+      BOOST_CHECK(data.staticRegressor.isApprox(data_ref.staticRegressor));
+    }
+    {
+      Data data(model,ALLOCATE_NONE);
+      computeJointTorqueRegressor(model,data,q,v,a);
+      computeJointTorqueRegressor(model,data_ref,q,v,a);
+      BOOST_CHECK(data.isAllocated(ALLOCATE_REGRESSORS));
+      BOOST_CHECK(data.jointTorqueRegressor.isApprox(data_ref.jointTorqueRegressor));
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(test_arena)
+  {
+    Model model;
+    buildModels::humanoidRandom(model);
+    model.lowerPositionLimit.head<3>().fill(-1.);
+    model.upperPositionLimit.head<3>().fill(1.);
+
+    Data data(model,ALLOCATE_ALL,true), data_ref(model);
+    BOOST_CHECK(data_ref.arena() == NULL);
+    BOOST_REQUIRE(data.arena() != NULL);
+    BOOST_CHECK(model.check(data));
+    container::Arena * arena = data.arena();
+
+    // All the per-joint and per-frame vectors fit exactly in the arena
+    BOOST_CHECK(arena->used() == arena->capacity());
+    BOOST_CHECK(arena->owns(&data.joints[0]));
+    BOOST_CHECK(arena->owns(&data.oMi[0]));
+    BOOST_CHECK(arena->owns(&data.oMf[0]));
+    BOOST_CHECK(arena->owns(&data.acom[0]));
+    BOOST_CHECK(data == data_ref);
+
+    // The arena is reported as a whole, the vectors it holds only report the dynamic memory of their elements
+    const MemoryFootprint footprint = data.memoryFootprint(), footprint_ref = data_ref.memoryFootprint();
+    BOOST_CHECK(footprint.field("arena") == arena->capacity());
+    BOOST_CHECK(footprint_ref.field("arena") == 0);
+    BOOST_CHECK(footprint.field("oMi") == 0);
+    BOOST_CHECK(footprint.field("Fcrb") == footprint_ref.field("Fcrb") - data_ref.Fcrb.capacity() * sizeof(Data::Matrix6x));
+    BOOST_CHECK(footprint.field("M") == footprint_ref.field("M"));
+
+    const Eigen::VectorXd q = randomConfiguration(model);
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(model.nv);
+    const Eigen::VectorXd a = Eigen::VectorXd::Random(model.nv);
+    computeRNEADerivatives(model,data,q,v,a);
+    computeRNEADerivatives(model,data_ref,q,v,a);
+    BOOST_CHECK(data.dtau_dq.isApprox(data_ref.dtau_dq));
+
+    // Growing a vector beyond the arena falls back to the heap, and its former block is lost until the arena is destroyed
+    BOOST_CHECK(arena->numOverflows() == 0);
+    BOOST_CHECK(arena->released() == 0);
+    data.oMf.push_back(SE3::Identity());
+    BOOST_CHECK(!arena->owns(&data.oMf[0]));
+    BOOST_CHECK(arena->numOverflows() == 1);
+    BOOST_CHECK(arena->released() == container::Arena::align((size_t)model.nframes * sizeof(SE3)));
+    data.oMf.pop_back();
+
+    // A copy lives on the heap and does not report the arena of the original
+    Data data_copy(data);
+    BOOST_CHECK(data_copy == data);
+    BOOST_CHECK(data_copy.arena() == NULL);
+    BOOST_CHECK(!arena->owns(&data_copy.oMi[0]));
+    BOOST_CHECK(data_copy.memoryFootprint().field("arena") == 0);
+
+    // An assignment keeps the arena of the destination
+    Data data_assigned(model,ALLOCATE_ALL,true);
+    data_assigned = data_ref;
+    BOOST_CHECK(data_assigned == data_ref);
+    BOOST_CHECK(data_assigned.arena()->owns(&data_assigned.oMi[0]));
+  }
+
+  BOOST_AUTO_TEST_CASE(test_arena_swap_and_move)
+  {
+    Model model;
+    buildModels::humanoidRandom(model);
+
+    Data data(model,ALLOCATE_ALL,true), data_ref(model);
+    BOOST_REQUIRE(data.arena() != NULL);
+    container::Arena * arena = data.arena();
+    data_ref.oMi[1] = SE3::Random();
+    const Data::SE3 oMi_ref = data_ref.oMi[1];
+
+    // A swap exchanges the buffers together with their arenas
+    const Data::SE3 * liMi_buffer = &data.liMi[0];
+    data.liMi.swap(data_ref.oMi);
+    BOOST_CHECK(&data_ref.oMi[0] == liMi_buffer);
+    BOOST_CHECK(data_ref.oMi.get_allocator().arena() == arena);
+    BOOST_CHECK(data.liMi.get_allocator().arena() == NULL);
+    BOOST_CHECK(data.liMi[1] == oMi_ref);
+    swap(data.liMi,data_ref.oMi);
+    BOOST_CHECK(&data.liMi[0] == liMi_buffer);
+    BOOST_CHECK(data_ref.oMi[1] == oMi_ref);
+
+    // A copy assignment keeps the memory of the destination
+    data.oMi = data_ref.oMi;
+    BOOST_CHECK(data.oMi.get_allocator().arena() == arena);
+    BOOST_CHECK(arena->owns(&data.oMi[0]));
+    BOOST_CHECK(data.oMi[1] == oMi_ref);
+
+    // An arena buffer handed over to another vector keeps the arena alive
+    PINOCCHIO_ALIGNED_STD_VECTOR(Data::SE3) oMf;
+    {
+      Data data_tmp(model,ALLOCATE_ALL,true);
+      data_tmp.oMf[0] = oMi_ref;
+      oMf.swap(data_tmp.oMf);
+    }
+    BOOST_REQUIRE(oMf.get_allocator().arena() != NULL);
+    BOOST_CHECK(oMf.get_allocator().arena()->owns(&oMf[0]));
+    BOOST_CHECK(oMf[0] == oMi_ref);
+    oMf.resize(oMf.size() + 1);
+    BOOST_CHECK(oMf[0] == oMi_ref);
+
+#ifdef PINOCCHIO_WITH_CXX11_SUPPORT
+    // A move hands the buffers over without copying them
+    const Data::SE3 * oMi_buffer = &data.oMi[0];
+    Data data_moved(std::move(data));
+    BOOST_CHECK(data_moved.arena() == arena);
+    BOOST_CHECK(&data_moved.oMi[0] == oMi_buffer);
+    BOOST_CHECK(data_moved.oMi[1] == oMi_ref);
+
+    Data data_move_assigned(model);
+    data_move_assigned = std::move(data_moved);
+    BOOST_CHECK(data_move_assigned.arena() == arena);
+    BOOST_CHECK(&data_move_assigned.oMi[0] == oMi_buffer);
+    BOOST_CHECK(data_move_assigned.memoryFootprint().field("arena") == arena->capacity());
+#endif
+  }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,7 +10,9 @@
 #include "pinocchio/multibody/geometry.hpp"
 #include "pinocchio/algorithm/kinematics.hpp"
 #include "pinocchio/algorithm/geometry.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
 #include "pinocchio/parsers/urdf.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
 #include "pinocchio/parsers/srdf.hpp"
 
 #include <vector>
@@ -232,6 +234,53 @@ BOOST_AUTO_TEST_CASE ( test_distances )
   }
 }
   
+BOOST_AUTO_TEST_CASE ( test_broad_phase )
+{
+  Model model; buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  
+  GeometryModel geom_model;
+  for(JointIndex joint_id = 1; joint_id < (JointIndex)model.njoints; ++joint_id)
+  {
+    const std::string name = model.names[joint_id] + "_sphere";
+    GeometryObject::CollisionGeometryPtr sphere(new fcl::Sphere(0.05 * (double)(joint_id%3 + 1)));
+    geom_model.addGeometryObject(GeometryObject(name,0,joint_id,sphere,SE3::Random()));
+  }
+  geom_model.addAllCollisionPairs();
+  
+  Data data(model);
+  GeometryData geom_data_ref(geom_model), geom_data(geom_model);
+  geom_data.enableBroadPhase = true;
+  
+  std::size_t nculled_pairs = 0;
+  for(int k = 0; k < 20; ++k)
+  {
+    const Eigen::VectorXd q = randomConfiguration(model);
+    
+    const bool res_ref = computeCollisions(model,data,geom_model,geom_data_ref,q);
+    const bool res = computeCollisions(model,data,geom_model,geom_data,q);
+    BOOST_CHECK(res == res_ref);
+    BOOST_CHECK(geom_data_ref.nculledPairs == 0);
+    nculled_pairs += geom_data.nculledPairs;
+    
+    for(PairIndex cp_index = 0; cp_index < geom_model.collisionPairs.size(); ++cp_index)
+    {
+      BOOST_CHECK(geom_data.collisionResults[cp_index].isCollision()
+                  == geom_data_ref.collisionResults[cp_index].isCollision());
+      // The bounding spheres provide a lower bound of the distance.
+      BOOST_CHECK(computeBroadPhaseDistance(geom_model,geom_data,cp_index)
+                  <= computeDistance(geom_model,geom_data,cp_index).min_distance + 1e-12);
+    }
+    
+    const std::size_t min_index_ref = computeDistances(geom_model,geom_data_ref);
+    const std::size_t min_index = computeDistances(geom_model,geom_data);
+    BOOST_CHECK(geom_data.distanceResults[min_index].min_distance
+                == geom_data_ref.distanceResults[min_index_ref].min_distance);
+  }
+  BOOST_CHECK(nculled_pairs > 0);
+}
+
 BOOST_AUTO_TEST_CASE ( test_append_geom_models )
 {
   typedef pinocchio::Model Model;
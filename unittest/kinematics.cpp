@@ -5,6 +5,7 @@
 #include "pinocchio/multibody/model.hpp"
 #include "pinocchio/multibody/data.hpp"
 #include "pinocchio/algorithm/kinematics.hpp"
+#include "pinocchio/algorithm/frames.hpp"
 #include "pinocchio/algorithm/crba.hpp"
 #include "pinocchio/algorithm/joint-configuration.hpp"
 #include "pinocchio/parsers/sample-models.hpp"
@@ -276,4 +277,60 @@ BOOST_AUTO_TEST_CASE(test_kinematic_getters)
   BOOST_CHECK(ac_align.isApprox(getClassicalAcceleration(model,data,jointId,LOCAL_WORLD_ALIGNED)));
 }
 
+BOOST_AUTO_TEST_CASE(test_update_kinematics)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+  
+  Model model;
+  buildModels::humanoidRandom(model);
+  
+  Data data(model), data_ref(model);
+  
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  const VectorXd q_prev = randomConfiguration(model);
+  
+  forwardKinematics(model,data,q_prev);
+  updateFramePlacements(model,data);
+  
+  // Move the right wrist and the left hip
+  const JointIndex rh_id = model.getJointId("rarm5_joint");
+  const JointIndex lh_id = model.getJointId("lleg1_joint");
+  VectorXd q(q_prev);
+  q[model.joints[rh_id].idx_q()] += 0.3;
+  q[model.joints[lh_id].idx_q()] -= 0.2;
+  
+  std::vector<JointIndex> joint_ids;
+  findChangedJoints(model,q_prev,q,joint_ids);
+  BOOST_CHECK(joint_ids.size() == 2);
+  BOOST_CHECK(joint_ids[0] == std::min(rh_id,lh_id));
+  BOOST_CHECK(joint_ids[1] == std::max(rh_id,lh_id));
+  
+  forwardKinematics(model,data_ref,q);
+  updateFramePlacements(model,data_ref);
+  
+  updateForwardKinematics(model,data,q,joint_ids);
+  updateFramePlacements(model,data,joint_ids);
+  
+  for(Model::JointIndex i = 1; i < (Model::JointIndex)model.njoints; ++i)
+  {
+    BOOST_CHECK(data.oMi[i].isApprox(data_ref.oMi[i]));
+    BOOST_CHECK(data.liMi[i].isApprox(data_ref.liMi[i]));
+  }
+  for(Model::FrameIndex i = 0; i < (Model::FrameIndex)model.nframes; ++i)
+    BOOST_CHECK(data.oMf[i].isApprox(data_ref.oMf[i]));
+  
+  // Change the whole configuration, including the root joint
+  const VectorXd q_new = randomConfiguration(model);
+  forwardKinematics(model,data_ref,q_new);
+  updateForwardKinematics(model,data,q,q_new);
+  
+  for(Model::JointIndex i = 1; i < (Model::JointIndex)model.njoints; ++i)
+    BOOST_CHECK(data.oMi[i].isApprox(data_ref.oMi[i]));
+  
+  joint_ids.assign(1,(JointIndex)model.njoints);
+  BOOST_CHECK_THROW(updateForwardKinematics(model,data,q_new,joint_ids),std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
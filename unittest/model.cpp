@@ -120,6 +120,41 @@ BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
     BOOST_CHECK(model.cast<double>().cast<long double>() == model.cast<long double>());
   }
 
+  BOOST_AUTO_TEST_CASE(test_memory_footprint)
+  {
+    Model model;
+    buildModels::humanoidRandom(model);
+
+    MemoryFootprint footprint = model.memoryFootprint();
+    BOOST_CHECK(footprint.base == sizeof(Model));
+    BOOST_CHECK(footprint.field("supports") > 0);
+    BOOST_CHECK(footprint.field("unknown_field") == 0);
+
+    std::size_t total = footprint.base;
+    for(MemoryFootprint::FieldVector::const_iterator it = footprint.fields.begin();
+        it != footprint.fields.end(); ++it)
+      total += it->second;
+    BOOST_CHECK(footprint.total() == total);
+
+    // A composite joint owns its sub-joints
+    JointModelComposite jmodel_composite((JointModelRX()));
+    jmodel_composite.addJoint(JointModelRY());
+    jmodel_composite.addJoint(JointModelFreeFlyer());
+    model.addJoint(0,jmodel_composite,SE3::Identity(),"composite");
+    BOOST_CHECK(model.memoryFootprint().field("joints") > footprint.field("joints") + sizeof(JointModelComposite));
+
+    Data data(model);
+    MemoryFootprint data_footprint = data.memoryFootprint();
+    BOOST_CHECK(data_footprint.base == sizeof(Data));
+    BOOST_CHECK(data_footprint.field("M") == (std::size_t)(model.nv*model.nv)*sizeof(double));
+    BOOST_CHECK(data_footprint.field("joints") > 0);
+
+    GeometryModel geom_model;
+    GeometryData geom_data(geom_model);
+    BOOST_CHECK(geom_model.memoryFootprint().total() >= sizeof(GeometryModel));
+    BOOST_CHECK(geom_data.memoryFootprint().total() >= sizeof(GeometryData));
+  }
+
   BOOST_AUTO_TEST_CASE(test_std_vector_of_Model)
   {
     Model model;
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/algorithm/parallel/aba.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
+
+BOOST_AUTO_TEST_CASE(test_parallel_aba)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+  
+  Model model; buildModels::humanoidRandom(model);
+  Data data_ref(model);
+  
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  
+  const Eigen::DenseIndex batch_size = 128;
+  const size_t num_threads = (size_t)omp_get_max_threads();
+  
+  MatrixXd q(model.nq,batch_size);
+  MatrixXd v(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd tau(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd a(MatrixXd::Zero(model.nv,batch_size));
+  
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+    q.col(i) = randomConfiguration(model);
+  
+  ModelPool pool(model,num_threads);
+  abaInParallel(num_threads,pool,q,v,tau,a);
+  
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+  {
+    aba(model,data_ref,q.col(i),v.col(i),tau.col(i));
+    BOOST_CHECK(a.col(i) == data_ref.ddq);
+  }
+  
+  // Wrong arguments
+  BOOST_CHECK_THROW(abaInParallel(pool.size()+1,pool,q,v,tau,a),std::invalid_argument);
+  MatrixXd a_wrong(MatrixXd::Zero(model.nv,batch_size-1));
+  BOOST_CHECK_THROW(abaInParallel(num_threads,pool,q,v,tau,a_wrong),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/algorithm/parallel/geometry.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+using namespace pinocchio;
+
+// Attach a sphere to each joint of the model and activate all the collision pairs.
+static void buildSpheres(const Model & model, GeometryModel & geom_model)
+{
+  for(JointIndex joint_id = 1; joint_id < (JointIndex)model.njoints; ++joint_id)
+  {
+    const std::string name = model.names[joint_id] + "_sphere";
+    GeometryObject::CollisionGeometryPtr sphere(new hpp::fcl::Sphere(0.1));
+    geom_model.addGeometryObject(GeometryObject(name,0,joint_id,sphere,SE3::Identity()));
+  }
+  geom_model.addAllCollisionPairs();
+}
+
+BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
+
+BOOST_AUTO_TEST_CASE(test_parallel_collision_pairs)
+{
+  Model model; buildModels::humanoidRandom(model);
+  Data data(model);
+
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+
+  GeometryModel geom_model; buildSpheres(model,geom_model);
+  GeometryData geom_data(geom_model), geom_data_ref(geom_model);
+
+  const size_t num_threads = (size_t)omp_get_max_threads();
+
+  for(int k = 0; k < 20; ++k)
+  {
+    const Eigen::VectorXd q = randomConfiguration(model);
+    updateGeometryPlacements(model,data,geom_model,geom_data_ref,q);
+    updateGeometryPlacements(model,data,geom_model,geom_data,q);
+
+    const bool res_ref = computeCollisions(geom_model,geom_data_ref,false);
+    const bool res = computeCollisionsInParallel(num_threads,geom_model,geom_data,false);
+
+    BOOST_CHECK(res == res_ref);
+    for(size_t cp_index = 0; cp_index < geom_model.collisionPairs.size(); ++cp_index)
+    {
+      BOOST_CHECK(geom_data.collisionResults[cp_index].isCollision()
+                  == geom_data_ref.collisionResults[cp_index].isCollision());
+    }
+
+    if(res_ref)
+    {
+      // The serial version stops at the first colliding pair.
+      computeCollisions(geom_model,geom_data_ref,true);
+      BOOST_CHECK(geom_data.collisionPairIndex == geom_data_ref.collisionPairIndex);
+    }
+
+    BOOST_CHECK(computeCollisionsInParallel(num_threads,geom_model,geom_data,true) == res_ref);
+  }
+
+  BOOST_CHECK_THROW(computeCollisionsInParallel(0,geom_model,geom_data),std::invalid_argument);
+
+  // An exception raised within the parallel region is forwarded to the caller.
+  GeometryModel geom_model_invalid(geom_model);
+  geom_model_invalid.collisionPairs.push_back(CollisionPair(0,geom_model_invalid.ngeoms));
+  GeometryData geom_data_invalid(geom_model_invalid);
+  BOOST_CHECK_THROW(computeCollisionsInParallel(2,geom_model_invalid,geom_data_invalid),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_collision_batch)
+{
+  Model model; buildModels::humanoidRandom(model);
+  Data data(model);
+
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+
+  GeometryModel geom_model; buildSpheres(model,geom_model);
+  GeometryData geom_data(geom_model);
+
+  const Eigen::DenseIndex batch_size = 128;
+  const size_t num_threads = (size_t)omp_get_max_threads();
+
+  Eigen::MatrixXd q(model.nq,batch_size);
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+    q.col(i) = randomConfiguration(model);
+
+  typedef Eigen::Matrix<bool,Eigen::Dynamic,1> VectorXb;
+  VectorXb res(batch_size), res_stop(batch_size);
+
+  GeometryPool pool(model,geom_model,num_threads);
+  computeCollisionsInParallel(num_threads,pool,q,res);
+  computeCollisionsInParallel(num_threads,pool,q,res_stop,true);
+
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+  {
+    const bool res_ref = computeCollisions(model,data,geom_model,geom_data,q.col(i));
+    BOOST_CHECK(res[i] == res_ref);
+    BOOST_CHECK(res_stop[i] == res_ref);
+  }
+
+  // Wrong arguments
+  BOOST_CHECK_THROW(computeCollisionsInParallel(pool.size()+1,pool,q,res),std::invalid_argument);
+  VectorXb res_wrong(batch_size-1);
+  BOOST_CHECK_THROW(computeCollisionsInParallel(num_threads,pool,q,res_wrong),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/algorithm/parallel/rnea.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
+
+BOOST_AUTO_TEST_CASE(test_parallel_rnea)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+  
+  Model model; buildModels::humanoidRandom(model);
+  Data data_ref(model);
+  
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  
+  const Eigen::DenseIndex batch_size = 128;
+  const size_t num_threads = (size_t)omp_get_max_threads();
+  
+  MatrixXd q(model.nq,batch_size);
+  MatrixXd v(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd a(MatrixXd::Random(model.nv,batch_size));
+  MatrixXd tau(MatrixXd::Zero(model.nv,batch_size));
+  
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+    q.col(i) = randomConfiguration(model);
+  
+  ModelPool pool(model,num_threads);
+  BOOST_CHECK(pool.size() == num_threads);
+  
+  rneaInParallel(num_threads,pool,q,v,a,tau);
+  
+  for(Eigen::DenseIndex i = 0; i < batch_size; ++i)
+  {
+    rnea(model,data_ref,q.col(i),v.col(i),a.col(i));
+    BOOST_CHECK(tau.col(i) == data_ref.tau);
+  }
+  
+  // Same result with a pool larger than the number of threads
+  MatrixXd tau_single(MatrixXd::Zero(model.nv,batch_size));
+  pool.resize(num_threads+2);
+  BOOST_CHECK(pool.size() == num_threads+2);
+  rneaInParallel(1,pool,q,v,a,tau_single);
+  BOOST_CHECK(tau_single == tau);
+  
+  // Wrong arguments
+  BOOST_CHECK_THROW(rneaInParallel(pool.size()+1,pool,q,v,a,tau),std::invalid_argument);
+  MatrixXd tau_wrong(MatrixXd::Zero(model.nv,batch_size-1));
+  BOOST_CHECK_THROW(rneaInParallel(num_threads,pool,q,v,a,tau_wrong),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/multibody/pool/model.hpp"
+#include "pinocchio/multibody/pool/geometry.hpp"
+#include "pinocchio/algorithm/kinematics.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
+
+using namespace pinocchio;
+
+BOOST_AUTO_TEST_CASE(test_model_pool)
+{
+  Model model; buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  
+  const size_t pool_size = 4;
+  ModelPool pool(model,pool_size);
+  
+  BOOST_CHECK(pool.size() == pool_size);
+  BOOST_CHECK(pool.datas().size() == pool_size);
+  BOOST_CHECK(pool.model() == model);
+  for(size_t k = 0; k < pool.size(); ++k)
+    BOOST_CHECK(pool.data(k) == Data(model));
+  BOOST_CHECK_THROW(pool.data(pool_size),std::invalid_argument);
+  
+  // Update the data of the pool
+  Data data(model);
+  forwardKinematics(model,data,randomConfiguration(model));
+  pool.update(data);
+  for(size_t k = 0; k < pool.size(); ++k)
+    BOOST_CHECK(pool.data(k) == data);
+  
+  // Resize the pool
+  pool.resize(pool_size+2);
+  BOOST_CHECK(pool.size() == pool_size+2);
+  BOOST_CHECK(pool.data(pool_size-1) == data);
+  BOOST_CHECK(pool.data(pool_size+1) == Data(model));
+  
+  pool.resize(1);
+  BOOST_CHECK(pool.size() == 1);
+  BOOST_CHECK(pool.data(0) == data);
+  
+  // Update the model of the pool
+  Model model_new(model);
+  buildModels::humanoidRandom(model_new);
+  pool.resize(pool_size);
+  pool.update(model_new);
+  BOOST_CHECK(pool.model() == model_new);
+  for(size_t k = 0; k < pool.size(); ++k)
+    BOOST_CHECK(pool.data(k).oMi.size() == (size_t)model_new.njoints);
+}
+
+BOOST_AUTO_TEST_CASE(test_geometry_pool)
+{
+  Model model; buildModels::humanoidRandom(model);
+  GeometryModel geometry_model;
+  GeometryObject geometry_object("obj",0,1,boost::shared_ptr<fcl::CollisionGeometry>(),SE3::Random());
+  geometry_model.addGeometryObject(geometry_object);
+  
+  const size_t pool_size = 3;
+  GeometryPool pool(model,geometry_model,pool_size);
+  
+  BOOST_CHECK(pool.size() == pool_size);
+  BOOST_CHECK(pool.geometry_datas().size() == pool_size);
+  BOOST_CHECK(pool.geometry_model() == geometry_model);
+  BOOST_CHECK_THROW(pool.geometry_data(pool_size),std::invalid_argument);
+  
+  // Resizing the pool also resizes the geometry data
+  pool.resize(pool_size+1);
+  BOOST_CHECK(pool.datas().size() == pool_size+1);
+  BOOST_CHECK(pool.geometry_datas().size() == pool_size+1);
+  
+  pool.resize(1);
+  BOOST_CHECK(pool.datas().size() == 1);
+  BOOST_CHECK(pool.geometry_datas().size() == 1);
+  
+  // Update the geometry model
+  geometry_model.addGeometryObject(geometry_object);
+  pool.update(geometry_model);
+  BOOST_CHECK(pool.geometry_model() == geometry_model);
+  BOOST_CHECK(pool.geometry_data(0).oMg.size() == geometry_model.ngeoms);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -1,5 +1,6 @@
 import unittest
 import pinocchio as pin
+import numpy as np
 
 from test_case import PinocchioTestCase as TestCase
 
@@ -52,5 +53,33 @@ class TestData(TestCase):
 
         self.assertTrue(data == data_copy)
 
+    def test_allocation(self):
+        model = self.model
+        data = pin.Data(model,pin.ALLOCATE_NONE)
+        self.assertFalse(data.isAllocated(pin.ALLOCATE_DERIVATIVES))
+        self.assertTrue(data.memoryFootprint().total() < self.data.memoryFootprint().total())
+
+        q = pin.randomConfiguration(model)
+        v = np.random.rand(model.nv)
+        a = np.random.rand(model.nv)
+        pin.computeRNEADerivatives(model,data,q,v,a)
+        self.assertTrue(data.isAllocated(pin.ALLOCATE_DERIVATIVES))
+        self.assertEqual(data.dtau_dq.shape,(model.nv,model.nv))
+
+        data.release(pin.ALLOCATE_DERIVATIVES)
+        self.assertFalse(data.isAllocated(pin.ALLOCATE_DERIVATIVES))
+
+    def test_arena(self):
+        model = self.model
+        data = pin.Data(model,pin.ALLOCATE_ALL,True)
+        self.assertTrue(data.usesArena())
+        self.assertFalse(self.data.usesArena())
+        self.assertTrue(data == self.data)
+
+        q = pin.randomConfiguration(model)
+        pin.forwardKinematics(model,data,q)
+        pin.forwardKinematics(model,self.data,q)
+        self.assertTrue(data.oMi[model.njoints-1].isApprox(self.data.oMi[model.njoints-1]))
+
 if __name__ == '__main__':
     unittest.main()
@@ -16,6 +16,13 @@ class TestModel(TestCase):
         self.assertEqual(model.nv, 0)
         model.name = "empty_model"
 
+    def test_memory_footprint(self):
+        footprint = self.model.memoryFootprint()
+        self.assertTrue(footprint["supports"] > 0)
+        self.assertEqual(footprint["unknown_field"], 0)
+        self.assertEqual(footprint.total(), footprint.base + sum(footprint.fields.values()))
+        self.assertTrue(len(str(footprint)) > 0)
+
     def test_add_joint(self):
         model = pin.Model()
         idx = 0
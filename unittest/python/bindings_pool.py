@@ -0,0 +1,41 @@
+import unittest
+import pinocchio as pin
+
+from test_case import PinocchioTestCase as TestCase
+
+class TestPool(TestCase):
+    def setUp(self):
+        self.model = pin.buildSampleModelHumanoidRandom()
+        self.geometry_model = pin.GeometryModel()
+
+    def test_model_pool(self):
+        pool = pin.ModelPool(self.model,4)
+        self.assertEqual(pool.size(),4)
+        self.assertTrue(pool.model() == self.model)
+
+        data = self.model.createData()
+        q = pin.neutral(self.model)
+        pin.forwardKinematics(self.model,data,q)
+        pool.update(data)
+        for k in range(pool.size()):
+            self.assertTrue(pool.data(k) == data)
+
+        pool.resize(2)
+        self.assertEqual(pool.size(),2)
+
+        pool_copy = pool.copy()
+        self.assertEqual(pool_copy.size(),2)
+
+    def test_geometry_pool(self):
+        pool = pin.GeometryPool(self.model,self.geometry_model,3)
+        self.assertEqual(pool.size(),3)
+        self.assertTrue(pool.model() == self.model)
+        self.assertTrue(pool.geometry_model() == self.geometry_model)
+
+        pool.resize(5)
+        self.assertEqual(pool.size(),5)
+        geometry_data = pool.geometry_data(4)
+        self.assertEqual(len(geometry_data.oMg),0)
+
+if __name__ == '__main__':
+    unittest.main()
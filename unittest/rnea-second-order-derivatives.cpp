@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/multibody/model.hpp"
+#include "pinocchio/multibody/data.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/algorithm/rnea-derivatives.hpp"
+#include "pinocchio/algorithm/rnea-second-order-derivatives.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+using namespace pinocchio;
+
+typedef Data::Tensor3x Tensor3x;
+
+/// \brief Store the derivative of a first order derivative with respect to the k-th variable into the slice k of a tensor.
+static void setSlice(Tensor3x & tensor, const Eigen::DenseIndex k, const Eigen::MatrixXd & slice)
+{
+  const Eigen::DenseIndex nv = slice.rows();
+  Eigen::Map<Eigen::MatrixXd>(tensor.data() + k*nv*nv,nv,nv) = slice;
+}
+
+static bool isApprox(const Tensor3x & t1, const Tensor3x & t2, const double prec)
+{
+  const Eigen::DenseIndex nv = t1.dimension(0);
+  Eigen::Map<const Eigen::MatrixXd> m1(t1.data(),nv,nv*nv), m2(t2.data(),nv,nv*nv);
+  return (m1-m2).lpNorm<Eigen::Infinity>() <= prec * std::max(1.,m2.lpNorm<Eigen::Infinity>());
+}
+
+static void firstOrderDerivatives(const Model & model, Data & data,
+                                  const Eigen::VectorXd & q, const Eigen::VectorXd & v, const Eigen::VectorXd & a,
+                                  Eigen::MatrixXd & dtau_dq, Eigen::MatrixXd & dtau_dv, Eigen::MatrixXd & dtau_da)
+{
+  dtau_dq.setZero(); dtau_dv.setZero(); dtau_da.setZero();
+  computeRNEADerivatives(model,data,q,v,a,dtau_dq,dtau_dv,dtau_da);
+  dtau_da.triangularView<Eigen::StrictlyLower>() = dtau_da.transpose().triangularView<Eigen::StrictlyLower>();
+}
+
+/// \brief Compare the analytical second order derivatives to the central finite differences of the first order ones.
+static void checkSecondOrderDerivatives(const Model & model)
+{
+  using namespace Eigen;
+
+  Data data(model), data_fd(model);
+
+  const VectorXd q = randomConfiguration(model);
+  const VectorXd v = VectorXd::Random(model.nv);
+  const VectorXd a = VectorXd::Random(model.nv);
+
+  const Eigen::DenseIndex nv = model.nv;
+  Tensor3x d2tau_dqdq(nv,nv,nv), d2tau_dvdv(nv,nv,nv), d2tau_dqdv(nv,nv,nv), d2tau_dadq(nv,nv,nv);
+  computeRNEASecondOrderDerivatives(model,data,q,v,a,d2tau_dqdq,d2tau_dvdv,d2tau_dqdv,d2tau_dadq);
+
+  Tensor3x d2tau_dqdq_fd(nv,nv,nv), d2tau_dvdv_fd(nv,nv,nv), d2tau_dqdv_fd(nv,nv,nv), d2tau_dadq_fd(nv,nv,nv);
+  MatrixXd dtau_dq_plus(nv,nv), dtau_dv_plus(nv,nv), dtau_da_plus(nv,nv);
+  MatrixXd dtau_dq_minus(nv,nv), dtau_dv_minus(nv,nv), dtau_da_minus(nv,nv);
+
+  const double alpha = 1e-5;
+  VectorXd v_eps(VectorXd::Zero(nv));
+  for(Eigen::DenseIndex k = 0; k < nv; ++k)
+  {
+    v_eps[k] = alpha;
+    firstOrderDerivatives(model,data_fd,integrate(model,q,v_eps),v,a,dtau_dq_plus,dtau_dv_plus,dtau_da_plus);
+    firstOrderDerivatives(model,data_fd,integrate(model,q,-v_eps),v,a,dtau_dq_minus,dtau_dv_minus,dtau_da_minus);
+    setSlice(d2tau_dqdq_fd,k,(dtau_dq_plus - dtau_dq_minus)/(2.*alpha));
+    setSlice(d2tau_dadq_fd,k,(dtau_da_plus - dtau_da_minus)/(2.*alpha));
+
+    firstOrderDerivatives(model,data_fd,q,v + v_eps,a,dtau_dq_plus,dtau_dv_plus,dtau_da_plus);
+    firstOrderDerivatives(model,data_fd,q,v - v_eps,a,dtau_dq_minus,dtau_dv_minus,dtau_da_minus);
+    setSlice(d2tau_dqdv_fd,k,(dtau_dq_plus - dtau_dq_minus)/(2.*alpha));
+    setSlice(d2tau_dvdv_fd,k,(dtau_dv_plus - dtau_dv_minus)/(2.*alpha));
+    v_eps[k] = 0.;
+  }
+
+  BOOST_CHECK(isApprox(d2tau_dqdq,d2tau_dqdq_fd,sqrt(alpha)));
+  BOOST_CHECK(isApprox(d2tau_dvdv,d2tau_dvdv_fd,sqrt(alpha)));
+  BOOST_CHECK(isApprox(d2tau_dqdv,d2tau_dqdv_fd,sqrt(alpha)));
+  BOOST_CHECK(isApprox(d2tau_dadq,d2tau_dadq_fd,sqrt(alpha)));
+}
+
+BOOST_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(test_rnea_second_order_derivatives)
+{
+  Model model;
+  buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+
+  checkSecondOrderDerivatives(model);
+}
+
+BOOST_AUTO_TEST_CASE(test_rnea_second_order_derivatives_joints)
+{
+  using namespace Eigen;
+
+  Model model;
+  JointIndex parent = 0;
+
+  parent = model.addJoint(parent,JointModelPlanar(),SE3::Random(),"planar");
+  model.appendBodyToJoint(parent,Inertia::Random());
+  parent = model.addJoint(parent,JointModelSpherical(),SE3::Random(),"spherical");
+  model.appendBodyToJoint(parent,Inertia::Random());
+  const JointIndex branch = parent;
+  parent = model.addJoint(parent,JointModelRevoluteUnaligned(Vector3d::Random().normalized()),SE3::Random(),"revolute");
+  model.appendBodyToJoint(parent,Inertia::Random());
+  parent = model.addJoint(parent,JointModelTranslation(),SE3::Random(),"translation");
+  model.appendBodyToJoint(parent,Inertia::Random());
+  parent = model.addJoint(branch,JointModelPrismaticUnaligned(Vector3d::Random().normalized()),SE3::Random(),"prismatic");
+  model.appendBodyToJoint(parent,Inertia::Random());
+  parent = model.addJoint(parent,JointModelRUBX(),SE3::Random(),"revolute_unbounded");
+  model.appendBodyToJoint(parent,Inertia::Random());
+
+  model.lowerPositionLimit.fill(-1.);
+  model.upperPositionLimit.fill(1.);
+
+  checkSecondOrderDerivatives(model);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,8 @@
 
 #include "pinocchio/multibody/data.hpp"
 #include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/algorithm/frames.hpp"
+#include "pinocchio/algorithm/rnea.hpp"
 
 #include "pinocchio/serialization/archive.hpp"
 
@@ -15,6 +17,8 @@
 #include "pinocchio/serialization/joints.hpp"
 #include "pinocchio/serialization/model.hpp"
 #include "pinocchio/serialization/data.hpp"
+#include "pinocchio/serialization/flat-binary.hpp"
+#include "pinocchio/serialization/trajectory-log.hpp"
 
 #include "pinocchio/parsers/sample-models.hpp"
 
@@ -635,4 +639,473 @@ BOOST_AUTO_TEST_CASE(test_data_serialization)
   generic_test(data,TEST_SERIALIZATION_FOLDER"/Data","Data");
 }
 
+BOOST_AUTO_TEST_CASE(test_model_flat_binary_serialization)
+{
+  using namespace pinocchio;
+
+  Model model;
+  buildModels::humanoidRandom(model);
+  model.referenceConfigurations.insert(std::make_pair("neutral",neutral(model)));
+
+  const std::string filename = TEST_SERIALIZATION_FOLDER"/model.flat";
+  serialization::saveToFlatBinary(model,filename);
+
+  Model model_loaded;
+  serialization::loadFromFlatBinary(model_loaded,filename);
+  BOOST_CHECK(model_loaded == model);
+
+  std::string buffer;
+  serialization::saveToFlatBinaryBuffer(model,buffer);
+  Model model_from_buffer;
+  serialization::loadFromFlatBinaryBuffer(model_from_buffer,buffer.data(),buffer.size());
+  BOOST_CHECK(model_from_buffer == model);
+
+  // truncated buffer
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(model_loaded,buffer.data(),buffer.size()/2),
+                    std::invalid_argument);
+
+  // unsupported version
+  std::string wrong_version(buffer);
+  wrong_version[8] = (char)(serialization::FlatBinaryFormat::VERSION + 1);
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(model_loaded,wrong_version.data(),wrong_version.size()),
+                    std::invalid_argument);
+
+  // counts which do not match the loaded arrays: nq (after the 24 bytes of the header), then njoints
+  std::string wrong_nq(buffer);
+  const boost::int32_t nq = model.nq + 1;
+  std::memcpy(&wrong_nq[24],&nq,sizeof(nq));
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(model_loaded,wrong_nq.data(),wrong_nq.size()),
+                    std::invalid_argument);
+
+  std::string wrong_njoints(buffer);
+  const boost::int32_t njoints = model.njoints - 1;
+  std::memcpy(&wrong_njoints[32],&njoints,sizeof(njoints));
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(model_loaded,wrong_njoints.data(),wrong_njoints.size()),
+                    std::invalid_argument);
+
+  // a rejected buffer leaves the model unchanged
+  BOOST_CHECK(model_loaded == model);
+
+  // a number of strings larger than what the buffer can hold
+  std::string wrong_strings;
+  serialization::details::FlatBinaryWriter writer(wrong_strings);
+  writer.write<boost::uint64_t>(boost::uint64_t(1) << 60);
+  writer.writeString("name");
+  serialization::details::FlatBinaryReader reader(wrong_strings.data(),wrong_strings.size());
+  std::vector<std::string> strings;
+  BOOST_CHECK_THROW(reader.readStrings(strings),std::invalid_argument);
+
+  // not a model
+  GeometryModel geom_model;
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(geom_model,buffer.data(),buffer.size()),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinary(model_loaded,"this_is_a_fake_filename.flat"),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_model_flat_binary_joints)
+{
+  using namespace pinocchio;
+
+  // All the kinds of joints, including composite joints (nested) and mimic joints
+  Model model;
+  JointIndex parent = model.addJoint(0,JointModelFreeFlyer(),SE3::Random(),"freeflyer");
+  parent = model.addJoint(parent,JointModelRevoluteUnaligned(SE3::Vector3(0,0,1)),SE3::Random(),"revolute_unaligned");
+  parent = model.addJoint(parent,JointModelRevoluteUnboundedUnaligned(SE3::Vector3(1,0,0)),SE3::Random(),"revolute_unbounded_unaligned");
+  parent = model.addJoint(parent,JointModelPrismaticUnaligned(SE3::Vector3(0,1,0)),SE3::Random(),"prismatic_unaligned");
+  const JointIndex ry = model.addJoint(parent,JointModelRY(),SE3::Random(),"ry");
+  JointModelRY ry_reference;
+  ry_reference.setIndexes(ry,model.idx_qs[ry],model.idx_vs[ry]);
+  parent = model.addJoint(ry,JointModelMimic<JointModelRY>(ry_reference,2.,0.5),SE3::Random(),"mimic");
+
+  JointModelComposite nested_composite(JointModelPX(),SE3::Random());
+  nested_composite.addJoint(JointModelRUBZ(),SE3::Random());
+  JointModelComposite composite(JointModelSpherical(),SE3::Random());
+  composite.addJoint(nested_composite,SE3::Random());
+  composite.addJoint(JointModelPlanar(),SE3::Random());
+  parent = model.addJoint(parent,composite,SE3::Random(),"composite");
+  model.addJoint(parent,JointModelTranslation(),SE3::Random(),"translation");
+  for(JointIndex k = 1; k < (JointIndex)model.njoints; ++k)
+    model.addJointFrame(k);
+
+  std::string buffer;
+  serialization::saveToFlatBinaryBuffer(model,buffer);
+  Model model_loaded;
+  serialization::loadFromFlatBinaryBuffer(model_loaded,buffer.data(),buffer.size());
+  BOOST_CHECK(model_loaded == model);
+
+  // a joint whose indexes do not match the ones of the model
+  Model model_wrong(model);
+  model_wrong.joints[2].setIndexes(2,model.idx_qs[2]+1,model.idx_vs[2]);
+  serialization::saveToFlatBinaryBuffer(model_wrong,buffer);
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(model_loaded,buffer.data(),buffer.size()),
+                    std::invalid_argument);
+
+  // a frame of an unknown type
+  model_wrong = model;
+  model_wrong.frames[1].type = (FrameType)(JOINT | BODY);
+  serialization::saveToFlatBinaryBuffer(model_wrong,buffer);
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(model_loaded,buffer.data(),buffer.size()),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_geometry_model_flat_binary_serialization)
+{
+  using namespace pinocchio;
+
+  Model model;
+  buildModels::humanoidRandom(model);
+
+  GeometryModel geom_model;
+  for(FrameIndex i = 1; i < (FrameIndex)model.nframes; i += 4)
+  {
+    const Frame & frame = model.frames[i];
+    geom_model.addGeometryObject(GeometryObject(frame.name + "_geom",i,frame.parent,
+                                                GeometryObject::CollisionGeometryPtr(),
+                                                SE3::Random(),"mesh_" + frame.name + ".dae",
+                                                Eigen::Vector3d::Random(),i % 2 == 0,
+                                                Eigen::Vector4d::Random(),"texture.png"));
+  }
+  geom_model.addAllCollisionPairs();
+
+  const std::string filename = TEST_SERIALIZATION_FOLDER"/geom_model.flat";
+  serialization::saveToFlatBinary(geom_model,filename);
+
+  GeometryModel geom_model_loaded;
+  serialization::loadFromFlatBinary(geom_model_loaded,filename);
+  BOOST_CHECK(geom_model_loaded == geom_model);
+
+  // a collision pair referring to a geometry which does not exist
+  geom_model.collisionPairs.push_back(CollisionPair(0,geom_model.ngeoms));
+  std::string buffer;
+  serialization::saveToFlatBinaryBuffer(geom_model,buffer);
+  BOOST_CHECK_THROW(serialization::loadFromFlatBinaryBuffer(geom_model_loaded,buffer.data(),buffer.size()),
+                    std::invalid_argument);
+  geom_model.collisionPairs.pop_back();
+  BOOST_CHECK(geom_model_loaded == geom_model);
+}
+
+BOOST_AUTO_TEST_CASE(test_trajectory_log)
+{
+  using namespace pinocchio;
+  using namespace pinocchio::serialization;
+
+  Model model;
+  buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+
+  const int fields = TrajectoryLogField::Q | TrajectoryLogField::V | TrajectoryLogField::TAU
+                   | TrajectoryLogField::OMF | TrajectoryLogField::LAMBDA_C;
+  const int contact_dim = 12;
+  const std::size_t num_samples = 25;
+  const std::string filename = TEST_SERIALIZATION_FOLDER"/trajectory.log";
+
+  std::vector<Eigen::VectorXd> qs, vs, lambdas;
+  PINOCCHIO_ALIGNED_STD_VECTOR(Data) datas;
+  {
+    TrajectoryLogWriter writer(model,filename,fields,contact_dim,10);
+    for(std::size_t k = 0; k < num_samples; ++k)
+    {
+      qs.push_back(randomConfiguration(model));
+      vs.push_back(Eigen::VectorXd::Random(model.nv));
+      Data data(model);
+      rnea(model,data,qs.back(),vs.back(),Eigen::VectorXd::Random(model.nv));
+      updateFramePlacements(model,data);
+      data.lambda_c = Eigen::VectorXd::Random(contact_dim);
+      datas.push_back(data);
+
+      writer.append(0.001 * (double)k,qs.back(),vs.back(),data);
+    }
+    BOOST_CHECK(writer.size() == num_samples);
+
+    // A Data of the wrong dimensions is rejected before being packed
+    Data data_wrong(datas.back());
+    data_wrong.tau.resize(model.nv+1);
+    BOOST_CHECK_THROW(writer.append(1.,qs.back(),vs.back(),data_wrong),std::invalid_argument);
+    data_wrong = datas.back();
+    data_wrong.oMf.push_back(SE3::Identity());
+    BOOST_CHECK_THROW(writer.append(1.,qs.back(),vs.back(),data_wrong),std::invalid_argument);
+    data_wrong = datas.back();
+    data_wrong.lambda_c.resize(contact_dim+6);
+    BOOST_CHECK_THROW(writer.append(1.,qs.back(),vs.back(),data_wrong),std::invalid_argument);
+    BOOST_CHECK(writer.size() == num_samples);
+  }
+
+  {
+    // All the fields, with a Data built for another model
+    Model other_model;
+    buildModels::manipulator(other_model);
+    Data other_data(other_model);
+    const int all_fields = fields | TrajectoryLogField::DDQ | TrajectoryLogField::OMI;
+    TrajectoryLogWriter writer(model,TEST_SERIALIZATION_FOLDER"/trajectory_wrong.log",all_fields,contact_dim,10);
+    BOOST_CHECK_THROW(writer.append(0.,qs.back(),vs.back(),other_data),std::invalid_argument);
+    Data data(datas.back());
+    data.ddq.resize(0);
+    BOOST_CHECK_THROW(writer.append(0.,qs.back(),vs.back(),data),std::invalid_argument);
+    data = datas.back();
+    data.oMi.pop_back();
+    BOOST_CHECK_THROW(writer.append(0.,qs.back(),vs.back(),data),std::invalid_argument);
+    data = datas.back();
+    data.ddq.setZero(model.nv);
+    writer.append(0.,qs.back(),vs.back(),data);
+    BOOST_CHECK(writer.size() == 1);
+  }
+
+  TrajectoryLogReader reader(filename);
+  BOOST_CHECK(reader.size() == num_samples);
+  BOOST_CHECK(reader.getFields() == fields);
+  BOOST_CHECK(reader.hasField(TrajectoryLogField::OMF));
+  BOOST_CHECK(!reader.hasField(TrajectoryLogField::OMI));
+
+  // random access, across the chunks
+  const std::size_t order[] = {24, 3, 17, 0, 10, 9, 20};
+  for(std::size_t i = 0; i < sizeof(order)/sizeof(order[0]); ++i)
+  {
+    const std::size_t k = order[i];
+    double time;
+    Eigen::VectorXd q(model.nq), v(model.nv);
+    Data data(model);
+    reader.read(k,time,q,v,data);
+
+    BOOST_CHECK(time == 0.001 * (double)k);
+    BOOST_CHECK(q == qs[k]);
+    BOOST_CHECK(v == vs[k]);
+    BOOST_CHECK(data.tau == datas[k].tau);
+    BOOST_CHECK(data.lambda_c == datas[k].lambda_c);
+    for(FrameIndex i = 0; i < (FrameIndex)model.nframes; ++i)
+      BOOST_CHECK(data.oMf[i] == datas[k].oMf[i]);
+  }
+
+  BOOST_CHECK(reader.find(0.0125) == 12);
+  BOOST_CHECK(reader.find(-1.) == 0);
+  BOOST_CHECK(reader.find(1.) == num_samples-1);
+
+  // a log which has not been closed is read up to its last complete chunk
+  {
+    std::ifstream ifs(filename.c_str(),std::ios::binary);
+    std::ostringstream content; content << ifs.rdbuf();
+    std::string truncated = content.str();
+    truncated.replace(TrajectoryLogFormat::INDEX_POSITION_OFFSET,8,8,'\0');
+    const std::size_t chunk_bytes = TrajectoryLogFormat::chunkHeaderSize<double>()
+                                  + 10 * (1 + (std::size_t)(model.nq + 2*model.nv + 12*model.nframes + contact_dim)) * sizeof(double);
+    truncated.resize(TrajectoryLogFormat::HEADER_SIZE + 2 * chunk_bytes + 100);
+
+    const std::string truncated_filename = TEST_SERIALIZATION_FOLDER"/trajectory_truncated.log";
+    std::ofstream ofs(truncated_filename.c_str(),std::ios::binary);
+    ofs << truncated;
+    ofs.close();
+
+    TrajectoryLogReader truncated_reader(truncated_filename);
+    BOOST_CHECK(truncated_reader.size() == 20);
+  }
+
+  std::string content;
+  {
+    std::ifstream ifs(filename.c_str(),std::ios::binary);
+    std::ostringstream oss; oss << ifs.rdbuf();
+    content = oss.str();
+  }
+  const std::size_t sample_bytes = (1 + (std::size_t)(model.nq + 2*model.nv + 12*model.nframes + contact_dim)) * sizeof(double);
+
+  // a log written with another byte order is rejected
+  {
+    std::string swapped(content);
+    std::reverse(swapped.begin() + 8,swapped.begin() + 12);
+
+    const std::string swapped_filename = TEST_SERIALIZATION_FOLDER"/trajectory_swapped.log";
+    std::ofstream ofs(swapped_filename.c_str(),std::ios::binary);
+    ofs << swapped;
+    ofs.close();
+
+    BOOST_CHECK_THROW(TrajectoryLogReader reader(swapped_filename),std::invalid_argument);
+  }
+
+  // a chunk which fails to load does not corrupt the chunk previously loaded
+  {
+    std::string corrupted(content);
+    const std::size_t chunk_position = TrajectoryLogFormat::HEADER_SIZE + TrajectoryLogFormat::chunkHeaderSize<double>() + 10 * sample_bytes;
+    const boost::uint32_t num_samples_corrupted = 1000;
+    const boost::uint64_t num_bytes_corrupted = num_samples_corrupted * sample_bytes;
+    corrupted.replace(chunk_position + 4,4,reinterpret_cast<const char *>(&num_samples_corrupted),4);
+    corrupted.replace(chunk_position + 8,8,reinterpret_cast<const char *>(&num_bytes_corrupted),8);
+
+    const std::string corrupted_filename = TEST_SERIALIZATION_FOLDER"/trajectory_corrupted.log";
+    std::ofstream ofs(corrupted_filename.c_str(),std::ios::binary);
+    ofs << corrupted;
+    ofs.close();
+
+    TrajectoryLogReader corrupted_reader(corrupted_filename);
+    double time;
+    Eigen::VectorXd q(model.nq), v(model.nv);
+    Data data(model);
+    corrupted_reader.read(3,time,q,v,data);
+    BOOST_CHECK_THROW(corrupted_reader.read(15,time,q,v,data),std::invalid_argument);
+    corrupted_reader.read(3,time,q,v,data);
+    BOOST_CHECK(time == 0.001 * 3.);
+    BOOST_CHECK(q == qs[3]);
+  }
+
+  // a chunk without samples is rejected
+  {
+    std::string corrupted(content);
+    const std::size_t chunk_position = TrajectoryLogFormat::HEADER_SIZE;
+    const boost::uint32_t num_samples_corrupted = 0;
+    const boost::uint64_t num_bytes_corrupted = 0;
+    corrupted.replace(chunk_position + 4,4,reinterpret_cast<const char *>(&num_samples_corrupted),4);
+    corrupted.replace(chunk_position + 8,8,reinterpret_cast<const char *>(&num_bytes_corrupted),8);
+
+    const std::string corrupted_filename = TEST_SERIALIZATION_FOLDER"/trajectory_empty_chunk.log";
+    std::ofstream ofs(corrupted_filename.c_str(),std::ios::binary);
+    ofs << corrupted;
+    ofs.close();
+
+    TrajectoryLogReader corrupted_reader(corrupted_filename);
+    double time;
+    Eigen::VectorXd q(model.nq), v(model.nv);
+    Data data(model);
+    BOOST_CHECK_THROW(corrupted_reader.read(3,time,q,v,data),std::invalid_argument);
+  }
+
+  // an index which does not fit in the file is rejected
+  {
+    boost::uint64_t index_position;
+    std::memcpy(&index_position,content.data() + TrajectoryLogFormat::INDEX_POSITION_OFFSET,8);
+
+    std::string corrupted(content);
+    const boost::uint64_t num_chunks_corrupted = (boost::uint64_t)1 << 40;
+    corrupted.replace((std::size_t)index_position,8,reinterpret_cast<const char *>(&num_chunks_corrupted),8);
+    const std::string corrupted_filename = TEST_SERIALIZATION_FOLDER"/trajectory_corrupted_index.log";
+    {
+      std::ofstream ofs(corrupted_filename.c_str(),std::ios::binary);
+      ofs << corrupted;
+    }
+    BOOST_CHECK_THROW(TrajectoryLogReader reader(corrupted_filename),std::invalid_argument);
+
+    corrupted = content;
+    const boost::uint64_t chunk_position_corrupted = content.size();
+    corrupted.replace((std::size_t)index_position + 8,8,reinterpret_cast<const char *>(&chunk_position_corrupted),8);
+    {
+      std::ofstream ofs(corrupted_filename.c_str(),std::ios::binary);
+      ofs << corrupted;
+    }
+    BOOST_CHECK_THROW(TrajectoryLogReader reader(corrupted_filename),std::invalid_argument);
+
+    corrupted = content;
+    const boost::uint64_t index_position_corrupted = content.size();
+    corrupted.replace(TrajectoryLogFormat::INDEX_POSITION_OFFSET,8,reinterpret_cast<const char *>(&index_position_corrupted),8);
+    {
+      std::ofstream ofs(corrupted_filename.c_str(),std::ios::binary);
+      ofs << corrupted;
+    }
+    BOOST_CHECK_THROW(TrajectoryLogReader reader(corrupted_filename),std::invalid_argument);
+  }
+
+  BOOST_CHECK_THROW(TrajectoryLogReader("this_is_a_fake_filename.log"),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_trajectory_log_compression)
+{
+  using namespace pinocchio;
+  using namespace pinocchio::serialization;
+
+  Model model;
+  buildModels::humanoidRandom(model);
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+
+  const int fields = TrajectoryLogField::Q | TrajectoryLogField::V | TrajectoryLogField::OMI;
+  const std::string filename = TEST_SERIALIZATION_FOLDER"/trajectory_zlib.log";
+
+#ifdef PINOCCHIO_WITH_ZLIB
+  const std::size_t num_samples = 25;
+  std::vector<Eigen::VectorXd> qs;
+  PINOCCHIO_ALIGNED_STD_VECTOR(Data) datas;
+  const Eigen::VectorXd v = Eigen::VectorXd::Zero(model.nv);
+  {
+    TrajectoryLogWriter writer(model,filename,fields,0,10,TrajectoryLogFormat::ZLIB);
+    for(std::size_t k = 0; k < num_samples; ++k)
+    {
+      // a slowly moving robot, as in a real log
+      qs.push_back(k < 10 ? neutral(model) : randomConfiguration(model));
+      Data data(model);
+      forwardKinematics(model,data,qs.back());
+      datas.push_back(data);
+      writer.append(0.001 * (double)k,qs.back(),v,data);
+    }
+  }
+
+  const std::size_t sample_bytes = (1 + (std::size_t)(model.nq + model.nv + 12*model.njoints)) * sizeof(double);
+  std::string content;
+  {
+    std::ifstream ifs(filename.c_str(),std::ios::binary);
+    std::ostringstream oss; oss << ifs.rdbuf();
+    content = oss.str();
+  }
+  BOOST_CHECK(content.size() < TrajectoryLogFormat::HEADER_SIZE + num_samples * sample_bytes);
+
+  {
+    TrajectoryLogReader reader(filename);
+    BOOST_CHECK(reader.size() == num_samples);
+    const std::size_t order[] = {24, 3, 17, 0, 10, 9, 20};
+    for(std::size_t i = 0; i < sizeof(order)/sizeof(order[0]); ++i)
+    {
+      const std::size_t k = order[i];
+      double time;
+      Eigen::VectorXd q(model.nq), v_read(model.nv);
+      Data data(model);
+      reader.read(k,time,q,v_read,data);
+
+      BOOST_CHECK(time == 0.001 * (double)k);
+      BOOST_CHECK(q == qs[k]);
+      BOOST_CHECK(v_read == v);
+      for(JointIndex i = 0; i < (JointIndex)model.njoints; ++i)
+        BOOST_CHECK(data.oMi[i] == datas[k].oMi[i]);
+    }
+  }
+
+  // the index of a compressed log which has not been closed is rebuilt from the headers of its chunks
+  {
+    std::string unclosed(content);
+    unclosed.replace(TrajectoryLogFormat::INDEX_POSITION_OFFSET,8,8,'\0');
+
+    const std::string unclosed_filename = TEST_SERIALIZATION_FOLDER"/trajectory_zlib_unclosed.log";
+    {
+      std::ofstream ofs(unclosed_filename.c_str(),std::ios::binary);
+      ofs << unclosed;
+    }
+    TrajectoryLogReader reader(filename), unclosed_reader(unclosed_filename);
+    BOOST_CHECK(unclosed_reader.size() == num_samples);
+    BOOST_CHECK(unclosed_reader.find(0.0125) == 12);
+    BOOST_CHECK(unclosed_reader.find(0.0125) == reader.find(0.0125));
+    BOOST_CHECK(unclosed_reader.find(0.0205) == 20);
+    BOOST_CHECK(unclosed_reader.find(-1.) == 0);
+    BOOST_CHECK(unclosed_reader.find(1.) == num_samples-1);
+  }
+
+  // corrupted compressed samples are rejected
+  {
+    std::string corrupted(content);
+    const std::size_t data_position = TrajectoryLogFormat::HEADER_SIZE + TrajectoryLogFormat::chunkHeaderSize<double>();
+    for(std::size_t k = 2; k < 10; ++k)
+      corrupted[data_position + k] = (char)~corrupted[data_position + k];
+
+    const std::string corrupted_filename = TEST_SERIALIZATION_FOLDER"/trajectory_zlib_corrupted.log";
+    {
+      std::ofstream ofs(corrupted_filename.c_str(),std::ios::binary);
+      ofs << corrupted;
+    }
+    TrajectoryLogReader reader(corrupted_filename);
+    double time;
+    Eigen::VectorXd q(model.nq), v_read(model.nv);
+    Data data(model);
+    BOOST_CHECK_THROW(reader.read(0,time,q,v_read,data),std::invalid_argument);
+    reader.read(15,time,q,v_read,data);
+    BOOST_CHECK(q == qs[15]);
+  }
+#else
+  BOOST_CHECK_THROW(TrajectoryLogWriter(model,filename,fields,0,10,TrajectoryLogFormat::ZLIB),std::invalid_argument);
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END()
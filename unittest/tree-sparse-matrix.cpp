@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2020 INRIA
+//
+
+#include "pinocchio/algorithm/tree-sparse-matrix.hpp"
+#include "pinocchio/algorithm/crba.hpp"
+#include "pinocchio/algorithm/aba.hpp"
+#include "pinocchio/algorithm/joint-configuration.hpp"
+#include "pinocchio/parsers/sample-models.hpp"
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/utility/binary.hpp>
+
+BOOST_AUTO_TEST_SUITE ( BOOST_TEST_MODULE )
+
+BOOST_AUTO_TEST_CASE(test_tree_sparse_pattern)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+
+  Model model; buildModels::humanoidRandom(model);
+  Data data(model);
+
+  TreeSparseMatrix M(model);
+  BOOST_CHECK(M.rows() == model.nv);
+  BOOST_CHECK(M.cols() == model.nv);
+  BOOST_CHECK(M.nonZeros() < model.nv*(model.nv+1)/2);
+
+  for(int i = 0; i < model.nv; ++i)
+  {
+    BOOST_CHECK(M.rowSize(i) == data.nvSubtree_fromRow[(size_t)i]);
+    BOOST_CHECK(M.parent(i) == data.parents_fromRow[(size_t)i]);
+  }
+
+  // The pattern of M is the one of the upper triangular part computed by crba
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  const VectorXd q = randomConfiguration(model);
+  crba(model,data,q);
+  data.M.triangularView<StrictlyLower>() = data.M.transpose().triangularView<StrictlyLower>();
+
+  M.fromDense(data.M);
+  MatrixXd M_dense(model.nv,model.nv);
+  M.toDense(M_dense);
+  BOOST_CHECK(M_dense.isApprox(data.M));
+
+  for(int i = 0; i < model.nv; ++i)
+    for(int j = 0; j < model.nv; ++j)
+      BOOST_CHECK(M.coeff(i,j) == data.M(i,j));
+}
+
+BOOST_AUTO_TEST_CASE(test_tree_sparse_product_and_solve)
+{
+  using namespace Eigen;
+  using namespace pinocchio;
+
+  Model model; buildModels::humanoidRandom(model);
+  Data data(model);
+
+  model.lowerPositionLimit.head<3>().fill(-1.);
+  model.upperPositionLimit.head<3>().fill(1.);
+  const VectorXd q = randomConfiguration(model);
+
+  crba(model,data,q);
+  data.M.triangularView<StrictlyLower>() = data.M.transpose().triangularView<StrictlyLower>();
+
+  TreeSparseMatrix M(model);
+  M.fromDense(data.M);
+
+  // Products
+  const VectorXd x = VectorXd::Random(model.nv);
+  VectorXd Mx(model.nv);
+  treeSparseProduct(M,x,Mx);
+  BOOST_CHECK(Mx.isApprox(data.M*x));
+
+  const MatrixXd X = MatrixXd::Random(model.nv,12);
+  MatrixXd MX(model.nv,12);
+  treeSparseProduct(M,X,MX);
+  BOOST_CHECK(MX.isApprox(data.M*X));
+
+  // Solves
+  TreeSparseLDLT ldlt;
+  ldlt.compute(M);
+  BOOST_CHECK(ldlt.rows() == model.nv);
+
+  MatrixXd U_dense(model.nv,model.nv);
+  ldlt.matrixU().toDense(U_dense);
+  MatrixXd U = U_dense.triangularView<Upper>();
+  BOOST_CHECK(U.diagonal().isOnes());
+  BOOST_CHECK((U*ldlt.vectorD().asDiagonal()*U.transpose()).isApprox(data.M));
+
+  VectorXd y(Mx);
+  ldlt.solveInPlace(y);
+  BOOST_CHECK(y.isApprox(x));
+
+  MatrixXd Y(MX);
+  ldlt.solveInPlace(Y);
+  BOOST_CHECK(Y.isApprox(X));
+
+  // Products with the inverse
+  computeMinverse(model,data,q);
+  data.Minv.triangularView<StrictlyLower>() = data.Minv.transpose().triangularView<StrictlyLower>();
+
+  MatrixXd MinvX(X);
+  ldlt.solveInPlace(MinvX);
+  BOOST_CHECK(MinvX.isApprox(data.Minv*X));
+}
+
+BOOST_AUTO_TEST_SUITE_END()